@@ -0,0 +1,83 @@
+##*****************************************************************************
+#  SYNOPSIS:
+#    X_AC_ZLIB
+#
+#  DESCRIPTION:
+#    Test if we have libz installed. If found define appropriate ENVs.
+#
+##*****************************************************************************
+
+AC_DEFUN([X_AC_ZLIB],
+#
+# Handle user hints
+#
+[AC_MSG_CHECKING(if zlib is wanted)
+zlib_places="/usr/local /usr /opt/local /sw"
+AC_ARG_WITH([zlib],
+[  --with-zlib=PATH        Specify path to libz installation],
+[AS_IF([test "x$with_zlib" != xno && test "x$with_zlib" != xyes],
+       [zlib_places="$with_zlib"; AC_MSG_RESULT([yes])],
+       [AC_MSG_RESULT([no])])])
+
+#
+# Locate zlib, if installed
+#
+if [test "x$with_zlib" = xno]; then
+  AC_MSG_NOTICE([support for zlib disabled])
+else
+  # check the user supplied or any other more or less 'standard' place:
+  #   Most UNIX systems      : /usr/local and /usr
+  #   MacPorts / Fink on OSX : /opt/local respectively /sw
+  HAVE_ZLIB=0
+  for ZLIB_HOME in ${zlib_places} ; do
+    test -f "${ZLIB_HOME}/include/zlib.h" || continue
+
+    ZLIB_OLD_LDFLAGS=$LDFLAGS
+    ZLIB_OLD_CPPFLAGS=$CPPFLAGS
+    if test -n "${ZLIB_HOME}"; then
+      ZLIB_CPPFLAGS="-I${ZLIB_HOME}/include"
+      ZLIB_LDFLAGS="-L${ZLIB_HOME}/lib"
+      ZLIB_LIBS="-lz"
+
+      LDFLAGS="$LDFLAGS ${ZLIB_LDFLAGS}"
+      CPPFLAGS="$CPPFLAGS ${ZLIB_CPPFLAGS}"
+    fi
+    AC_LANG_SAVE
+    AC_LANG([C])
+    AC_CHECK_LIB([z], [deflate], [ac_cv_zlib=yes], [ac_cv_zlib=no])
+    AC_CHECK_HEADER([zlib.h], [ac_cv_zlib_h=yes], [ac_cv_zlib_h=no])
+    AC_LANG_RESTORE
+
+    # Restore variables
+    LDFLAGS="$ZLIB_OLD_LDFLAGS"
+    CPPFLAGS="$ZLIB_OLD_CPPFLAGS"
+
+    if [ test "$ac_cv_zlib" = "yes" && test "$ac_cv_zlib_h" = "yes" ]; then
+        #
+        # If both library and header were found, action-if-found
+        #
+        AC_SUBST(ZLIB_CPPFLAGS)
+        AC_SUBST(ZLIB_LDFLAGS)
+        AC_SUBST(ZLIB_LIBS)
+        AC_DEFINE([HAVE_ZLIB], [1],
+                  [Define to 1 if you have 'zlib' library (-lz)])
+        AC_MSG_RESULT([ZLIB test program built properly.])
+        HAVE_ZLIB=1
+        break
+    else
+        AC_MSG_RESULT([ZLIB test program build failed.])
+    fi
+  done
+
+  if [test "$HAVE_ZLIB" != 1]; then
+    if [test -z "$with_zlib"]; then
+      AC_MSG_WARN([unable to locate working zlib installation])
+    else
+      AC_MSG_ERROR([unable to locate working zlib installation])
+    fi
+  fi
+
+
+fi
+
+])
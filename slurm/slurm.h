@@ -3614,6 +3614,19 @@ extern int slurm_submit_batch_job(job_desc_msg_t *job_desc_msg,
 extern int slurm_submit_batch_het_job(list_t *job_req_list,
 				      submit_response_msg_t **slurm_alloc_msg);
 
+/*
+ * slurm_submit_batch_jobs - issue RPC to submit many independent batch jobs
+ *			     for later execution
+ * NOTE: free the response using slurm_list_destroy()
+ * IN job_req_list - list of batch job requests, type job_desc_msg_t
+ * OUT resp_list - list of responses, type submit_response_msg_t, in the same
+ *	order as job_req_list. job_id of each response is zero if that job
+ *	was rejected. error_code may also be set for a submitted job, the
+ *	same as for slurm_submit_batch_job().
+ * RET SLURM_SUCCESS on success, otherwise return SLURM_ERROR with errno set
+ */
+extern int slurm_submit_batch_jobs(list_t *job_req_list, list_t **resp_list);
+
 /*
  * slurm_free_submit_response_response_msg - free slurm
  *	job submit response message
@@ -305,6 +305,7 @@ typedef enum {
 	ESLURMD_CPU_BIND_ERROR,
 	ESLURMD_CPU_LAYOUT_ERROR,
 	ESLURMD_TOO_MANY_RPCS,
+	ESLURMD_BCAST_CACHED,
 
 	/* socket specific Slurm communications error */
 	ESLURM_PROTOCOL_INCOMPLETE_PACKET = 5003,
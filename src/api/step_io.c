@@ -81,6 +81,7 @@ static int _read_io_init_msg(int fd, client_io_t *cio, slurm_addr_t *host);
 static int      _wid(int n);
 static bool     _incoming_buf_free(client_io_t *cio);
 static bool     _outgoing_buf_free(client_io_t *cio);
+static bool     _outgoing_batch_free(client_io_t *cio);
 
 /**********************************************************************
  * Listening socket declarations
@@ -116,6 +117,10 @@ struct server_io_info {
 	/* incoming variables */
 	io_hdr_t header;
 	struct io_buf *in_msg;
+	char *in_batch;		/* SLURM_IO_BATCH payload being read */
+	/* free_outgoing buffers reserved for the messages of in_batch */
+	struct io_buf *in_batch_bufs[SLURM_IO_MAX_BATCH_MSGS];
+	int in_batch_nbufs;
 	int32_t in_remaining;
 	bool in_eof;
 	int remote_stdout_objs; /* active eio_obj_t's on the remote node */
@@ -227,6 +232,7 @@ _create_server_eio_obj(int fd, client_io_t *cio, int nodeid,
 	info->testing_connection = false;
 	info->in_msg = NULL;
 	info->in_remaining = 0;
+	info->in_batch_nbufs = 0;
 	info->in_eof = false;
 	info->remote_stdout_objs = stdout_objs;
 	info->remote_stderr_objs = stderr_objs;
@@ -248,7 +254,7 @@ _server_readable(eio_obj_t *obj)
 
 	debug4("Called _server_readable");
 
-	if (!_outgoing_buf_free(s->cio)) {
+	if (!_outgoing_buf_free(s->cio) || !_outgoing_batch_free(s->cio)) {
 		debug4("  false, free_io_buf is empty");
 		return false;
 	}
@@ -281,6 +287,126 @@ _server_readable(eio_obj_t *obj)
 	return false;
 }
 
+/*
+ * Account for the eof of one of the remote stdout or stderr streams
+ */
+static void _server_eof_msg(eio_obj_t *obj, io_hdr_type_t type)
+{
+	struct server_io_info *s = (struct server_io_info *) obj->arg;
+
+	if (type == SLURM_IO_STDOUT) {
+		s->remote_stdout_objs--;
+		debug3( "got eof-stdout msg on _server_read "
+			"header");
+	} else if (type == SLURM_IO_STDERR) {
+		s->remote_stderr_objs--;
+		debug3( "got eof-stderr msg on _server_read "
+			"header");
+	} else
+		error("Unrecognized output message type");
+	/* If all remote eios are gone, shutdown
+	 * the i/o channel with stepd.
+	 */
+	if (s->remote_stdout_objs == 0
+		&& s->remote_stderr_objs == 0) {
+		obj->shutdown = true;
+	}
+}
+
+/*
+ * Route a stdout or stderr message to the proper output
+ */
+static void _server_route_msg(struct server_io_info *s, struct io_buf *msg)
+{
+	eio_obj_t *obj;
+	struct file_write_info *info;
+
+	msg->ref_count = 1;
+	if (msg->header.type == SLURM_IO_STDOUT)
+		obj = s->cio->stdout_obj;
+	else
+		obj = s->cio->stderr_obj;
+	info = (struct file_write_info *) obj->arg;
+	if (info->eof)
+		/* this output is closed, discard message */
+		list_enqueue(s->cio->free_outgoing, msg);
+	else
+		list_enqueue(info->msg_queue, msg);
+}
+
+/*
+ * Reserve the buffers for the messages of a SLURM_IO_BATCH, so that other
+ * servers can't use them while its payload is read.
+ */
+static void _server_reserve_batch(struct server_io_info *s)
+{
+	while ((s->in_batch_nbufs < SLURM_IO_MAX_BATCH_MSGS) &&
+	       _outgoing_buf_free(s->cio))
+		s->in_batch_bufs[s->in_batch_nbufs++] =
+			list_dequeue(s->cio->free_outgoing);
+}
+
+/* Free the SLURM_IO_BATCH payload and its unused buffers */
+static void _server_release_batch(struct server_io_info *s)
+{
+	while (s->in_batch_nbufs > 0)
+		list_enqueue(s->cio->free_outgoing,
+			     s->in_batch_bufs[--s->in_batch_nbufs]);
+	xfree(s->in_batch);
+}
+
+/*
+ * Split a SLURM_IO_BATCH payload back into the stdout and stderr messages
+ * it is made of and route each of them.
+ */
+static void _server_demux_batch(eio_obj_t *obj)
+{
+	struct server_io_info *s = (struct server_io_info *) obj->arg;
+	char *ptr = s->in_batch;
+	uint32_t left = s->header.length;
+	struct io_buf *msg;
+	io_hdr_t header;
+	buf_t *buffer;
+	int rc;
+
+	while (left > 0) {
+		buffer = create_buf(ptr, left);
+		rc = io_hdr_unpack(&header, buffer);
+		buffer->head = NULL;	/* CLANG false positive bug here */
+		FREE_NULL_BUFFER(buffer);
+
+		if (rc || ((header.type != SLURM_IO_STDOUT) &&
+			   (header.type != SLURM_IO_STDERR)) ||
+		    (header.length > SLURM_IO_MAX_MSG_LEN) ||
+		    ((header.length + IO_HDR_PACKET_BYTES) > left)) {
+			error("%s: invalid message in batch from node %d, discarding %u bytes",
+			      __func__, s->node_id, left);
+			return;
+		}
+
+		if (!header.length) {
+			_server_eof_msg(obj, header.type);
+			ptr += IO_HDR_PACKET_BYTES;
+			left -= IO_HDR_PACKET_BYTES;
+			continue;
+		}
+
+		if (!s->in_batch_nbufs) {
+			error("%s: too many messages in batch from node %d, discarding %u bytes",
+			      __func__, s->node_id, left);
+			return;
+		}
+		msg = s->in_batch_bufs[--s->in_batch_nbufs];
+		memcpy(msg->data, ptr + IO_HDR_PACKET_BYTES, header.length);
+		msg->length = header.length;
+		msg->header = header;
+		_server_route_msg(s, msg);
+
+		ptr += IO_HDR_PACKET_BYTES + header.length;
+		left -= IO_HDR_PACKET_BYTES + header.length;
+	}
+}
+
 static int _server_read(eio_obj_t *obj, list_t *objs)
 {
 	struct server_io_info *s = (struct server_io_info *) obj->arg;
@@ -289,6 +415,13 @@ static int _server_read(eio_obj_t *obj, list_t *objs)
 
 	debug4("Entering _server_read");
 	if (s->in_msg == NULL) {
+		/*
+		 * Other servers may have used the buffers _server_readable()
+		 * found free, wait until a whole batch fits again.
+		 */
+		if (!_outgoing_batch_free(s->cio))
+			return SLURM_SUCCESS;
+
 		if (_outgoing_buf_free(s->cio)) {
 			s->in_msg = list_dequeue(s->cio->free_outgoing);
 		} else {
@@ -332,24 +465,27 @@ static int _server_read(eio_obj_t *obj, list_t *objs)
 			s->testing_connection = false;
 			return SLURM_SUCCESS;
 
-		} else if (s->header.length == 0) { /* eof message */
-			if (s->header.type == SLURM_IO_STDOUT) {
-				s->remote_stdout_objs--;
-				debug3( "got eof-stdout msg on _server_read "
-					"header");
-			} else if (s->header.type == SLURM_IO_STDERR) {
-				s->remote_stderr_objs--;
-				debug3( "got eof-stderr msg on _server_read "
-					"header");
-			} else
-				error("Unrecognized output message type");
-			/* If all remote eios are gone, shutdown
-			 * the i/o channel with stepd.
-			 */
-			if (s->remote_stdout_objs == 0
-				&& s->remote_stderr_objs == 0) {
-				obj->shutdown = true;
+		} else if (s->header.type == SLURM_IO_BATCH) {
+			if (!s->header.length ||
+			    (s->header.length > SLURM_IO_MAX_BATCH_LEN)) {
+				error("%s: fd %d invalid batch length %u",
+				      __func__, obj->fd, s->header.length);
+				if (s->cio->sls)
+					step_launch_notify_io_failure(
+						s->cio->sls, s->node_id);
+				if (obj->fd > STDERR_FILENO)
+					close(obj->fd);
+				obj->fd = -1;
+				s->in_eof = true;
+				s->out_eof = true;
+				list_enqueue(s->cio->free_outgoing, s->in_msg);
+				s->in_msg = NULL;
+				return SLURM_SUCCESS;
 			}
+			s->in_batch = xmalloc_nz(s->header.length);
+			_server_reserve_batch(s);
+		} else if (s->header.length == 0) { /* eof message */
+			_server_eof_msg(obj, s->header.type);
 			list_enqueue(s->cio->free_outgoing, s->in_msg);
 			s->in_msg = NULL;
 			return SLURM_SUCCESS;
@@ -363,7 +499,12 @@ static int _server_read(eio_obj_t *obj, list_t *objs)
 	 * Read the body
 	 */
 	if (s->header.length != 0) {
-		buf = s->in_msg->data + (s->in_msg->length - s->in_remaining);
+		if (s->in_batch)
+			buf = s->in_batch + (s->header.length -
+					     s->in_remaining);
+		else
+			buf = s->in_msg->data + (s->in_msg->length -
+						 s->in_remaining);
 	again:
 		if ((n = read(obj->fd, buf, s->in_remaining)) < 0) {
 			if (errno == EINTR)
@@ -397,6 +538,7 @@ static int _server_read(eio_obj_t *obj, list_t *objs)
 			s->out_eof = true;
 			list_enqueue(s->cio->free_outgoing, s->in_msg);
 			s->in_msg = NULL;
+			_server_release_batch(s);
 			return SLURM_SUCCESS;
 		}
 
@@ -411,24 +553,14 @@ static int _server_read(eio_obj_t *obj, list_t *objs)
 	/*
 	 * Route the message to the proper output
 	 */
-	{
-		eio_obj_t *obj;
-		struct file_write_info *info;
-
-		s->in_msg->ref_count = 1;
-		if (s->in_msg->header.type == SLURM_IO_STDOUT)
-			obj = s->cio->stdout_obj;
-		else
-			obj = s->cio->stderr_obj;
-		info = (struct file_write_info *) obj->arg;
-		if (info->eof)
-			/* this output is closed, discard message */
-			list_enqueue(s->cio->free_outgoing, s->in_msg);
-		else
-			list_enqueue(info->msg_queue, s->in_msg);
-
-		s->in_msg = NULL;
+	if (s->in_batch) {
+		_server_demux_batch(obj);
+		_server_release_batch(s);
+		list_enqueue(s->cio->free_outgoing, s->in_msg);
+	} else {
+		_server_route_msg(s, s->in_msg);
 	}
+	s->in_msg = NULL;
 
 	return SLURM_SUCCESS;
 }
@@ -1059,6 +1191,19 @@ _outgoing_buf_free(client_io_t *cio)
 	return false;
 }
 
+/*
+ * Return true if a full SLURM_IO_BATCH can be buffered, its header and
+ * each of its messages
+ */
+static bool
+_outgoing_batch_free(client_io_t *cio)
+{
+	int avail = list_count(cio->free_outgoing);
+
+	avail += STDIO_MAX_FREE_BUF - cio->outgoing_count;
+	return (avail > SLURM_IO_MAX_BATCH_MSGS);
+}
+
 static inline int
 _estimate_nports(int nclients, int cli_per_port)
 {
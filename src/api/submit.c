@@ -101,6 +101,119 @@ extern int slurm_submit_batch_job(job_desc_msg_t *req,
 	return SLURM_SUCCESS;
 }
 
+/* Max jobs sent in a single REQUEST_SUBMIT_BATCH_JOBS */
+#define SUBMIT_BATCH_JOBS_MAX 10000
+
+/* Submit each job individually when controller can not accept batches */
+static void _submit_batch_jobs_single(list_t *job_req_list,
+				      list_t *resp_list)
+{
+	list_itr_t *iter = list_iterator_create(job_req_list);
+	job_desc_msg_t *req;
+
+	while ((req = list_next(iter))) {
+		submit_response_msg_t *resp = NULL;
+
+		if (slurm_submit_batch_job(req, &resp)) {
+			resp = xmalloc(sizeof(*resp));
+			resp->step_id = SLURM_BATCH_SCRIPT;
+			resp->error_code = errno;
+		}
+
+		list_append(resp_list, resp);
+	}
+	list_iterator_destroy(iter);
+}
+
+static int _submit_batch_jobs(list_t *job_req_list, list_t *resp_list)
+{
+	int rc;
+	slurm_msg_t req_msg;
+	slurm_msg_t resp_msg;
+
+	slurm_msg_t_init(&req_msg);
+	slurm_msg_t_init(&resp_msg);
+
+	req_msg.msg_type = REQUEST_SUBMIT_BATCH_JOBS;
+	req_msg.data     = job_req_list;
+
+	rc = slurm_send_recv_controller_msg(&req_msg, &resp_msg,
+					    working_cluster_rec);
+	if (rc == SLURM_ERROR)
+		return SLURM_ERROR;
+	switch (resp_msg.msg_type) {
+	case RESPONSE_SLURM_RC:
+		rc = ((return_code_msg_t *) resp_msg.data)->return_code;
+		slurm_free_return_code_msg(resp_msg.data);
+		if (rc == ESLURM_NOT_SUPPORTED) {
+			_submit_batch_jobs_single(job_req_list, resp_list);
+			return SLURM_SUCCESS;
+		}
+		if (rc)
+			slurm_seterrno_ret(rc);
+		break;
+	case RESPONSE_SUBMIT_BATCH_JOBS:
+		list_transfer(resp_list, resp_msg.data);
+		FREE_NULL_LIST(resp_msg.data);
+		break;
+	default:
+		slurm_seterrno_ret(SLURM_UNEXPECTED_MSG_ERROR);
+	}
+
+	return SLURM_SUCCESS;
+}
+
+/*
+ * slurm_submit_batch_jobs - issue RPC to submit many independent batch jobs
+ *			     for later execution
+ * NOTE: free the response using slurm_list_destroy()
+ * IN job_req_list - list of batch job requests, type job_desc_msg_t
+ * OUT resp_list - list of responses, type submit_response_msg_t
+ * RET SLURM_SUCCESS on success, otherwise return SLURM_ERROR with errno set
+ */
+extern int slurm_submit_batch_jobs(list_t *job_req_list, list_t **resp_list)
+{
+	list_t *batch = list_create(NULL);
+	list_itr_t *iter;
+	job_desc_msg_t *req;
+	int rc = SLURM_SUCCESS;
+
+	*resp_list = list_create(
+		(ListDelF) slurm_free_submit_response_response_msg);
+
+	iter = list_iterator_create(job_req_list);
+	while ((req = list_next(iter))) {
+		/*
+		 * set session id for this request
+		 */
+		if (req->alloc_sid == NO_VAL)
+			req->alloc_sid = getsid(0);
+
+		list_append(batch, req);
+
+		if (list_count(batch) >= SUBMIT_BATCH_JOBS_MAX) {
+			if ((rc = _submit_batch_jobs(batch, *resp_list)))
+				break;
+			list_flush(batch);
+		}
+	}
+	list_iterator_destroy(iter);
+
+	if (!rc && !list_is_empty(batch))
+		rc = _submit_batch_jobs(batch, *resp_list);
+
+	FREE_NULL_LIST(batch);
+
+	if (rc) {
+		int err = errno;
+
+		FREE_NULL_LIST(*resp_list);
+		slurm_seterrno_ret(err);
+	}
+
+	return SLURM_SUCCESS;
+}
+
 /*
  * slurm_submit_batch_het_job - issue RPC to submit a heterogeneous job for
  *				later execution
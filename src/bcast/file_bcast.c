@@ -54,6 +54,10 @@
 # include <lz4.h>
 #endif
 
+#if HAVE_ZSTD
+# include <zstd.h>
+#endif
+
 #include "slurm/slurm_errno.h"
 #include "src/common/forward.h"
 #include "src/common/hostlist.h"
@@ -71,6 +75,8 @@
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
+#include "src/interfaces/hash.h"
+
 #include "file_bcast.h"
 
 /*
@@ -81,6 +87,9 @@
 #define DEFAULT_THREADS 8
 #define MAX_THREADS     64	/* These can be huge messages, so
 				 * only run MAX_THREADS at one time */
+#define MAX_WINDOW      16	/* Max blocks in flight, each one is queued
+				 * and sent so twice this many are in memory */
+#define HASH_CHUNK_SIZE (1024 * 1024 * 1024)	/* hash_g_compute() max */
 
 int block_len;				/* block size */
 int fd;					/* source file descriptor */
@@ -88,6 +97,47 @@ void *src;				/* source mmap'd address */
 struct stat f_stat;			/* source file stats */
 job_sbcast_cred_msg_t *sbcast_cred;	/* job alloc info and sbcast cred */
 
+/* Compression statistics, blocks may be compressed by the sender threads */
+static pthread_mutex_t stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t size_compressed = 0;
+static uint32_t time_compression = 0;
+
+/*
+ * Nodes still receiving the current file. Nodes that copied the file from
+ * their broadcast cache are removed from it after the first block.
+ */
+static char *bcast_node_list = NULL;
+static hostlist_t *cached_hl = NULL;
+static pthread_mutex_t cached_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Node lists of the chains each block is sent down when params->chains is
+ * set. Every node forwards the block to the next node of its chain only.
+ */
+static char **chain_node_lists = NULL;
+static int chain_cnt = 0;
+
+typedef struct {
+	struct bcast_parameters *params;
+	file_bcast_msg_t *bcast_msg;
+	char *node_list;
+	int rc;
+	pthread_t tid;
+} bcast_chain_t;
+
+/* Blocks queued to be sent concurrently by the sender threads */
+typedef struct {
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	list_t *blocks;		/* file_bcast_msg_t to send */
+	int in_flight;		/* blocks being sent */
+	bool done;		/* no more blocks will be queued */
+	int rc;			/* first error from any sender */
+	struct bcast_parameters *params;
+	pthread_t *threads;
+	int thread_cnt;
+} bcast_pipeline_t;
+
 static int   _bcast_file(struct bcast_parameters *params);
 static int   _file_bcast(struct bcast_parameters *params,
 			 file_bcast_msg_t *bcast_msg,
@@ -130,6 +180,8 @@ static int _file_state(struct bcast_parameters *params)
 		error("Can't mmap file `%s`, %m.", params->src_fname);
 		return SLURM_ERROR;
 	}
+	/* Blocks are read in order, let the kernel read ahead of us */
+	(void) madvise(src, f_stat.st_size, MADV_SEQUENTIAL);
 
 	return SLURM_SUCCESS;
 }
@@ -163,10 +215,52 @@ static int _get_job_info(struct bcast_parameters *params)
 	return rc;
 }
 
-/* Issue the RPC to transfer the file's data */
-static int _file_bcast(struct bcast_parameters *params,
-		       file_bcast_msg_t *bcast_msg,
-		       job_sbcast_cred_msg_t *sbcast_cred)
+/* Split the job's nodes into params->chains chains of consecutive nodes */
+static void _build_chains(struct bcast_parameters *params)
+{
+	hostlist_t *hl;
+	int node_cnt;
+
+	if (params->chains <= 0)
+		return;
+
+	hl = hostlist_create(bcast_node_list);
+	node_cnt = hostlist_count(hl);
+	chain_cnt = MIN(params->chains, node_cnt);
+	chain_node_lists = xcalloc(chain_cnt, sizeof(*chain_node_lists));
+
+	for (int i = 0; i < chain_cnt; i++) {
+		hostlist_t *chain_hl = hostlist_create(NULL);
+		int len = ((node_cnt * (i + 1)) / chain_cnt) -
+			  ((node_cnt * i) / chain_cnt);
+
+		for (int j = 0; j < len; j++) {
+			char *host = hostlist_shift(hl);
+
+			hostlist_push_host(chain_hl, host);
+			free(host);
+		}
+
+		chain_node_lists[i] = hostlist_ranged_string_xmalloc(chain_hl);
+		verbose("chain %d    = %s", i, chain_node_lists[i]);
+		hostlist_destroy(chain_hl);
+	}
+
+	hostlist_destroy(hl);
+}
+
+static void _free_chains(void)
+{
+	for (int i = 0; i < chain_cnt; i++)
+		xfree(chain_node_lists[i]);
+	xfree(chain_node_lists);
+	chain_cnt = 0;
+}
+
+/* Issue the RPC to transfer the file's data to node_list */
+static int _file_bcast_nodes(struct bcast_parameters *params,
+			     file_bcast_msg_t *bcast_msg,
+			     const char *node_list, int tree_width)
 {
 	list_t *ret_list = NULL;
 	list_itr_t *itr;
@@ -178,11 +272,10 @@ static int _file_bcast(struct bcast_parameters *params,
 	slurm_msg_set_r_uid(&msg, SLURM_AUTH_UID_ANY);
 	msg.data = bcast_msg;
 	msg.flags = USE_BCAST_NETWORK;
-	msg.forward.tree_width = params->tree_width;
+	msg.forward.tree_width = tree_width;
 	msg.msg_type = REQUEST_FILE_BCAST;
 
-	ret_list = slurm_send_recv_msgs(sbcast_cred->node_list, &msg,
-					params->timeout);
+	ret_list = slurm_send_recv_msgs(node_list, &msg, params->timeout);
 	if (ret_list == NULL) {
 		error("slurm_send_recv_msgs: %m");
 		exit(1);
@@ -194,6 +287,13 @@ static int _file_bcast(struct bcast_parameters *params,
 					       ret_data_info->data);
 		if (msg_rc == SLURM_SUCCESS)
 			continue;
+		if (msg_rc == ESLURMD_BCAST_CACHED) {
+			slurm_mutex_lock(&cached_mutex);
+			hostlist_push_host(cached_hl,
+					   ret_data_info->node_name);
+			slurm_mutex_unlock(&cached_mutex);
+			continue;
+		}
 
 		error("REQUEST_FILE_BCAST(%s): %s",
 		      ret_data_info->node_name,
@@ -206,6 +306,49 @@ static int _file_bcast(struct bcast_parameters *params,
 	return rc;
 }
 
+static void *_file_bcast_chain(void *arg)
+{
+	bcast_chain_t *chain = arg;
+
+	chain->rc = _file_bcast_nodes(chain->params, chain->bcast_msg,
+				      chain->node_list, 1);
+
+	return NULL;
+}
+
+/* Issue the RPCs to transfer the file's data to every node */
+static int _file_bcast(struct bcast_parameters *params,
+		       file_bcast_msg_t *bcast_msg,
+		       job_sbcast_cred_msg_t *sbcast_cred)
+{
+	bcast_chain_t *chains;
+	int rc = SLURM_SUCCESS;
+
+	if (!chain_cnt)
+		return _file_bcast_nodes(params, bcast_msg, bcast_node_list,
+					 params->tree_width);
+	if (chain_cnt == 1)
+		return _file_bcast_nodes(params, bcast_msg,
+					 chain_node_lists[0], 1);
+
+	chains = xcalloc(chain_cnt, sizeof(*chains));
+	for (int i = 0; i < chain_cnt; i++) {
+		chains[i].params = params;
+		chains[i].bcast_msg = bcast_msg;
+		chains[i].node_list = chain_node_lists[i];
+		slurm_thread_create(&chains[i].tid, _file_bcast_chain,
+				    &chains[i]);
+	}
+	for (int i = 0; i < chain_cnt; i++) {
+		slurm_thread_join(chains[i].tid);
+		if (chains[i].rc)
+			rc = chains[i].rc;
+	}
+	xfree(chains);
+
+	return rc;
+}
+
 /* load a buffer with data from the file to broadcast,
  * return number of bytes read, zero on end of file */
 static int _get_block_none(char **buffer, int *orig_len, bool *more,
@@ -221,10 +364,11 @@ static int _get_block_none(char **buffer, int *orig_len, bool *more,
 	}
 
 	if (remaining < 0) {
-		*buffer = xmalloc(block_len);
 		remaining = f_stat.st_size;
 		position = src;
 	}
+	if (!*buffer)
+		*buffer = xmalloc(block_len);
 
 	size = MIN(block_len, remaining);
 	memcpy(*buffer, position, size);
@@ -260,8 +404,9 @@ static int _get_block_lz4(struct bcast_parameters *params,
 	if (remaining < 0) {
 		position = src;
 		remaining = f_stat.st_size;
-		*buffer = xmalloc(block_len);
 	}
+	if (!*buffer)
+		*buffer = xmalloc(block_len);
 
 	/* intentionally limit decompressed size to 10x compressed
 	 * to avoid problems on receive size when decompressed */
@@ -296,6 +441,13 @@ static int _next_block(struct bcast_parameters *params,
 	case COMPRESS_LZ4:
 		return _get_block_lz4(params, buffer, orig_len, more,
 				      file_start);
+	case COMPRESS_ZSTD:
+#if !HAVE_ZSTD
+		info("zstd compression not supported, sending uncompressed file.");
+		params->compress = 0;
+#endif
+		/* compressed by _compress_block() when sent */
+		return _get_block_none(buffer, orig_len, more, file_start);
 	}
 
 	/* compression type not recognized */
@@ -305,6 +457,249 @@ static int _next_block(struct bcast_parameters *params,
 	return _get_block_none(buffer, orig_len, more, file_start);
 }
 
+static void _add_compress_stats(uint64_t size, uint32_t usec)
+{
+	slurm_mutex_lock(&stats_mutex);
+	size_compressed += size;
+	time_compression += usec;
+	slurm_mutex_unlock(&stats_mutex);
+}
+
+/*
+ * Compress a block read by _get_block_none() into a zstd frame. This is done
+ * just before sending it so that the sender threads compress concurrently.
+ */
+static int _compress_block(struct bcast_parameters *params,
+			   file_bcast_msg_t *bcast_msg)
+{
+#if HAVE_ZSTD
+	size_t bound, size_out;
+	char *out_buf;
+	DEF_TIMERS;
+
+	if ((bcast_msg->compress != COMPRESS_ZSTD) || !bcast_msg->block_len)
+		return SLURM_SUCCESS;
+
+	START_TIMER;
+	bound = ZSTD_compressBound(bcast_msg->block_len);
+	out_buf = xmalloc(bound);
+	size_out = ZSTD_compress(out_buf, bound, bcast_msg->block,
+				 bcast_msg->block_len,
+				 (params->compress_level ? params->compress_level :
+				  ZSTD_CLEVEL_DEFAULT));
+	if (ZSTD_isError(size_out)) {
+		error("zstd compression error: %s",
+		      ZSTD_getErrorName(size_out));
+		xfree(out_buf);
+		return SLURM_ERROR;
+	}
+	xfree(bcast_msg->block);
+	bcast_msg->block = out_buf;
+	bcast_msg->block_len = size_out;
+	END_TIMER;
+
+	_add_compress_stats(size_out, DELTA_TIMER);
+#endif
+	return SLURM_SUCCESS;
+}
+
+static void _free_block(void *x)
+{
+	file_bcast_msg_t *block = x;
+
+	xfree(block->block);
+	xfree(block);
+}
+
+static void *_pipeline_sender(void *arg)
+{
+	bcast_pipeline_t *pipeline = arg;
+	file_bcast_msg_t *block;
+	int rc;
+
+	slurm_mutex_lock(&pipeline->mutex);
+	while (true) {
+		if (!(block = list_dequeue(pipeline->blocks))) {
+			if (pipeline->done)
+				break;
+			slurm_cond_wait(&pipeline->cond, &pipeline->mutex);
+			continue;
+		}
+
+		/* Let the reader queue the next block */
+		slurm_cond_broadcast(&pipeline->cond);
+
+		if (pipeline->rc) {
+			_free_block(block);
+			continue;
+		}
+
+		pipeline->in_flight++;
+		slurm_mutex_unlock(&pipeline->mutex);
+
+		if (!(rc = _compress_block(pipeline->params, block)))
+			rc = _file_bcast(pipeline->params, block, sbcast_cred);
+		_free_block(block);
+
+		slurm_mutex_lock(&pipeline->mutex);
+		pipeline->in_flight--;
+		if (rc && !pipeline->rc)
+			pipeline->rc = rc;
+		slurm_cond_broadcast(&pipeline->cond);
+	}
+	slurm_mutex_unlock(&pipeline->mutex);
+
+	return NULL;
+}
+
+static bcast_pipeline_t *_pipeline_create(struct bcast_parameters *params)
+{
+	bcast_pipeline_t *pipeline = xmalloc(sizeof(*pipeline));
+
+	slurm_mutex_init(&pipeline->mutex);
+	slurm_cond_init(&pipeline->cond, NULL);
+	pipeline->blocks = list_create(_free_block);
+	pipeline->params = params;
+	pipeline->thread_cnt = params->window;
+	pipeline->threads = xcalloc(pipeline->thread_cnt,
+				    sizeof(*pipeline->threads));
+
+	for (int i = 0; i < pipeline->thread_cnt; i++)
+		slurm_thread_create(&pipeline->threads[i], _pipeline_sender,
+				    pipeline);
+
+	return pipeline;
+}
+
+/* Wait for the senders to finish, returns first error of any block */
+static int _pipeline_destroy(bcast_pipeline_t *pipeline)
+{
+	int rc;
+
+	slurm_mutex_lock(&pipeline->mutex);
+	pipeline->done = true;
+	slurm_cond_broadcast(&pipeline->cond);
+	slurm_mutex_unlock(&pipeline->mutex);
+
+	for (int i = 0; i < pipeline->thread_cnt; i++)
+		slurm_thread_join(pipeline->threads[i]);
+
+	rc = pipeline->rc;
+	FREE_NULL_LIST(pipeline->blocks);
+	slurm_mutex_destroy(&pipeline->mutex);
+	slurm_cond_destroy(&pipeline->cond);
+	xfree(pipeline->threads);
+	xfree(pipeline);
+
+	return rc;
+}
+
+/* Wait until every queued block was sent, returns first error of any block */
+static int _pipeline_drain(bcast_pipeline_t *pipeline)
+{
+	int rc;
+
+	slurm_mutex_lock(&pipeline->mutex);
+	while (!pipeline->rc &&
+	       (pipeline->in_flight || !list_is_empty(pipeline->blocks)))
+		slurm_cond_wait(&pipeline->cond, &pipeline->mutex);
+	rc = pipeline->rc;
+	slurm_mutex_unlock(&pipeline->mutex);
+
+	return rc;
+}
+
+/*
+ * Queue a copy of bcast_msg to be sent by the sender threads, taking
+ * ownership of its block. Waits while window blocks are already queued.
+ */
+static int _pipeline_queue(bcast_pipeline_t *pipeline,
+			   file_bcast_msg_t *bcast_msg)
+{
+	file_bcast_msg_t *block = xmalloc(sizeof(*block));
+	int rc;
+
+	*block = *bcast_msg;
+	bcast_msg->block = NULL;
+
+	slurm_mutex_lock(&pipeline->mutex);
+	while (!pipeline->rc &&
+	       (list_count(pipeline->blocks) >= pipeline->thread_cnt))
+		slurm_cond_wait(&pipeline->cond, &pipeline->mutex);
+	if (!(rc = pipeline->rc)) {
+		list_enqueue(pipeline->blocks, block);
+		slurm_cond_broadcast(&pipeline->cond);
+		block = NULL;
+	}
+	slurm_mutex_unlock(&pipeline->mutex);
+
+	if (block)
+		_free_block(block);
+
+	return rc;
+}
+
+/*
+ * Send one block. The first block registers the file on the nodes and the
+ * last block closes it, so those are only sent once every block before them
+ * was written. Blocks in between are sent concurrently when a window of more
+ * than one block is configured, and written at their offset by slurmd.
+ */
+static int _send_block(struct bcast_parameters *params,
+		       bcast_pipeline_t **pipeline,
+		       file_bcast_msg_t *bcast_msg)
+{
+	int rc;
+
+	if ((params->window > 1) && (bcast_msg->block_no > 1) &&
+	    !(bcast_msg->flags & FILE_BCAST_LAST_BLOCK)) {
+		if (!*pipeline)
+			*pipeline = _pipeline_create(params);
+		return _pipeline_queue(*pipeline, bcast_msg);
+	}
+
+	if (*pipeline && (rc = _pipeline_drain(*pipeline)))
+		return rc;
+
+	if ((rc = _compress_block(params, bcast_msg)))
+		return rc;
+
+	return _file_bcast(params, bcast_msg, sbcast_cred);
+}
+
+/*
+ * Stop sending the file to nodes that copied it from their broadcast cache.
+ * RET true if no node still needs the file.
+ */
+static bool _remove_cached_nodes(struct bcast_parameters *params)
+{
+	hostlist_t *hl;
+	char *host;
+	bool all_cached;
+
+	if (!hostlist_count(cached_hl))
+		return false;
+
+	hl = hostlist_create(bcast_node_list);
+	while ((host = hostlist_shift(cached_hl))) {
+		hostlist_delete_host(hl, host);
+		free(host);
+	}
+	xfree(bcast_node_list);
+
+	if ((all_cached = !hostlist_count(hl))) {
+		verbose("File found in broadcast cache of every node");
+	} else {
+		bcast_node_list = hostlist_ranged_string_xmalloc(hl);
+		verbose("File not cached, sending to %s", bcast_node_list);
+		_free_chains();
+		_build_chains(params);
+	}
+	hostlist_destroy(hl);
+
+	return all_cached;
+}
+
 /* read and broadcast the file */
 static int _bcast_file(struct bcast_parameters *params)
 {
@@ -312,9 +707,9 @@ static int _bcast_file(struct bcast_parameters *params)
 	file_bcast_msg_t bcast_msg;
 	char *buffer = NULL;
 	int32_t orig_len = 0;
-	uint64_t size_uncompressed = 0, size_compressed = 0;
-	uint32_t time_compression = 0;
+	uint64_t size_uncompressed = 0;
 	bool more = true, file_start = true;
+	bcast_pipeline_t *pipeline = NULL;
 	DEF_TIMERS;
 
 	if (params->block_size)
@@ -349,15 +744,27 @@ static int _bcast_file(struct bcast_parameters *params)
 	else if (params->tree_width != 0xfffd)
 		params->tree_width = MIN(MAX_THREADS, params->tree_width);
 
+	params->window = MIN(MAX_WINDOW, params->window);
+
+	size_compressed = 0;
+	time_compression = 0;
+
+	bcast_node_list = xstrdup(sbcast_cred->node_list);
+	_build_chains(params);
+	if ((params->flags & BCAST_FLAG_CACHE) && f_stat.st_size) {
+		bcast_msg.file_hash = bcast_hash_data(src, f_stat.st_size);
+		cached_hl = hostlist_create(NULL);
+	}
+
 	while (more) {
 		START_TIMER;
 		bcast_msg.block_len = _next_block(params, &buffer, &orig_len,
 						  &more, file_start);
 		END_TIMER;
 		file_start = false;
-		time_compression += DELTA_TIMER;
 		size_uncompressed += orig_len;
-		size_compressed += bcast_msg.block_len;
+		if (params->compress != COMPRESS_ZSTD)
+			_add_compress_stats(bcast_msg.block_len, DELTA_TIMER);
 		debug("block %u, size %u", bcast_msg.block_no,
 		      bcast_msg.block_len);
 		bcast_msg.compress = params->compress;
@@ -366,16 +773,34 @@ static int _bcast_file(struct bcast_parameters *params)
 		if (!more)
 			bcast_msg.flags |= FILE_BCAST_LAST_BLOCK;
 
-		rc = _file_bcast(params, &bcast_msg, sbcast_cred);
+		rc = _send_block(params, &pipeline, &bcast_msg);
+		/* block is now owned by the pipeline when queued */
+		buffer = bcast_msg.block;
 		if (rc != SLURM_SUCCESS)
 			break;
 		if (bcast_msg.flags & FILE_BCAST_LAST_BLOCK)
 			break;	/* end of file */
+		if ((bcast_msg.block_no == 1) && bcast_msg.file_hash) {
+			/* only the first block carries the hash */
+			xfree(bcast_msg.file_hash);
+			if (_remove_cached_nodes(params))
+				break;
+		}
 		bcast_msg.block_no++;
 		bcast_msg.block_offset += orig_len;
 	}
+	if (pipeline) {
+		int pipeline_rc = _pipeline_destroy(pipeline);
+
+		if (!rc)
+			rc = pipeline_rc;
+	}
+	xfree(bcast_msg.file_hash);
 	xfree(bcast_msg.user_name);
 	xfree(buffer);
+	FREE_NULL_HOSTLIST(cached_hl);
+	_free_chains();
+	xfree(bcast_node_list);
 
 	if (size_uncompressed && (params->compress != 0)) {
 		int64_t pct = (int64_t) size_uncompressed - size_compressed;
@@ -419,6 +844,38 @@ static int _decompress_data_lz4(file_bcast_msg_t *req)
 #endif
 }
 
+static int _decompress_data_zstd(file_bcast_msg_t *req)
+{
+#if HAVE_ZSTD
+	char *out_buf;
+	size_t out_len;
+
+	if (!req->block_len)
+		return 0;
+
+	/* each block is a single frame, don't trust uncomp_len alone */
+	if (ZSTD_getFrameContentSize(req->block, req->block_len) !=
+	    req->uncomp_len) {
+		error("zstd decompression error, original block length != frame content size");
+		return -1;
+	}
+
+	out_buf = xmalloc(req->uncomp_len);
+	out_len = ZSTD_decompress(out_buf, req->uncomp_len, req->block,
+				  req->block_len);
+	xfree(req->block);
+	req->block = out_buf;
+	if (ZSTD_isError(out_len) || (req->uncomp_len != out_len)) {
+		error("zstd decompression error, original block length != decompressed length");
+		return -1;
+	}
+	req->block_len = out_len;
+	return 0;
+#else
+	return -1;
+#endif
+}
+
 /*
  * IN: char pointer with the filename.
  * OUT: List of shared object direct and indirect dependencies.
@@ -646,8 +1103,10 @@ extern int bcast_file(struct bcast_parameters *params)
 	}
 
 	/* Now send files */
-	if ((rc = _bcast_file(params)) != SLURM_SUCCESS)
+	if ((rc = _bcast_file(params)) != SLURM_SUCCESS) {
+		FREE_NULL_LIST(lib_paths);
 		return rc;
+	}
 
 	/* Send libraries, if required */
 	if (lib_paths) {
@@ -659,6 +1118,47 @@ extern int bcast_file(struct bcast_parameters *params)
 	return rc;
 }
 
+extern char *bcast_hash_data(char *data, uint64_t size)
+{
+	slurm_hash_t hash = { .type = HASH_PLUGIN_K12 };
+	slurm_hash_t *chunks = NULL;
+	uint64_t chunk_cnt;
+	char *hex = NULL, *pos = NULL;
+	int rc;
+
+	/* hash the size along with the data, chunked or not */
+	if (size <= HASH_CHUNK_SIZE) {
+		rc = hash_g_compute(data, size, (char *) &size, sizeof(size),
+				    &hash);
+	} else {
+		chunk_cnt = (size + HASH_CHUNK_SIZE - 1) / HASH_CHUNK_SIZE;
+		chunks = xcalloc(chunk_cnt, sizeof(*chunks));
+		for (uint64_t i = 0; i < chunk_cnt; i++) {
+			uint64_t offset = i * HASH_CHUNK_SIZE;
+
+			chunks[i].type = HASH_PLUGIN_K12;
+			if (hash_g_compute(data + offset,
+					   MIN(HASH_CHUNK_SIZE, size - offset),
+					   NULL, 0, &chunks[i]) < 0) {
+				xfree(chunks);
+				return NULL;
+			}
+		}
+		rc = hash_g_compute((char *) chunks,
+				    (chunk_cnt * sizeof(*chunks)),
+				    (char *) &size, sizeof(size), &hash);
+		xfree(chunks);
+	}
+
+	if (rc < 0)
+		return NULL;
+
+	for (int i = 0; i < rc; i++)
+		xstrfmtcatat(hex, &pos, "%02x", hash.hash[i]);
+
+	return hex;
+}
+
 extern int bcast_decompress_data(file_bcast_msg_t *req)
 {
 	switch (req->compress) {
@@ -666,6 +1166,8 @@ extern int bcast_decompress_data(file_bcast_msg_t *req)
 		return 0;
 	case COMPRESS_LZ4:
 		return _decompress_data_lz4(req);
+	case COMPRESS_ZSTD:
+		return _decompress_data_zstd(req);
 	}
 
 	/* compression type not recognized */
@@ -44,10 +44,15 @@
 #define BCAST_FLAG_PRESERVE	 0x0002
 #define BCAST_FLAG_SEND_LIBS	 0x0004
 #define BCAST_FLAG_SHARED_OBJECT 0x0008
+#define BCAST_FLAG_CACHE	 0x0010
+
+#define BCAST_HASH_HEX_LEN	 64	/* bcast_hash_data() string length */
 
 struct bcast_parameters {
 	uint32_t block_size;
+	int chains;		/* chains of nodes to forward blocks through */
 	uint16_t compress;
+	int compress_level;	/* zstd compression level, 0 for default */
 	char *exclude;
 	char *dst_fname;
 	char *exe_fname;
@@ -58,12 +63,14 @@ struct bcast_parameters {
 	int timeout;
 	int tree_width;
 	int verbose;
+	int window;		/* max blocks sent concurrently */
 };
 
 typedef struct file_bcast_info {
 	void *data;		/* mmap of file data */
 	int fd;			/* file descriptor */
 	uint64_t file_size;	/* file size */
+	char *file_hash;	/* content hash to add file to cache with */
 	char *fname;		/* filename */
 	gid_t gid;		/* gid of owner */
 	uint32_t job_id;	/* job id */
@@ -86,4 +93,10 @@ extern int bcast_file(struct bcast_parameters *params);
 
 extern int bcast_decompress_data(file_bcast_msg_t *req);
 
+/*
+ * Hash a file's content to look it up in the nodes' broadcast cache.
+ * RET hex string of the hash, must be xfree'd, or NULL on error.
+ */
+extern char *bcast_hash_data(char *data, uint64_t size);
+
 #endif
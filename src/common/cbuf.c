@@ -1083,7 +1083,8 @@ static int cbuf_find_unread_line(cbuf_t *cb, int chars, int *nlines)
  *  Sets the value-result parameter [nlines] to the number of lines found.
  */
     int i, n, m, l;
-    int lines;
+    int lines, left, seg;
+    unsigned char *p, *q, *end;
 
     assert(cb != NULL);
     assert(nlines != NULL);
@@ -1100,26 +1101,30 @@ static int cbuf_find_unread_line(cbuf_t *cb, int chars, int *nlines)
     if (cb->used == 0) {
         return(0);                      /* no unread data available */
     }
-    if (lines > 0) {
-        chars = -1;                     /* chars parm not used if lines > 0 */
+    left = cb->used;
+    if ((lines <= -1) && (chars < left)) {
+        left = chars;                   /* chars parm not used if lines > 0 */
     }
+    /*  Search each contiguous segment of the unread region with memchr()
+     *    rather than testing one character at a time.
+     */
     i = cb->i_out;
-    while (i != cb->i_in) {
-        ++n;
-        if (chars > 0) {
-            --chars;
-        }
-        if (cb->data[i] == '\n') {
-            if (lines > 0) {
-                --lines;
-            }
-            m = n;
+    while (left > 0) {
+        seg = MIN(left, (cb->size + 1) - i);
+        p = &cb->data[i];
+        end = p + seg;
+        while ((p < end) && (q = memchr(p, '\n', end - p))) {
+            m = n + (q - &cb->data[i]) + 1;
             ++l;
+            if ((lines > 0) && (--lines == 0)) {
+                *nlines = l;
+                return(m);
+            }
+            p = q + 1;
         }
-        if ((chars == 0) || (lines == 0)) {
-            break;
-        }
-        i = (i + 1) % (cb->size + 1);
+        n += seg;
+        left -= seg;
+        i = (i + seg) % (cb->size + 1);
     }
     if (lines > 0) {
         return(0);                      /* all or none, and not enough found */
@@ -50,6 +50,8 @@
 #define DATA_MAGIC 0x1992189F
 #define DATA_LIST_MAGIC 0x1992F89F
 #define DATA_LIST_NODE_MAGIC 0x1921F89F
+/* Dictionaries with at least this many entries get a hash index of keys */
+#define DATA_DICT_INDEX_MIN 16
 
 typedef struct data_list_s data_list_t;
 typedef struct data_list_node_s data_list_node_t;
@@ -92,7 +94,8 @@ typedef struct data_list_node_s {
 	data_list_node_t *next;
 
 	data_t *data;
-	char *key; /* key for dictionary (only) */
+	char *key; /* key for dictionary (only) - stored after node */
+	uint32_t hash; /* hash of key */
 } data_list_node_t;
 
 /* Single linked list for list_u and dict_u */
@@ -102,6 +105,13 @@ typedef struct data_list_s {
 
 	data_list_node_t *begin;
 	data_list_node_t *end;
+
+	/*
+	 * Open addressing (linear probing) index of dictionary nodes by key.
+	 * Only created once dictionary has DATA_DICT_INDEX_MIN entries.
+	 */
+	data_list_node_t **index;
+	size_t index_size; /* always power of 2 */
 } data_list_t;
 
 /*
@@ -212,6 +222,118 @@ static void _check_data_list_node_parent(const data_list_t *dl,
 #endif /* !NDEBUG */
 }
 
+/* FNV-1a hash of key */
+static uint32_t _hash_key(const char *key)
+{
+	uint32_t hash = 2166136261U;
+
+	for (; *key; key++) {
+		hash ^= (unsigned char) *key;
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+static void _index_add_node(data_list_t *dl, data_list_node_t *dn)
+{
+	const size_t mask = dl->index_size - 1;
+	size_t i = dn->hash & mask;
+
+	while (dl->index[i])
+		i = (i + 1) & mask;
+
+	dl->index[i] = dn;
+}
+
+/* (Re)build index of dictionary keys sized for at least count entries */
+static void _index_rebuild(data_list_t *dl, size_t count)
+{
+	size_t size = DATA_DICT_INDEX_MIN * 2;
+
+	/* keep load factor under 1/2 */
+	while (size < (count * 2))
+		size *= 2;
+
+	xfree(dl->index);
+	dl->index = xcalloc(size, sizeof(*dl->index));
+	dl->index_size = size;
+
+	for (data_list_node_t *i = dl->begin; i; i = i->next)
+		_index_add_node(dl, i);
+
+	log_flag(DATA, "%s: indexed data-list(0x%"PRIxPTR")[%zu] with %zu slots",
+		 __func__, (uintptr_t) dl, dl->count, size);
+}
+
+/* Add newly linked dictionary node to index (if needed) */
+static void _index_add(data_list_t *dl, data_list_node_t *dn)
+{
+	if (!dn->key)
+		return;
+
+	if (dl->index && ((dl->count * 2) <= dl->index_size))
+		_index_add_node(dl, dn);
+	else if (dl->count >= DATA_DICT_INDEX_MIN)
+		_index_rebuild(dl, (dl->count * 2));
+}
+
+/* Remove dictionary node from index by shifting back any later collisions */
+static void _index_remove(data_list_t *dl, data_list_node_t *dn)
+{
+	const size_t mask = dl->index_size - 1;
+	size_t i = dn->hash & mask;
+
+	while (dl->index[i] != dn) {
+		xassert(dl->index[i]);
+		i = (i + 1) & mask;
+	}
+
+	for (size_t j = ((i + 1) & mask); dl->index[j]; j = ((j + 1) & mask)) {
+		const size_t home = dl->index[j]->hash & mask;
+
+		/* move entry if the hole is between its home slot and it */
+		if (((j - home) & mask) >= ((j - i) & mask)) {
+			dl->index[i] = dl->index[j];
+			i = j;
+		}
+	}
+
+	dl->index[i] = NULL;
+}
+
+/* Find dictionary node by key */
+static data_list_node_t *_dict_find(const data_list_t *dl, const char *key)
+{
+	data_list_node_t *i;
+
+	_check_data_list_magic(dl);
+
+	if (dl->index) {
+		const size_t mask = dl->index_size - 1;
+		const uint32_t hash = _hash_key(key);
+
+		for (size_t j = (hash & mask); (i = dl->index[j]);
+		     j = ((j + 1) & mask)) {
+			_check_data_list_node_magic(i);
+
+			if ((i->hash == hash) && !xstrcmp(key, i->key))
+				return i;
+		}
+
+		return NULL;
+	}
+
+	for (i = dl->begin; i; i = i->next) {
+		_check_data_list_node_magic(i);
+
+		if (!xstrcmp(key, i->key))
+			return i;
+	}
+
+	return NULL;
+}
+
 static void _release_data_list_node(data_list_t *dl, data_list_node_t *dn)
 {
 	_check_data_list_magic(dl);
@@ -222,8 +344,9 @@ static void _release_data_list_node(data_list_t *dl, data_list_node_t *dn)
 	log_flag(DATA, "%s: free data-list(0x%"PRIxPTR")[%zu]",
 		 __func__, (uintptr_t) dl, dl->count);
 
-	/* walk list to find new previous */
-	for (prev = dl->begin; prev && prev->next != dn; ) {
+	/* walk list to find new previous (none when releasing the head) */
+	for (prev = ((dn == dl->begin) ? NULL : dl->begin);
+	     prev && prev->next != dn; ) {
 		_check_data_list_node_magic(prev);
 		prev = prev->next;
 		if (prev)
@@ -255,9 +378,11 @@ static void _release_data_list_node(data_list_t *dl, data_list_node_t *dn)
 		prev->next = dn->next;
 	}
 
+	if (dl->index && dn->key)
+		_index_remove(dl, dn);
+
 	dl->count--;
 	FREE_NULL_DATA(dn->data);
-	xfree(dn->key);
 
 	dn->magic = ~DATA_LIST_NODE_MAGIC;
 	xfree(dn);
@@ -281,6 +406,10 @@ static void _release_data_list(data_list_t *dl)
 
 	xassert(dl->end);
 
+	/* everything is getting released so don't bother with the index */
+	xfree(dl->index);
+	dl->index_size = 0;
+
 	while((i = n)) {
 		n = i->next;
 		_release_data_list_node(dl, i);
@@ -307,14 +436,26 @@ finish:
  */
 static data_list_node_t *_new_data_list_node(data_t *d, const char *key)
 {
-	data_list_node_t *dn = xmalloc(sizeof(*dn));
-	dn->magic = DATA_LIST_NODE_MAGIC;
+	data_list_node_t *dn;
 
 	_check_magic(d);
 
+	if (key) {
+		const size_t len = strlen(key) + 1;
+
+		/* store key in the same allocation as the node */
+		dn = xmalloc(sizeof(*dn) + len);
+		dn->key = (char *) (dn + 1);
+		memcpy(dn->key, key, len);
+		dn->hash = _hash_key(key);
+	} else {
+		dn = xmalloc(sizeof(*dn));
+	}
+
+	dn->magic = DATA_LIST_NODE_MAGIC;
 	dn->data = d;
+
 	if (key) {
-		dn->key = xstrdup(key);
 
 		log_flag(DATA, "%s: new dictionary entry data-list-node(0x%"PRIxPTR")[%s]=%pD",
 			 __func__, (uintptr_t) dn, dn->key, dn->data);
@@ -346,6 +487,7 @@ static void _data_list_append(data_list_t *dl, data_t *d, const char *key)
 	}
 
 	dl->count++;
+	_index_add(dl, n);
 
 	if (n->key)
 		log_flag(DATA, "%s: append dictionary entry data-list-node(0x%"PRIxPTR")[%s]=%pD",
@@ -372,6 +514,7 @@ static void _data_list_prepend(data_list_t *dl, data_t *d, const char *key)
 	}
 
 	dl->count++;
+	_index_add(dl, n);
 
 	log_flag(DATA, "%s: prepend %pD[%s]->data-list-node(0x%"PRIxPTR")[%s]=%pD",
 		 __func__, d, key, (uintptr_t) n, n->key, n->data);
@@ -761,32 +904,15 @@ extern const data_t *data_key_get_const(const data_t *data, const char *key)
 	if (!data->data.dict_u->count)
 		return NULL;
 
-	_check_data_list_magic(data->data.dict_u);
-	i = data->data.dict_u->begin;
-	while (i) {
-		_check_data_list_node_magic(i);
-
-		if (!xstrcmp(key, i->key))
-			break;
-
-		i = i->next;
-	}
-
-	if (i)
+	if ((i = _dict_find(data->data.dict_u, key)))
 		return i->data;
 	else
 		return NULL;
 }
 
-static bool _match_string(const char *key, data_t *data, void *needle_ptr)
-{
-	const char *needle = needle_ptr;
-	return !xstrcmp(key, needle);
-}
-
 extern data_t *data_key_get(data_t *data, const char *key)
 {
-	return data_dict_find_first(data, _match_string, (void *) key);
+	return (data_t *) data_key_get_const(data, key);
 }
 
 extern data_t *data_key_get_int(data_t *data, int64_t key)
@@ -921,18 +1047,7 @@ extern bool data_key_unset(data_t *data, const char *key)
 	if (!key || data->type != TYPE_DICT)
 		return NULL;
 
-	_check_data_list_magic(data->data.dict_u);
-	i = data->data.dict_u->begin;
-	while (i) {
-		_check_data_list_node_magic(i);
-
-		if (!xstrcmp(key, i->key))
-			break;
-
-		i = i->next;
-	}
-
-	if (!i) {
+	if (!(i = _dict_find(data->data.dict_u, key))) {
 		log_flag(DATA, "%s: remove non-existent key in %pD[%s]",
 			 __func__, data, key);
 		return false;
@@ -72,6 +72,7 @@ strong_alias(eio_new_initial_obj,	slurm_eio_new_initial_obj);
 strong_alias(eio_obj_create,		slurm_eio_obj_create);
 strong_alias(eio_obj_destroy,		slurm_eio_obj_destroy);
 strong_alias(eio_remove_obj,		slurm_eio_remove_obj);
+strong_alias(eio_set_poll_timeout,	slurm_eio_set_poll_timeout);
 strong_alias(eio_signal_shutdown,	slurm_eio_signal_shutdown);
 strong_alias(eio_signal_wakeup,		slurm_eio_signal_wakeup);
 
@@ -89,6 +90,7 @@ struct eio_handle_components {
 	uint16_t shutdown_wait;
 	list_t *obj_list;
 	list_t *new_objs;
+	int poll_timeout; /* msec, set by callbacks for the next poll only */
 };
 
 typedef struct {
@@ -100,7 +102,7 @@ typedef struct {
 /* Function prototypes */
 
 static int          _poll_internal(struct pollfd *pfds, unsigned int nfds,
-				   time_t shutdown_time);
+				   time_t shutdown_time, int poll_timeout);
 static unsigned int _poll_setup_pollfds(struct pollfd *pfds, eio_obj_t *map[],
 					list_t *l);
 static void _poll_dispatch(struct pollfd *pfds, unsigned int nfds,
@@ -123,6 +125,7 @@ eio_handle_t *eio_handle_create(uint16_t shutdown_wait)
 
 	eio->obj_list = list_create(eio_obj_destroy);
 	eio->new_objs = list_create(eio_obj_destroy);
+	eio->poll_timeout = -1;
 
 	slurm_mutex_init(&eio->shutdown_mutex);
 	eio->shutdown_wait = DEFAULT_EIO_SHUTDOWN_WAIT;
@@ -233,6 +236,14 @@ int eio_signal_shutdown(eio_handle_t *eio)
 	return 0;
 }
 
+void eio_set_poll_timeout(eio_handle_t *eio, int msec)
+{
+	xassert(eio->magic == EIO_MAGIC);
+
+	if ((eio->poll_timeout < 0) || (msec < eio->poll_timeout))
+		eio->poll_timeout = msec;
+}
+
 int eio_signal_wakeup(eio_handle_t *eio)
 {
 	char c = 0;
@@ -295,8 +306,10 @@ int eio_handle_mainloop(eio_handle_t *eio)
 			goto done;
 
 		debug4("eio: handling events for %u objects", n);
+		eio->poll_timeout = -1;
 		nfds = _poll_setup_pollfds(pollfds, map, eio->obj_list);
-		if (nfds <= 0)
+		/* Objects holding back work still need the timed wakeup */
+		if ((nfds <= 0) && (eio->poll_timeout < 0))
 			goto done;
 
 		/*
@@ -312,7 +325,8 @@ int eio_handle_mainloop(eio_handle_t *eio)
 		slurm_mutex_lock(&eio->shutdown_mutex);
 		shutdown_time = eio->shutdown_time;
 		slurm_mutex_unlock(&eio->shutdown_mutex);
-		if (_poll_internal(pollfds, nfds, shutdown_time) < 0)
+		if (_poll_internal(pollfds, nfds, shutdown_time,
+				   eio->poll_timeout) < 0)
 			goto error;
 
 		/* See if we've been told to shut down by eio_signal_shutdown */
@@ -341,7 +355,7 @@ done:
 }
 
 static int _poll_internal(struct pollfd *pfds, unsigned int nfds,
-			  time_t shutdown_time)
+			  time_t shutdown_time, int poll_timeout)
 {
 	int n, timeout;
 
@@ -349,6 +363,8 @@ static int _poll_internal(struct pollfd *pfds, unsigned int nfds,
 		timeout = 1000;	/* Return every 1000 msec during shutdown */
 	else
 		timeout = -1;
+	if ((poll_timeout >= 0) && ((timeout < 0) || (poll_timeout < timeout)))
+		timeout = poll_timeout;
 	while ((n = poll(pfds, nfds, timeout)) < 0) {
 		switch (errno) {
 		case EINTR:
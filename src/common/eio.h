@@ -111,6 +111,13 @@ bool eio_message_socket_readable(eio_obj_t *obj);
 int eio_message_socket_accept(eio_obj_t *obj, list_t *objs);
 
 int eio_signal_wakeup(eio_handle_t *eio);
+
+/*
+ * Wake up the next poll after at most "msec" milliseconds even if no fd
+ * becomes ready. Only valid from readable() or writable() callbacks, which
+ * run in the eio thread just before each poll.
+ */
+void eio_set_poll_timeout(eio_handle_t *eio, int msec);
 int eio_signal_shutdown(eio_handle_t *eio);
 
 eio_obj_t *eio_obj_create(int fd, struct io_operations *ops, void *arg);
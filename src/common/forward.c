@@ -57,6 +57,13 @@
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
+/*
+ * Maximum age of the auth credential packed once by start_msg_tree() before
+ * the branch threads go back to packing a fresh credential for each send.
+ * Matches the credential refresh done by slurm_buffers_pack_msg().
+ */
+#define FWD_PACKED_BUFS_TTL 60
+
 static slurm_node_alias_addrs_t *last_alias_addrs = NULL;
 static pthread_mutex_t alias_addrs_mutex = PTHREAD_MUTEX_INITIALIZER;
 
@@ -68,6 +75,8 @@ typedef struct {
 	int timeout;
 	hostlist_t *tree_hl;
 	pthread_mutex_t *tree_mutex;
+	msg_bufs_t *packed_bufs;
+	time_t packed_time;
 } fwd_tree_t;
 
 static void _start_msg_tree_internal(hostlist_t *hl, hostlist_t **sp_hl,
@@ -401,6 +410,54 @@ static int _fwd_tree_get_addr(fwd_tree_t *fwd_tree, char *name,
 	return SLURM_SUCCESS;
 }
 
+static void _fwd_tree_init_send_msg(slurm_msg_t *send_msg,
+				    slurm_msg_t *orig_msg)
+{
+	slurm_msg_t_init(send_msg);
+	send_msg->msg_type = orig_msg->msg_type;
+	send_msg->flags = orig_msg->flags;
+	send_msg->data = orig_msg->data;
+	send_msg->protocol_version = orig_msg->protocol_version;
+	if (orig_msg->restrict_uid_set)
+		slurm_msg_set_r_uid(send_msg, orig_msg->restrict_uid);
+}
+
+/*
+ * Pack the auth credential and body of the message once so every branch of
+ * the tree only has to pack its own header instead of creating a new
+ * credential for each child.
+ */
+static msg_bufs_t *_fwd_tree_pack_bufs(slurm_msg_t *orig_msg)
+{
+	msg_bufs_t *buffers = xmalloc(sizeof(*buffers));
+	slurm_msg_t send_msg;
+
+	_fwd_tree_init_send_msg(&send_msg, orig_msg);
+
+	if (!send_msg.restrict_uid_set ||
+	    slurm_buffers_pack_msg(&send_msg, buffers, false)) {
+		log_flag(NET, "%s: unable to pack %s once for all branches, packing per branch",
+			 __func__, rpc_num2string(orig_msg->msg_type));
+		xfree(buffers);
+		return NULL;
+	}
+
+	/* header is packed per branch */
+	FREE_NULL_BUFFER(buffers->header);
+
+	return buffers;
+}
+
+static void _fwd_tree_free_bufs(msg_bufs_t *buffers)
+{
+	if (!buffers)
+		return;
+
+	FREE_NULL_BUFFER(buffers->auth);
+	FREE_NULL_BUFFER(buffers->body);
+	xfree(buffers);
+}
+
 static void *_fwd_tree_thread(void *arg)
 {
 	fwd_tree_t *fwd_tree = arg;
@@ -409,14 +466,7 @@ static void *_fwd_tree_thread(void *arg)
 	char *buf = NULL;
 	slurm_msg_t send_msg;
 
-	slurm_msg_t_init(&send_msg);
-	send_msg.msg_type = fwd_tree->orig_msg->msg_type;
-	send_msg.flags = fwd_tree->orig_msg->flags;
-	send_msg.data = fwd_tree->orig_msg->data;
-	send_msg.protocol_version = fwd_tree->orig_msg->protocol_version;
-	if (fwd_tree->orig_msg->restrict_uid_set)
-		slurm_msg_set_r_uid(&send_msg,
-				    fwd_tree->orig_msg->restrict_uid);
+	_fwd_tree_init_send_msg(&send_msg, fwd_tree->orig_msg);
 
 	/* repeat until we are sure the message was sent */
 	while ((name = hostlist_shift(fwd_tree->tree_hl))) {
@@ -426,6 +476,13 @@ static void *_fwd_tree_thread(void *arg)
 			continue;
 		}
 
+		if (fwd_tree->packed_bufs &&
+		    (difftime(time(NULL), fwd_tree->packed_time) <
+		     FWD_PACKED_BUFS_TTL))
+			send_msg.packed_bufs = fwd_tree->packed_bufs;
+		else
+			send_msg.packed_bufs = NULL;
+
 		/*
 		 * Tell additional message forwarding to use the same
 		 * tree_width; without this, additional message forwarding
@@ -842,6 +899,10 @@ extern list_t *start_msg_tree(hostlist_t *hl, slurm_msg_t *msg, int timeout)
 	fwd_tree.notify = &notify;
 	fwd_tree.p_thr_count = &thr_count;
 	fwd_tree.tree_mutex = &tree_mutex;
+	if (!msg->conn) {
+		fwd_tree.packed_bufs = _fwd_tree_pack_bufs(msg);
+		fwd_tree.packed_time = time(NULL);
+	}
 
 	_start_msg_tree_internal(NULL, sp_hl, &fwd_tree, hl_count);
 
@@ -862,6 +923,7 @@ extern list_t *start_msg_tree(hostlist_t *hl, slurm_msg_t *msg, int timeout)
 
 	slurm_mutex_destroy(&tree_mutex);
 	slurm_cond_destroy(&notify);
+	_fwd_tree_free_bufs(fwd_tree.packed_bufs);
 
 	return ret_list;
 }
@@ -62,6 +62,11 @@
  *
  *	slurmstepd honors task_read_info.type to determine where messages sent.
  *
+ *	slurmstepd may send SLURM_IO_BATCH to clients of protocol version
+ *	SLURM_24_11_PROTOCOL_VERSION or newer. Its payload is a sequence of
+ *	io_hdr_t.ltaskid packed SLURM_IO_STDOUT or SLURM_IO_STDERR messages
+ *	(header plus payload each, zero length ones being eof).
+ *
  * Connection ends with io_hdr_t.length=0 packet with no payload
  */
 
@@ -74,6 +79,10 @@
 
 #define SLURM_IO_MAX_MSG_LEN 1024
 
+/* Limits on the payload of a SLURM_IO_BATCH message */
+#define SLURM_IO_MAX_BATCH_LEN (16 * 1024)
+#define SLURM_IO_MAX_BATCH_MSGS 32
+
 typedef enum {
 	SLURM_IO_INVALID = -1,
 	SLURM_IO_STDIN = 0,
@@ -81,6 +90,7 @@ typedef enum {
 	SLURM_IO_STDERR = 2,
 	SLURM_IO_ALLSTDIN = 3,
 	SLURM_IO_CONNECTION_TEST = 4,
+	SLURM_IO_BATCH = 5,
 	SLURM_IO_INVALID_MAX
 } io_hdr_type_t;
 
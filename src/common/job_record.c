@@ -36,6 +36,7 @@
 #include "src/common/port_mgr.h"
 #include "src/common/assoc_mgr.h"
 #include "src/common/slurm_protocol_pack.h"
+#include "src/common/str_intern.h"
 
 #include "src/interfaces/jobacct_gather.h"
 #include "src/interfaces/gres.h"
@@ -163,40 +164,40 @@ static void _delete_job_details(job_record_t *job_entry)
 		list_enqueue(purge_files_list, job_id);
 	}
 
-	xfree(job_entry->details->acctg_freq);
+	FREE_NULL_INTERNED(job_entry->details->acctg_freq);
 	for (i=0; i<job_entry->details->argc; i++)
-		xfree(job_entry->details->argv[i]);
+		FREE_NULL_INTERNED(job_entry->details->argv[i]);
 	xfree(job_entry->details->argv);
 	xfree(job_entry->details->cpu_bind);
 	free_cron_entry(job_entry->details->crontab_entry);
 	FREE_NULL_LIST(job_entry->details->depend_list);
 	xfree(job_entry->details->dependency);
 	xfree(job_entry->details->orig_dependency);
-	xfree(job_entry->details->env_hash);
+	FREE_NULL_INTERNED(job_entry->details->env_hash);
 	for (i=0; i<job_entry->details->env_cnt; i++)
 		xfree(job_entry->details->env_sup[i]);
 	xfree(job_entry->details->env_sup);
-	xfree(job_entry->details->std_err);
+	FREE_NULL_INTERNED(job_entry->details->std_err);
 	FREE_NULL_BITMAP(job_entry->details->exc_node_bitmap);
 	xfree(job_entry->details->exc_nodes);
 	FREE_NULL_LIST(job_entry->details->feature_list);
 	xfree(job_entry->details->features);
 	xfree(job_entry->details->cluster_features);
 	FREE_NULL_BITMAP(job_entry->details->job_size_bitmap);
-	xfree(job_entry->details->std_in);
+	FREE_NULL_INTERNED(job_entry->details->std_in);
 	xfree(job_entry->details->mc_ptr);
-	xfree(job_entry->details->mem_bind);
+	FREE_NULL_INTERNED(job_entry->details->mem_bind);
 	FREE_NULL_LIST(job_entry->details->prefer_list);
 	xfree(job_entry->details->prefer);
 	xfree(job_entry->details->req_context);
-	xfree(job_entry->details->std_out);
-	xfree(job_entry->details->submit_line);
+	FREE_NULL_INTERNED(job_entry->details->std_out);
+	FREE_NULL_INTERNED(job_entry->details->submit_line);
 	FREE_NULL_BITMAP(job_entry->details->req_node_bitmap);
 	xfree(job_entry->details->req_nodes);
 	xfree(job_entry->details->script);
-	xfree(job_entry->details->script_hash);
+	FREE_NULL_INTERNED(job_entry->details->script_hash);
 	xfree(job_entry->details->arbitrary_tpn);
-	xfree(job_entry->details->work_dir);
+	FREE_NULL_INTERNED(job_entry->details->work_dir);
 	xfree(job_entry->details->x11_magic_cookie);
 	xfree(job_entry->details->x11_target);
 	xfree(job_entry->details);	/* Must be last */
@@ -1388,17 +1389,17 @@ static int _load_job_details(job_record_t *job_ptr, buf_t *buffer,
 	}
 
 	/* free any left-over detail data */
-	xfree(job_ptr->details->acctg_freq);
+	FREE_NULL_INTERNED(job_ptr->details->acctg_freq);
 	xfree(job_ptr->details->arbitrary_tpn);
 	for (i=0; i<job_ptr->details->argc; i++)
-		xfree(job_ptr->details->argv[i]);
+		FREE_NULL_INTERNED(job_ptr->details->argv[i]);
 	xfree(job_ptr->details->argv);
 	xfree(job_ptr->details->cpu_bind);
 	FREE_NULL_LIST(job_ptr->details->depend_list);
 	xfree(job_ptr->details->dependency);
 	xfree(job_ptr->details->orig_dependency);
-	xfree(job_ptr->details->std_err);
-	xfree(job_ptr->details->env_hash);
+	FREE_NULL_INTERNED(job_ptr->details->std_err);
+	FREE_NULL_INTERNED(job_ptr->details->env_hash);
 	for (i=0; i<job_ptr->details->env_cnt; i++)
 		xfree(job_ptr->details->env_sup[i]);
 	xfree(job_ptr->details->env_sup);
@@ -1406,16 +1407,22 @@ static int _load_job_details(job_record_t *job_ptr, buf_t *buffer,
 	xfree(job_ptr->details->features);
 	xfree(job_ptr->details->cluster_features);
 	xfree(job_ptr->details->prefer);
-	xfree(job_ptr->details->std_in);
-	xfree(job_ptr->details->mem_bind);
-	xfree(job_ptr->details->script_hash);
-	xfree(job_ptr->details->std_out);
-	xfree(job_ptr->details->submit_line);
+	FREE_NULL_INTERNED(job_ptr->details->std_in);
+	FREE_NULL_INTERNED(job_ptr->details->mem_bind);
+	FREE_NULL_INTERNED(job_ptr->details->script_hash);
+	FREE_NULL_INTERNED(job_ptr->details->std_out);
+	FREE_NULL_INTERNED(job_ptr->details->submit_line);
 	xfree(job_ptr->details->req_nodes);
-	xfree(job_ptr->details->work_dir);
+	FREE_NULL_INTERNED(job_ptr->details->work_dir);
 
 	/* now put the details into the job record */
-	job_ptr->details->acctg_freq = acctg_freq;
+	job_ptr->details->acctg_freq = str_intern(acctg_freq);
+	xfree(acctg_freq);
+	for (i = 0; i < argc; i++) {
+		char *arg = argv[i];
+		argv[i] = str_intern(arg);
+		xfree(arg);
+	}
 	job_ptr->details->argc = argc;
 	job_ptr->details->argv = argv;
 	job_ptr->details->accrue_time = accrue_time;
@@ -1438,15 +1445,18 @@ static int _load_job_details(job_record_t *job_ptr, buf_t *buffer,
 	job_ptr->details->orig_dependency = orig_dependency;
 	job_ptr->details->env_cnt = env_cnt;
 	job_ptr->details->env_sup = env_sup;
-	job_ptr->details->std_err = err;
+	job_ptr->details->std_err = str_intern(err);
+	xfree(err);
 	job_ptr->details->exc_nodes = exc_nodes;
 	job_ptr->details->features = features;
 	job_ptr->details->cluster_features = cluster_features;
 	job_ptr->details->prefer = prefer;
-	job_ptr->details->env_hash = env_hash;
+	job_ptr->details->env_hash = str_intern(env_hash);
+	xfree(env_hash);
 	job_ptr->details->job_size_bitmap = job_size_bitmap;
 
-	job_ptr->details->script_hash = script_hash;
+	job_ptr->details->script_hash = str_intern(script_hash);
+	xfree(script_hash);
 
 	switch (features_use) {
 	case 0:
@@ -1462,7 +1472,8 @@ static int _load_job_details(job_record_t *job_ptr, buf_t *buffer,
 		break;
 	}
 
-	job_ptr->details->std_in = in;
+	job_ptr->details->std_in = str_intern(in);
+	xfree(in);
 	job_ptr->details->pn_min_cpus = pn_min_cpus;
 	job_ptr->details->orig_pn_min_cpus = pn_min_cpus;
 	job_ptr->details->pn_min_memory = pn_min_memory;
@@ -1472,7 +1483,8 @@ static int _load_job_details(job_record_t *job_ptr, buf_t *buffer,
 	job_ptr->details->orig_max_cpus = max_cpus;
 	job_ptr->details->max_nodes = max_nodes;
 	job_ptr->details->mc_ptr = mc_ptr;
-	job_ptr->details->mem_bind = mem_bind;
+	job_ptr->details->mem_bind = str_intern(mem_bind);
+	xfree(mem_bind);
 	job_ptr->details->mem_bind_type = mem_bind_type;
 	job_ptr->details->min_cpus = min_cpus;
 	job_ptr->details->orig_min_cpus = min_cpus;
@@ -1481,8 +1493,10 @@ static int _load_job_details(job_record_t *job_ptr, buf_t *buffer,
 	job_ptr->details->ntasks_per_node = ntasks_per_node;
 	job_ptr->details->num_tasks = num_tasks;
 	job_ptr->details->open_mode = open_mode;
-	job_ptr->details->std_out = out;
-	job_ptr->details->submit_line = submit_line;
+	job_ptr->details->std_out = str_intern(out);
+	xfree(out);
+	job_ptr->details->submit_line = str_intern(submit_line);
+	xfree(submit_line);
 	job_ptr->details->overcommit = overcommit;
 	job_ptr->details->prolog_running = prolog_running;
 	job_ptr->details->req_nodes = req_nodes;
@@ -1493,7 +1507,8 @@ static int _load_job_details(job_record_t *job_ptr, buf_t *buffer,
 	job_ptr->details->submit_time = submit_time;
 	job_ptr->details->task_dist = task_dist;
 	job_ptr->details->whole_node = whole_node;
-	job_ptr->details->work_dir = work_dir;
+	job_ptr->details->work_dir = str_intern(work_dir);
+	xfree(work_dir);
 
 	if (((job_ptr->details->task_dist & SLURM_DIST_STATE_BASE) ==
 	     SLURM_DIST_ARBITRARY) && job_record_calc_arbitrary_tpn(job_ptr))
@@ -70,13 +70,15 @@ extern list_t *purge_files_list; /* list of job ids to purge files of */
 typedef struct {
 	uint32_t magic;			/* magic cookie for data integrity */
 					/* DO NOT ALPHABETIZE */
-	char *acctg_freq;		/* accounting polling interval */
+	char *acctg_freq;		/* accounting polling interval,
+					 * interned, see str_intern.h */
 	time_t accrue_time;             /* Time when we start accruing time for
 					 * priority, */
 	uint16_t *arbitrary_tpn;	/* array of the number of tasks on each
 					 * node for arbitrary distribution */
 	uint32_t argc;			/* count of argv elements */
-	char **argv;			/* arguments for a batch job script */
+	char **argv;			/* arguments for a batch job script,
+					 * elements interned */
 	time_t begin_time;		/* start at this time (srun --begin),
 					 * resets to time first eligible
 					 * (all dependencies satisfied) */
@@ -102,7 +104,8 @@ typedef struct {
 	char *dependency;		/* wait for other jobs */
 	char *orig_dependency;		/* original value (for archiving) */
 	uint16_t env_cnt;		/* size of env_sup (see below) */
-	char *env_hash;			/* hash value of environment */
+	char *env_hash;			/* hash value of environment,
+					 * interned, see str_intern.h */
 	char **env_sup;			/* supplemental environment variables */
 	bitstr_t *exc_node_bitmap;	/* bitmap of excluded nodes */
 	char *exc_nodes;		/* excluded nodes */
@@ -118,7 +121,8 @@ typedef struct {
 	uint32_t orig_max_cpus;		/* requested value of max_cpus */
 	uint32_t max_nodes;		/* maximum number of nodes */
 	multi_core_data_t *mc_ptr;	/* multi-core specific data */
-	char *mem_bind;			/* binding map for map/mask_cpu */
+	char *mem_bind;			/* binding map for map/mask_cpu,
+					 * interned, see str_intern.h */
 	uint16_t mem_bind_type;		/* see mem_bind_type_t */
 	uint32_t min_cpus;		/* minimum number of cpus */
 	uint32_t orig_min_cpus;		/* requested value of min_cpus */
@@ -163,12 +167,16 @@ typedef struct {
 					 * other jobs */
 	char *script;			/* DBD USE ONLY DON'T PACK:
 					 * job's script */
-	char *script_hash;              /* hash value of script NO NOT PACK */
-	char *std_err;			/* pathname of job's stderr file */
-	char *std_in;			/* pathname of job's stdin file */
-	char *std_out;			/* pathname of job's stdout file */
+	char *script_hash;              /* hash value of script NO NOT PACK,
+					 * interned, see str_intern.h */
+	char *std_err;			/* pathname of job's stderr file,
+					 * interned, see str_intern.h */
+	char *std_in;			/* pathname of job's stdin file,
+					 * interned, see str_intern.h */
+	char *std_out;			/* pathname of job's stdout file,
+					 * interned, see str_intern.h */
 	char *submit_line;              /* The command issued with all it's
-					 * options in a string */
+					 * options in a string, interned */
 	time_t submit_time;		/* time of submission */
 	uint32_t task_dist;		/* task layout for this job. Only
 					 * useful when Consumable Resources
@@ -177,7 +185,8 @@ typedef struct {
 	uint8_t whole_node;		/* WHOLE_NODE_REQUIRED: 1: --exclusive
 					 * WHOLE_NODE_USER: 2: --exclusive=user
 					 * WHOLE_NODE_MCS:  3: --exclusive=mcs */
-	char *work_dir;			/* pathname of working directory */
+	char *work_dir;			/* pathname of working directory,
+					 * interned, see str_intern.h */
 	uint16_t x11;			/* --x11 flags */
 	char *x11_magic_cookie;		/* x11 magic cookie */
 	char *x11_target;		/* target host, or socket if port == 0 */
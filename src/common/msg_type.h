@@ -190,6 +190,8 @@ typedef enum {
 	RESPONSE_HET_JOB_ALLOCATION,
 	REQUEST_HET_JOB_ALLOC_INFO,
 	REQUEST_SUBMIT_BATCH_HET_JOB,
+	REQUEST_SUBMIT_BATCH_JOBS,
+	RESPONSE_SUBMIT_BATCH_JOBS,
 
 	REQUEST_CTLD_MULT_MSG = 4500,
 	RESPONSE_CTLD_MULT_MSG,
@@ -287,6 +287,18 @@ typedef struct {
 	list_t *jobs; /* list of job_desc_msg_t* */
 } openapi_job_submit_request_t;
 
+typedef struct {
+	char *script;
+	list_t *jobs; /* list of job_desc_msg_t* */
+} openapi_job_submit_batch_request_t;
+
+typedef struct {
+	OPENAPI_RESP_STRUCT_META_FIELD;
+	OPENAPI_RESP_STRUCT_ERRORS_FIELD;
+	OPENAPI_RESP_STRUCT_WARNINGS_FIELD;
+	list_t *results; /* list of submit_response_msg_t* */
+} openapi_job_submit_batch_response_t;
+
 typedef struct {
 	OPENAPI_RESP_STRUCT_META_FIELD;
 	OPENAPI_RESP_STRUCT_ERRORS_FIELD;
@@ -1623,6 +1623,8 @@ uint16_t parse_compress_type(const char *arg)
 	if (!arg) {
 #if HAVE_LZ4
 		return COMPRESS_LZ4;
+#elif HAVE_ZSTD
+		return COMPRESS_ZSTD;
 #else
 		error("No compression library available, compression disabled.");
 		return COMPRESS_OFF;
@@ -1631,6 +1633,9 @@ uint16_t parse_compress_type(const char *arg)
 
 	if (!strcasecmp(arg, "lz4"))
 		return COMPRESS_LZ4;
+	else if (!xstrncasecmp(arg, "zstd", 4) &&
+		 ((arg[4] == '\0') || (arg[4] == ':')))
+		return COMPRESS_ZSTD;
 	else if (!strcasecmp(arg, "none"))
 		return COMPRESS_OFF;
 
@@ -1639,6 +1644,26 @@ uint16_t parse_compress_type(const char *arg)
 	return COMPRESS_OFF;
 }
 
+/* parse --compress for a "library:level" compression level, 0 if not set */
+int parse_compress_level(const char *arg)
+{
+	char *sep, *end = NULL;
+	long level;
+
+	if (!arg || !(sep = xstrchr(arg, ':')))
+		return 0;
+
+	level = strtol(sep + 1, &end, 10);
+	if ((end == (sep + 1)) || (*end != '\0') ||
+	    (level < INT16_MIN) || (level > INT16_MAX)) {
+		error("Compression level '%s' invalid, using default level.",
+		      sep + 1);
+		return 0;
+	}
+
+	return level;
+}
+
 /*
  * IN: option argument value to interpret.
  * RET: 1 if enabled, 0 if disabled, -1 if error
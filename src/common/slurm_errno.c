@@ -547,6 +547,8 @@ slurm_errtab_t slurm_errtab[] = {
 	  "Unable to satisfy cpu bind request"			},
 	{ ERRTAB_ENTRY(ESLURMD_CPU_LAYOUT_ERROR),
 	  "Unable to layout tasks on given cpus"		},
+	{ ERRTAB_ENTRY(ESLURMD_BCAST_CACHED),
+	  "File copied from node's broadcast cache"		},
 
 	/* socket specific Slurm communications error */
 
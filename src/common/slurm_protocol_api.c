@@ -1845,6 +1845,39 @@ skip_auth2:
 	return rc;
 }
 
+/*
+ * Pack only the header of msg into buffers, reusing the auth credential and
+ * body already packed in msg->packed_bufs.
+ */
+static void _buffers_pack_header(slurm_msg_t *msg, msg_bufs_t *buffers)
+{
+	header_t header;
+
+	xassert(msg->packed_bufs);
+	xassert(msg->packed_bufs->body);
+
+	buffers->auth = msg->packed_bufs->auth;
+	buffers->body = msg->packed_bufs->body;
+
+	if (msg->forward.init != FORWARD_INIT) {
+		forward_init(&msg->forward);
+		msg->ret_list = NULL;
+	}
+
+	if (!msg->forward.tree_width)
+		msg->forward.tree_width = slurm_conf.tree_width;
+
+	forward_wait(msg);
+
+	init_header(&header, msg, msg->flags);
+	update_header(&header, get_buf_offset(buffers->body));
+	buffers->header = init_buf(BUF_SIZE);
+	pack_header(&header, buffers->header);
+	log_flag_hex(NET_RAW, get_buf_data(buffers->header),
+		     get_buf_offset(buffers->header),
+		     "%s: packed header", __func__);
+}
+
 /**********************************************************************\
  * send message functions
 \**********************************************************************/
@@ -1896,7 +1929,9 @@ extern int slurm_send_node_msg(int fd, slurm_msg_t *msg)
 	/*
 	 * Pack and send message
 	 */
-	if ((rc = slurm_buffers_pack_msg(msg, &buffers, true)))
+	if (msg->packed_bufs)
+		_buffers_pack_header(msg, &buffers);
+	else if ((rc = slurm_buffers_pack_msg(msg, &buffers, true)))
 		goto cleanup;
 
 	rc = slurm_bufs_sendto(fd, &buffers);
@@ -1921,8 +1956,10 @@ extern int slurm_send_node_msg(int fd, slurm_msg_t *msg)
 
 cleanup:
 	FREE_NULL_BUFFER(buffers.header);
-	FREE_NULL_BUFFER(buffers.auth);
-	FREE_NULL_BUFFER(buffers.body);
+	if (!msg->packed_bufs) {
+		FREE_NULL_BUFFER(buffers.auth);
+		FREE_NULL_BUFFER(buffers.body);
+	}
 	return rc;
 }
 
@@ -4481,6 +4481,7 @@ extern void slurm_free_file_bcast_msg(file_bcast_msg_t *msg)
 		xfree(msg->block);
 		xfree(msg->fname);
 		xfree(msg->exe_fname);
+		xfree(msg->file_hash);
 		xfree(msg->user_name);
 		delete_sbcast_cred(msg->cred);
 		xfree(msg);
@@ -5231,6 +5232,8 @@ extern int slurm_free_msg_data(slurm_msg_type_t type, void *data)
 	case REQUEST_HET_JOB_ALLOCATION:
 	case REQUEST_SUBMIT_BATCH_HET_JOB:
 	case RESPONSE_HET_JOB_ALLOCATION:
+	case REQUEST_SUBMIT_BATCH_JOBS:
+	case RESPONSE_SUBMIT_BATCH_JOBS:
 		FREE_NULL_LIST(data);
 		break;
 	case REQUEST_SET_FS_DAMPENING_FACTOR:
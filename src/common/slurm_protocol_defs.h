@@ -322,6 +322,10 @@ typedef struct slurm_msg {
 	int conn_fd; /* Only used when the message isn't on a persistent
 		      * connection. */
 	conmgr_fd_t *conmgr_fd; /* msg originates from conmgr connection. */
+	msg_bufs_t *packed_bufs; /* DON'T PACK OR FREE! Already packed auth
+				  * credential and body shared between every
+				  * branch of a message tree. Only the header
+				  * gets packed when sending. */
 	void *data;
 	uint16_t flags;
 	uint8_t hash_index;	/* DON'T PACK: zero for normal communication.
@@ -997,6 +1001,7 @@ enum compress_type {
 	COMPRESS_OFF = 0,	/* no compression */
 				/* = 1 was zlib */
 	COMPRESS_LZ4 = 2,	/* lz4 compression */
+	COMPRESS_ZSTD = 3,	/* zstd compression */
 };
 
 typedef enum {
@@ -1025,6 +1030,7 @@ typedef struct file_bcast_msg {
 	uint32_t uncomp_len;	/* uncompressed length of this data block */
 	char *block;		/* data for this block */
 	uint64_t file_size;	/* file size */
+	char *file_hash;	/* hash of the file's content, first block */
 } file_bcast_msg_t;
 
 typedef struct multi_core_data {
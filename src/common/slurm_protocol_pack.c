@@ -1493,6 +1493,66 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
+/* pack list_t of submit_response_msg_t */
+static void _pack_submit_response_list_msg(list_t *resp_list, buf_t *buffer,
+					   uint16_t protocol_version)
+{
+	submit_response_msg_t *msg;
+	list_itr_t *iter;
+	uint32_t cnt = 0;
+
+	if (protocol_version < SLURM_MIN_PROTOCOL_VERSION)
+		return;
+
+	if (resp_list)
+		cnt = list_count(resp_list);
+	pack32(cnt, buffer);
+	if (!cnt)
+		return;
+
+	iter = list_iterator_create(resp_list);
+	while ((msg = list_next(iter))) {
+		pack32(msg->job_id, buffer);
+		pack32(msg->step_id, buffer);
+		pack32(msg->error_code, buffer);
+		packstr(msg->job_submit_user_msg, buffer);
+	}
+	list_iterator_destroy(iter);
+}
+
+static int _unpack_submit_response_list_msg(list_t **resp_list, buf_t *buffer,
+					    uint16_t protocol_version)
+{
+	submit_response_msg_t *msg;
+	uint32_t cnt = 0;
+
+	*resp_list = list_create(
+		(ListDelF) slurm_free_submit_response_response_msg);
+
+	if (protocol_version < SLURM_MIN_PROTOCOL_VERSION)
+		return SLURM_SUCCESS;
+
+	safe_unpack32(&cnt, buffer);
+	if (cnt > NO_VAL16)
+		goto unpack_error;
+
+	for (uint32_t i = 0; i < cnt; i++) {
+		msg = xmalloc(sizeof(*msg));
+		list_append(*resp_list, msg);
+
+		safe_unpack32(&msg->job_id, buffer);
+		safe_unpack32(&msg->step_id, buffer);
+		safe_unpack32(&msg->error_code, buffer);
+		safe_unpackstr(&msg->job_submit_user_msg, buffer);
+	}
+
+	return SLURM_SUCCESS;
+
+unpack_error:
+	FREE_NULL_LIST(*resp_list);
+	return SLURM_ERROR;
+}
+
 static int _unpack_node_info_msg(node_info_msg_t **msg, buf_t *buffer,
 				 uint16_t protocol_version)
 {
@@ -10911,7 +10971,29 @@ static void _pack_file_bcast(file_bcast_msg_t * msg , buf_t *buffer,
 
 	grow_buf(buffer,  msg->block_len);
 
-	if (protocol_version >= SLURM_24_05_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_24_11_PROTOCOL_VERSION) {
+		pack32(msg->block_no, buffer);
+		pack16(msg->compress, buffer);
+		pack16(msg->flags, buffer);
+		pack16(msg->modes, buffer);
+
+		pack32(msg->uid, buffer);
+		packstr(msg->user_name, buffer);
+		pack32(msg->gid, buffer);
+
+		pack_time(msg->atime, buffer);
+		pack_time(msg->mtime, buffer);
+
+		packstr(msg->fname, buffer);
+		packstr(msg->exe_fname, buffer);
+		pack32(msg->block_len, buffer);
+		pack32(msg->uncomp_len, buffer);
+		pack64(msg->block_offset, buffer);
+		pack64(msg->file_size, buffer);
+		packstr(msg->file_hash, buffer);
+		packmem(msg->block, msg->block_len, buffer);
+		pack_sbcast_cred(msg->cred, buffer, protocol_version);
+	} else if (protocol_version >= SLURM_24_05_PROTOCOL_VERSION) {
 		pack32(msg->block_no, buffer);
 		pack16(msg->compress, buffer);
 		pack16(msg->flags, buffer);
@@ -10966,7 +11048,35 @@ static int _unpack_file_bcast(file_bcast_msg_t ** msg_ptr , buf_t *buffer,
 	msg = xmalloc ( sizeof (file_bcast_msg_t) ) ;
 	*msg_ptr = msg;
 
-	if (protocol_version >= SLURM_24_05_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_24_11_PROTOCOL_VERSION) {
+		safe_unpack32(&msg->block_no, buffer);
+		safe_unpack16(&msg->compress, buffer);
+		safe_unpack16(&msg->flags, buffer);
+		safe_unpack16(&msg->modes, buffer);
+
+		safe_unpack32(&msg->uid, buffer);
+		safe_unpackstr(&msg->user_name, buffer);
+		safe_unpack32(&msg->gid, buffer);
+
+		safe_unpack_time(&msg->atime, buffer);
+		safe_unpack_time(&msg->mtime, buffer);
+
+		safe_unpackstr(&msg->fname, buffer);
+		safe_unpackstr(&msg->exe_fname, buffer);
+		safe_unpack32(&msg->block_len, buffer);
+		safe_unpack32(&msg->uncomp_len, buffer);
+		safe_unpack64(&msg->block_offset, buffer);
+		safe_unpack64(&msg->file_size, buffer);
+		safe_unpackstr(&msg->file_hash, buffer);
+		safe_unpackmem_xmalloc(&msg->block, &uint32_tmp, buffer);
+		if (uint32_tmp != msg->block_len)
+			goto unpack_error;
+
+		msg->cred = unpack_sbcast_cred(buffer, msg,
+					       protocol_version);
+		if (msg->cred == NULL)
+			goto unpack_error;
+	} else if (protocol_version >= SLURM_24_05_PROTOCOL_VERSION) {
 		safe_unpack32(&msg->block_no, buffer);
 		safe_unpack16(&msg->compress, buffer);
 		safe_unpack16(&msg->flags, buffer);
@@ -12936,9 +13046,14 @@ pack_msg(slurm_msg_t const *msg, buf_t *buffer)
 		break;
 	case REQUEST_HET_JOB_ALLOCATION:
 	case REQUEST_SUBMIT_BATCH_HET_JOB:
+	case REQUEST_SUBMIT_BATCH_JOBS:
 		_pack_job_desc_list_msg(msg->data, buffer,
 					msg->protocol_version);
 		break;
+	case RESPONSE_SUBMIT_BATCH_JOBS:
+		_pack_submit_response_list_msg(msg->data, buffer,
+					       msg->protocol_version);
+		break;
 	case RESPONSE_HET_JOB_ALLOCATION:
 		_pack_job_info_list_msg(msg->data, buffer,
 					msg->protocol_version);
@@ -13587,9 +13702,15 @@ unpack_msg(slurm_msg_t * msg, buf_t *buffer)
 		break;
 	case REQUEST_HET_JOB_ALLOCATION:
 	case REQUEST_SUBMIT_BATCH_HET_JOB:
+	case REQUEST_SUBMIT_BATCH_JOBS:
 		rc = _unpack_job_desc_list_msg((list_t **) &(msg->data),
 					       buffer, msg->protocol_version);
 		break;
+	case RESPONSE_SUBMIT_BATCH_JOBS:
+		rc = _unpack_submit_response_list_msg((list_t **) &(msg->data),
+						      buffer,
+						      msg->protocol_version);
+		break;
 	case RESPONSE_HET_JOB_ALLOCATION:
 		rc = _unpack_job_info_list_msg((list_t **) &(msg->data),
 					       buffer, msg->protocol_version);
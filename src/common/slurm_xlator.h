@@ -510,6 +510,7 @@
 #define eio_obj_create			slurm_eio_obj_create
 #define eio_obj_destroy			slurm_eio_obj_destroy
 #define eio_remove_obj			slurm_eio_remove_obj
+#define eio_set_poll_timeout		slurm_eio_set_poll_timeout
 #define eio_signal_shutdown		slurm_eio_signal_shutdown
 #define eio_signal_wakeup		slurm_eio_signal_wakeup
 
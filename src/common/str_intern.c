@@ -0,0 +1,132 @@
+/*****************************************************************************\
+ *  str_intern.c - reference counted shared strings
+ *****************************************************************************
+ *  Copyright (C) 2024 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include <stddef.h>
+
+#include "src/common/macros.h"
+#include "src/common/str_intern.h"
+#include "src/common/xassert.h"
+#include "src/common/xhash.h"
+#include "src/common/xmalloc.h"
+
+#define MAGIC_INTERN_STR 0xa2b7efa1
+
+typedef struct {
+	int magic; /* MAGIC_INTERN_STR */
+	uint32_t refcnt;
+	uint32_t len;
+	char str[];
+} intern_str_t;
+
+static pthread_mutex_t intern_mutex = PTHREAD_MUTEX_INITIALIZER;
+static xhash_t *intern_table = NULL;
+
+static void _intern_idfunc(void *item, const char **key, uint32_t *key_len)
+{
+	intern_str_t *istr = item;
+
+	xassert(istr->magic == MAGIC_INTERN_STR);
+
+	*key = istr->str;
+	*key_len = istr->len;
+}
+
+static intern_str_t *_get_intern_str(char *str)
+{
+	intern_str_t *istr = (void *) (str - offsetof(intern_str_t, str));
+
+	xassert(istr->magic == MAGIC_INTERN_STR);
+	xassert(istr->refcnt > 0);
+
+	return istr;
+}
+
+extern char *str_intern(const char *str)
+{
+	intern_str_t *istr;
+	uint32_t len;
+
+	if (!str)
+		return NULL;
+
+	len = strlen(str);
+
+	slurm_mutex_lock(&intern_mutex);
+	if (!intern_table)
+		intern_table = xhash_init(_intern_idfunc, NULL);
+
+	if ((istr = xhash_get(intern_table, str, len))) {
+		istr->refcnt++;
+	} else {
+		istr = xmalloc(sizeof(*istr) + len + 1);
+		istr->magic = MAGIC_INTERN_STR;
+		istr->refcnt = 1;
+		istr->len = len;
+		memcpy(istr->str, str, len);
+		xhash_add(intern_table, istr);
+	}
+	slurm_mutex_unlock(&intern_mutex);
+
+	return istr->str;
+}
+
+extern char *str_intern_ref(char *str)
+{
+	if (!str)
+		return NULL;
+
+	slurm_mutex_lock(&intern_mutex);
+	_get_intern_str(str)->refcnt++;
+	slurm_mutex_unlock(&intern_mutex);
+
+	return str;
+}
+
+extern void str_intern_release(char *str)
+{
+	intern_str_t *istr;
+
+	if (!str)
+		return;
+
+	slurm_mutex_lock(&intern_mutex);
+	istr = _get_intern_str(str);
+	if (!--istr->refcnt) {
+		xhash_delete(intern_table, istr->str, istr->len);
+		istr->magic = ~MAGIC_INTERN_STR;
+		xfree(istr);
+	}
+	slurm_mutex_unlock(&intern_mutex);
+}
@@ -0,0 +1,74 @@
+/*****************************************************************************\
+ *  str_intern.h - reference counted shared strings
+ *****************************************************************************
+ *  Copyright (C) 2024 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#ifndef _STR_INTERN_H
+#define _STR_INTERN_H
+
+/*
+ * Interned strings are shared, reference counted, read-only copies of
+ * strings that are repeated across many records, such as the working
+ * directory or output paths of every task of a job array.
+ *
+ * WARNING: Interned strings must never be modified in place, passed to
+ * xfree() or xrealloc(). Release them with FREE_NULL_INTERNED().
+ */
+
+/*
+ * Get a reference to the interned copy of str
+ * IN str - string to intern (may be NULL)
+ * RET shared copy of str or NULL if str is NULL
+ */
+extern char *str_intern(const char *str);
+
+/*
+ * Get another reference to an already interned string
+ * IN str - string previously returned by str_intern() (may be NULL)
+ * RET str
+ */
+extern char *str_intern_ref(char *str);
+
+/*
+ * Release a reference to an interned string
+ * IN str - string previously returned by str_intern() (may be NULL)
+ */
+extern void str_intern_release(char *str);
+
+#define FREE_NULL_INTERNED(_X)			\
+	do {					\
+		str_intern_release(_X);		\
+		_X = NULL;			\
+	} while (0)
+
+#endif
@@ -41,6 +41,7 @@
 #include <stdio.h>
 #include <errno.h>
 #include <string.h>
+#include <sys/uio.h>
 
 #include "src/common/write_labelled_message.h"
 #include "slurm/slurm_errno.h"
@@ -48,10 +49,13 @@
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
+/* Lines gathered into a single writev() */
+#define MAX_IOV_LINES 128
+
 static char *_build_label(int task_id, int task_id_width,
 			  uint32_t het_job_offset,
 			  uint32_t het_job_task_offset);
-static int _write_line(int fd, char *prefix, char *suffix, void *buf, int len);
+static int _write_iov(int fd, struct iovec *iov, int iovcnt);
 
 /*
  * fd             is the file descriptor to write to
@@ -77,44 +81,64 @@ extern int write_labelled_message(int fd, void *buf, int len, int task_id,
 				  uint32_t het_job_task_offset,
 				  bool label, int task_id_width)
 {
+	struct iovec iov[(MAX_IOV_LINES * 2) + 1];
 	void *start, *end;
-	char *prefix = NULL, *suffix = NULL;
+	char *prefix = NULL;
 	int remaining = len;
-	int written = 0;
-	int line_len;
+	int written = 0, pending = 0;
+	int iovcnt = 0;
+	int line_len, prefix_len = 0;
 	int rc = -1;
 
-	if (label) {
-		prefix = _build_label(task_id, task_id_width, het_job_offset,
-				      het_job_task_offset);
+	if (len <= 0)
+		return rc;
+
+	/* Nothing to add to the data, write it as is */
+	if (!label) {
+		iov[0].iov_base = buf;
+		iov[0].iov_len = len;
+		if (_write_iov(fd, iov, 1) < 0)
+			return rc;
+		return len;
 	}
 
+	prefix = _build_label(task_id, task_id_width, het_job_offset,
+			      het_job_task_offset);
+	prefix_len = strlen(prefix);
+
+	/*
+	 * Gather label and line pairs so that many lines go out in one
+	 * writev(). Each line stays whole, so output from multiple hetjob
+	 * components is not interleaved within a line.
+	 */
 	while (remaining > 0) {
-		start = buf + written;
+		start = buf + written + pending;
 		end = memchr(start, '\n', remaining);
-		if (end == NULL) { /* no newline found */
-			if (label)
-				suffix = "\n";
-			rc = _write_line(fd, prefix, suffix, start, remaining);
-			if (rc <= 0) {
-				goto done;
-			} else {
-				remaining -= rc;
-				written += rc;
-			}
-		} else {
+		if (end)
 			line_len = (int)(end - start) + 1;
-			rc = _write_line(fd, prefix, suffix, start, line_len);
-			if (rc <= 0) {
-				goto done;
-			} else {
-				remaining -= rc;
-				written += rc;
-			}
+		else
+			line_len = remaining;
+
+		iov[iovcnt].iov_base = prefix;
+		iov[iovcnt++].iov_len = prefix_len;
+		iov[iovcnt].iov_base = start;
+		iov[iovcnt++].iov_len = line_len;
+		if (!end) { /* no newline found */
+			iov[iovcnt].iov_base = "\n";
+			iov[iovcnt++].iov_len = 1;
 		}
+		pending += line_len;
+		remaining -= line_len;
 
+		if ((iovcnt >= (MAX_IOV_LINES * 2)) || (remaining <= 0)) {
+			if ((rc = _write_iov(fd, iov, iovcnt)) < 0)
+				break;
+			written += pending;
+			pending = 0;
+			iovcnt = 0;
+		}
 	}
-done:
+
 	xfree(prefix);
 	if (written > 0)
 		return written;
@@ -148,50 +172,32 @@ static char *_build_label(int task_id, int task_id_width,
 
 /*
  * Blocks until write is complete, regardless of the file descriptor being in
- * non-blocking mode.
- * I/O from multiple hetjob components may be present, so add prefix/suffix to
- * buffer before issuing write to avoid interleaved output from multiple
- * components.
+ * non-blocking mode. iov is modified on partial writes.
  */
-static int _write_line(int fd, char *prefix, char *suffix, void *buf, int len)
+static int _write_iov(int fd, struct iovec *iov, int iovcnt)
 {
-	int left, n, pre = 0, post = 0;
-	void *ptr, *tmp = NULL;
-
-	if (prefix || suffix) {
-		if (prefix)
-			pre = strlen(prefix);
-		if (suffix)
-			post = strlen(suffix);
-		tmp = xmalloc(pre + len + post);
-		if (prefix)
-			memcpy(tmp, prefix, pre);
-		memcpy(tmp + pre, buf, len);
-		if (suffix)
-			memcpy(tmp + pre + len, suffix, post);
-		ptr = tmp;
-		left = pre + len + post;
-	} else {
-		ptr = buf;
-		left = len;
-	}
+	ssize_t n;
 
-	while (left > 0) {
-	again:
-		if ((n = write(fd, ptr, left)) < 0) {
+	while (iovcnt > 0) {
+		if ((n = writev(fd, iov, iovcnt)) < 0) {
 			if (errno == EINTR)
-				goto again;
+				continue;
 			if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
-				debug3("  got EAGAIN in _write_line");
-				goto again;
+				debug3("  got EAGAIN in _write_iov");
+				continue;
 			}
-			len = -1;
-			break;
+			return -1;
+		}
+		while ((iovcnt > 0) && (n >= iov->iov_len)) {
+			n -= iov->iov_len;
+			iov++;
+			iovcnt--;
+		}
+		if (iovcnt > 0) {
+			iov->iov_base += n;
+			iov->iov_len -= n;
 		}
-		left -= n;
-		ptr += n;
 	}
-	xfree(tmp);
 
-	return len;
+	return 0;
 }
@@ -643,6 +643,14 @@ extern buf_t *conmgr_fd_shadow_in_buffer(const conmgr_fd_t *con);
 extern void conmgr_fd_mark_consumed_in_buffer(const conmgr_fd_t *con,
 					      size_t bytes);
 
+/*
+ * Call on_data() again for data already in the input buffer
+ * Used after on_data() consumed nothing to wait on something other than
+ * new incoming data. Must be called from work of the connection.
+ * IN con - connection to process input of
+ */
+extern void conmgr_fd_retry_on_data(conmgr_fd_t *con);
+
 /*
  * Transfer incoming data into a buf_t
  * IN con - connection to query data
@@ -431,6 +431,17 @@ extern void conmgr_fd_mark_consumed_in_buffer(const conmgr_fd_t *con,
 	set_buf_offset(con->in, offset);
 }
 
+extern void conmgr_fd_retry_on_data(conmgr_fd_t *con)
+{
+	xassert(con->magic == MAGIC_CON_MGR_FD);
+	xassert(con->work_active);
+
+	slurm_mutex_lock(&mgr.mutex);
+	con->on_data_tried = false;
+	EVENT_SIGNAL(&mgr.watch_sleep);
+	slurm_mutex_unlock(&mgr.mutex);
+}
+
 extern int conmgr_fd_xfer_in_buffer(const conmgr_fd_t *con,
 				    buf_t **buffer_ptr)
 {
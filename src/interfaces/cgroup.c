@@ -73,6 +73,8 @@ typedef struct {
 					 stepd_step_rec_t *step, pid_t pid,
 					 uint32_t task_id);
 	cgroup_acct_t *(*task_get_acct_data) (uint32_t taskid);
+	int	(*step_start_acct_monitor) (void (*callback)(void));
+	void	(*step_stop_acct_monitor) (void);
 	long int (*get_acct_units)	(void);
 	bool (*has_feature) (cgroup_ctl_feature_t f);
 } slurm_ops_t;
@@ -100,6 +102,8 @@ static const char *syms[] = {
 	"cgroup_p_step_stop_oom_mgr",
 	"cgroup_p_task_addto",
 	"cgroup_p_task_get_acct_data",
+	"cgroup_p_step_start_acct_monitor",
+	"cgroup_p_step_stop_acct_monitor",
 	"cgroup_p_get_acct_units",
 	"cgroup_p_has_feature",
 };
@@ -926,6 +930,26 @@ extern cgroup_acct_t *cgroup_g_task_get_acct_data(uint32_t taskid)
 	return (*(ops.task_get_acct_data))(taskid);
 }
 
+extern int cgroup_g_step_start_acct_monitor(void (*callback)(void))
+{
+	xassert(plugin_inited != PLUGIN_NOT_INITED);
+
+	if (plugin_inited == PLUGIN_NOOP)
+		return ESLURM_NOT_SUPPORTED;
+
+	return (*(ops.step_start_acct_monitor))(callback);
+}
+
+extern void cgroup_g_step_stop_acct_monitor(void)
+{
+	xassert(plugin_inited != PLUGIN_NOT_INITED);
+
+	if (plugin_inited == PLUGIN_NOOP)
+		return;
+
+	(*(ops.step_stop_acct_monitor))();
+}
+
 extern long int cgroup_g_get_acct_units(void)
 {
 	xassert(plugin_inited != PLUGIN_NOT_INITED);
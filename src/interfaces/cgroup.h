@@ -391,6 +391,23 @@ extern int cgroup_g_task_addto(cgroup_ctl_type_t sub, stepd_step_rec_t *step,
  */
 extern cgroup_acct_t *cgroup_g_task_get_acct_data(uint32_t taskid);
 
+/*
+ * Start a thread watching the step's memory.events and cpu.pressure files
+ * which calls callback whenever a memory event is raised or the step stalls
+ * on cpu, so accounting can be gathered right then instead of at the next
+ * interval.
+ *
+ * IN callback - function called from the monitoring thread.
+ * RET SLURM_SUCCESS if the monitoring thread is started, ESLURM_NOT_SUPPORTED
+ *     if the plugin cannot watch these events, SLURM_ERROR otherwise.
+ */
+extern int cgroup_g_step_start_acct_monitor(void (*callback)(void));
+
+/*
+ * Stop the thread started by cgroup_g_step_start_acct_monitor(), if any.
+ */
+extern void cgroup_g_step_stop_acct_monitor(void);
+
 /*
  * Return conversion units used for stats gathered from cpuacct.
  * Dividing the provided data by this number will give seconds.
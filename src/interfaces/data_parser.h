@@ -470,6 +470,11 @@ typedef enum {
 	DATA_PARSER_OPENAPI_JOB_SUBMIT_RESPONSE_PTR, /* job_submit_response_t* */
 	DATA_PARSER_JOB_SUBMIT_REQ, /* job_submit_request_t */
 	DATA_PARSER_JOB_SUBMIT_REQ_PTR, /* job_submit_request_t */
+	DATA_PARSER_JOB_SUBMIT_RESPONSE_MSG_LIST, /* list of submit_response_msg_t* */
+	DATA_PARSER_JOB_SUBMIT_BATCH_REQ, /* openapi_job_submit_batch_request_t */
+	DATA_PARSER_JOB_SUBMIT_BATCH_REQ_PTR, /* openapi_job_submit_batch_request_t* */
+	DATA_PARSER_OPENAPI_JOB_SUBMIT_BATCH_RESP, /* openapi_job_submit_batch_response_t */
+	DATA_PARSER_OPENAPI_JOB_SUBMIT_BATCH_RESP_PTR, /* openapi_job_submit_batch_response_t* */
 	DATA_PARSER_OPENAPI_JOB_ALLOC_RESP, /* openapi_job_alloc_response_t */
 	DATA_PARSER_OPENAPI_JOB_ALLOC_RESP_PTR, /* openapi_job_alloc_response_t* */
 	DATA_PARSER_JOB_ALLOC_REQ, /* openapi_job_alloc_request_t */
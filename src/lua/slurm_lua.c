@@ -45,7 +45,9 @@
 #include <unistd.h>
 
 #include "src/common/log.h"
+#include "src/common/macros.h"
 #include "src/common/parse_time.h"
+#include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 #include "src/lua/slurm_lua.h"
 
@@ -53,6 +55,89 @@ static void *lua_handle = NULL;
 
 #ifdef HAVE_LUA
 
+/*
+ * Compiled chunk of the last script loaded. Every lua state loaded from the
+ * same unmodified script reuses it instead of parsing the source again.
+ */
+typedef struct {
+	char *path;
+	time_t mtime;
+	off_t size;
+	char *data;
+	size_t len;
+} chunk_cache_t;
+
+static pthread_mutex_t chunk_lock = PTHREAD_MUTEX_INITIALIZER;
+static chunk_cache_t chunk_cache = { 0 };
+
+static void _chunk_cache_free(void)
+{
+	slurm_mutex_lock(&chunk_lock);
+	xfree(chunk_cache.path);
+	xfree(chunk_cache.data);
+	memset(&chunk_cache, 0, sizeof(chunk_cache));
+	slurm_mutex_unlock(&chunk_lock);
+}
+
+static int _chunk_writer(lua_State *L, const void *p, size_t sz, void *ud)
+{
+	chunk_cache_t *chunk = ud;
+
+	xrealloc_nz(chunk->data, (chunk->len + sz));
+	memcpy(chunk->data + chunk->len, p, sz);
+	chunk->len += sz;
+
+	return 0;
+}
+
+/*
+ * Load script_path as a function on top of the stack of L, using the cached
+ * compiled chunk when the script has not changed since it was cached.
+ */
+static int _load_chunk(lua_State *L, const char *script_path,
+		       const struct stat *st)
+{
+	chunk_cache_t chunk = { 0 };
+	int rc;
+
+	slurm_mutex_lock(&chunk_lock);
+	if (chunk_cache.data && (chunk_cache.mtime == st->st_mtime) &&
+	    (chunk_cache.size == st->st_size) &&
+	    !xstrcmp(chunk_cache.path, script_path)) {
+		rc = luaL_loadbuffer(L, chunk_cache.data, chunk_cache.len,
+				     script_path);
+		slurm_mutex_unlock(&chunk_lock);
+		return rc;
+	}
+	slurm_mutex_unlock(&chunk_lock);
+
+	if ((rc = luaL_loadfile(L, script_path)))
+		return rc;
+
+	/* Keep debug info so script errors still report line numbers */
+#if LUA_VERSION_NUM >= 503
+	rc = lua_dump(L, _chunk_writer, &chunk, 0);
+#else
+	rc = lua_dump(L, _chunk_writer, &chunk);
+#endif
+	if (rc) {
+		xfree(chunk.data);
+		return SLURM_SUCCESS;
+	}
+
+	chunk.path = xstrdup(script_path);
+	chunk.mtime = st->st_mtime;
+	chunk.size = st->st_size;
+
+	slurm_mutex_lock(&chunk_lock);
+	xfree(chunk_cache.path);
+	xfree(chunk_cache.data);
+	chunk_cache = chunk;
+	slurm_mutex_unlock(&chunk_lock);
+
+	return SLURM_SUCCESS;
+}
+
 static int _setup_stringarray(lua_State *L, int limit, char **data)
 {
 	/*
@@ -712,7 +797,7 @@ extern int slurm_lua_loadscript(lua_State **L, const char *plugin,
 	}
 
 	luaL_openlibs(new);
-	if (luaL_loadfile(new, script_path)) {
+	if (_load_chunk(new, script_path, &st)) {
 		if (curr) {
 			error("%s: %s: %s, using previous script",
 			      plugin, script_path,
@@ -859,6 +944,9 @@ extern int slurm_lua_init(void)
  */
 extern void slurm_lua_fini(void)
 {
+#ifdef HAVE_LUA
+	_chunk_cache_free();
+#endif
 	if (lua_handle)
 		dlclose(lua_handle);
 }
@@ -67,12 +67,21 @@
 #include "src/slurmd/common/privileges.h"
 #include "hdf5_api.h"
 
-#define HDF5_CHUNK_SIZE 10
+/* Number of samples per chunk, samples are also appended in blocks of this */
+#define HDF5_CHUNK_SIZE 128
 /* Compression level, a value of 0 through 9. Level 0 is faster but offers the
  * least compression; level 9 is slower but offers maximum compression.
  * A setting of -1 indicates that no compression is desired. */
-/* TODO: Make this configurable with a parameter */
-#define HDF5_COMPRESS 0
+#define HDF5_COMPRESS 1
+
+/* H5_VERSION_GE was not added until 1.8.7 */
+#ifndef H5_VERSION_GE
+#define H5_VERSION_GE(Maj,Min,Rel) \
+	(((H5_VERS_MAJOR==Maj) && (H5_VERS_MINOR==Min) &&		\
+	  (H5_VERS_RELEASE>=Rel)) ||					\
+	 ((H5_VERS_MAJOR==Maj) && (H5_VERS_MINOR>Min)) ||		\
+	 (H5_VERS_MAJOR>Maj))
+#endif
 
 /*
  * These variables are required by the generic plugin interface.  If they
@@ -104,11 +113,15 @@ const char plugin_type[] = "acct_gather_profile/hdf5";
 const uint32_t plugin_version = SLURM_VERSION_NUMBER;
 
 typedef struct {
+	uint32_t chunk_size;
+	int compress;
 	char *dir;
 	uint32_t def;
 } slurm_hdf5_conf_t;
 
 typedef struct {
+	uint8_t *buf;	/* samples not yet appended to the table */
+	size_t buf_cnt;
 	hid_t  table_id;
 	size_t type_size;
 } table_t;
@@ -137,10 +150,71 @@ static size_t   tables_cur_len = 0;
 
 static void _reset_slurm_profile_conf(void)
 {
+	hdf5_conf.chunk_size = HDF5_CHUNK_SIZE;
+	hdf5_conf.compress = HDF5_COMPRESS;
 	xfree(hdf5_conf.dir);
 	hdf5_conf.def = ACCT_GATHER_PROFILE_NONE;
 }
 
+/*
+ * Create a packet table, an extendible dataset of hdf5_conf.chunk_size
+ * samples per chunk.
+ */
+static hid_t _create_table(hid_t parent, const char *name, hid_t dtype_id)
+{
+#if H5_VERSION_GE(1,10,0)
+	hid_t plist_id, table_id;
+	hsize_t dims = hdf5_conf.chunk_size;
+
+	if ((plist_id = H5Pcreate(H5P_DATASET_CREATE)) < 0)
+		return -1;
+
+	/* Filters need the chunked layout to be set before H5PTcreate() */
+	if (H5Pset_chunk(plist_id, 1, &dims) < 0) {
+		H5Pclose(plist_id);
+		return -1;
+	}
+
+	/*
+	 * Samples of a series change slowly, so grouping the bytes of each
+	 * field with the shuffle filter lets deflate do far better.
+	 */
+	if ((hdf5_conf.compress >= 0) &&
+	    ((H5Pset_shuffle(plist_id) < 0) ||
+	     (H5Pset_deflate(plist_id, hdf5_conf.compress) < 0))) {
+		H5Pclose(plist_id);
+		return -1;
+	}
+
+	table_id = H5PTcreate(parent, name, dtype_id, hdf5_conf.chunk_size,
+			      plist_id);
+	H5Pclose(plist_id);
+
+	return table_id;
+#else
+	return H5PTcreate_fl(parent, name, dtype_id, hdf5_conf.chunk_size,
+			     hdf5_conf.compress);
+#endif
+}
+
+/* Append the buffered samples of a table to it */
+static int _flush_table(table_t *ds)
+{
+	int rc = SLURM_SUCCESS;
+
+	if (!ds->buf_cnt)
+		return rc;
+
+	if (H5PTappend(ds->table_id, ds->buf_cnt, ds->buf) < 0) {
+		error("PROFILE: Impossible to add %zu samples to the table",
+		      ds->buf_cnt);
+		rc = SLURM_ERROR;
+	}
+	ds->buf_cnt = 0;
+
+	return rc;
+}
+
 static uint32_t _determine_profile(void)
 {
 	uint32_t profile;
@@ -240,6 +314,8 @@ extern int init(void)
 
 extern int fini(void)
 {
+	for (size_t i = 0; i < tables_cur_len; i++)
+		xfree(tables[i].buf);
 	xfree(tables);
 	xfree(groups);
 	xfree(hdf5_conf.dir);
@@ -250,6 +326,8 @@ extern void acct_gather_profile_p_conf_options(s_p_options_t **full_options,
 					       int *full_options_cnt)
 {
 	s_p_options_t options[] = {
+		{"ProfileHDF5ChunkSize", S_P_UINT32},
+		{"ProfileHDF5Compress", S_P_LONG},
 		{"ProfileHDF5Dir", S_P_STRING},
 		{"ProfileHDF5Default", S_P_STRING},
 		{NULL} };
@@ -261,8 +339,21 @@ extern void acct_gather_profile_p_conf_options(s_p_options_t **full_options,
 extern void acct_gather_profile_p_conf_set(s_p_hashtbl_t *tbl)
 {
 	char *tmp = NULL;
+	long compress;
 	_reset_slurm_profile_conf();
 	if (tbl) {
+		if (s_p_get_uint32(&hdf5_conf.chunk_size,
+				   "ProfileHDF5ChunkSize", tbl) &&
+		    !hdf5_conf.chunk_size)
+			fatal("ProfileHDF5ChunkSize must be at least 1");
+
+		if (s_p_get_long(&compress, "ProfileHDF5Compress", tbl)) {
+			if ((compress < -1) || (compress > 9))
+				fatal("ProfileHDF5Compress can not be set to %ld, please specify a value from -1 to 9",
+				      compress);
+			hdf5_conf.compress = compress;
+		}
+
 		s_p_get_string(&hdf5_conf.dir, "ProfileHDF5Dir", tbl);
 
 		if (s_p_get_string(&tmp, "ProfileHDF5Default", tbl)) {
@@ -434,7 +525,9 @@ extern int acct_gather_profile_p_node_step_end(void)
 
 	/* close tables */
 	for (i = 0; i < tables_cur_len; ++i) {
+		_flush_table(&tables[i]);
 		H5PTclose(tables[i].table_id);
+		xfree(tables[i].buf);
 	}
 	/* close groups */
 	for (i = 0; i < groups_len; ++i) {
@@ -570,8 +663,7 @@ extern int acct_gather_profile_p_create_dataset(
 	/* create the table */
 	if (parent < 0)
 		parent = gid_node; /* default parent is the node group */
-	table_id = H5PTcreate_fl(parent, name, dtype_id, HDF5_CHUNK_SIZE,
-	                         HDF5_COMPRESS);
+	table_id = _create_table(parent, name, dtype_id);
 	if (table_id < 0) {
 		error("PROFILE: Impossible to create the table %s", name);
 		H5Tclose(dtype_id);
@@ -590,6 +682,8 @@ extern int acct_gather_profile_p_create_dataset(
 	/* reserve a new table */
 	tables[tables_cur_len].table_id  = table_id;
 	tables[tables_cur_len].type_size = type_size;
+	tables[tables_cur_len].buf = xcalloc(hdf5_conf.chunk_size, type_size);
+	tables[tables_cur_len].buf_cnt = 0;
 	++tables_cur_len;
 
 	return tables_cur_len - 1;
@@ -599,7 +693,7 @@ extern int acct_gather_profile_p_add_sample_data(int table_id, void *data,
 						 time_t sample_time)
 {
 	table_t *ds = &tables[table_id];
-	uint8_t send_data[ds->type_size];
+	uint8_t *send_data;
 	int header_size = 0;
 	debug("acct_gather_profile_p_add_sample_data %d", table_id);
 
@@ -622,6 +716,12 @@ extern int acct_gather_profile_p_add_sample_data(int table_id, void *data,
 	if (g_profile_running <= ACCT_GATHER_PROFILE_NONE)
 		return SLURM_ERROR;
 
+	/*
+	 * Samples are buffered and appended a whole chunk at a time, which is
+	 * when the library would write them out anyway.
+	 */
+	send_data = ds->buf + (ds->buf_cnt * ds->type_size);
+
 	/* prepend timestampe and relative time */
 	((uint64_t *)send_data)[0] = difftime(sample_time, step_start_time);
 	header_size += sizeof(uint64_t);
@@ -630,8 +730,9 @@ extern int acct_gather_profile_p_add_sample_data(int table_id, void *data,
 
 	memcpy(send_data + header_size, data, ds->type_size - header_size);
 
-	/* append the record to the table */
-	if (H5PTappend(ds->table_id, 1, send_data) < 0) {
+	/* append the block of records to the table once full */
+	if ((++ds->buf_cnt == hdf5_conf.chunk_size) &&
+	    (_flush_table(ds) != SLURM_SUCCESS)) {
 		error("PROFILE: Impossible to add data to the table %d; "
 		      "maybe the table has not been created?", table_id);
 		return SLURM_ERROR;
@@ -642,6 +743,9 @@ extern int acct_gather_profile_p_add_sample_data(int table_id, void *data,
 
 extern void acct_gather_profile_p_conf_values(list_t **data)
 {
+	add_key_pair(*data, "ProfileHDF5ChunkSize", "%u",
+		     hdf5_conf.chunk_size);
+	add_key_pair(*data, "ProfileHDF5Compress", "%d", hdf5_conf.compress);
 	add_key_pair(*data, "ProfileHDF5Dir", "%s", hdf5_conf.dir);
 	add_key_pair(*data, "ProfileHDF5Default", "%s",
 		     acct_gather_profile_to_string(hdf5_conf.def));
@@ -52,15 +52,20 @@
 #include <float.h>
 #include <getopt.h>
 #include <limits.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <unistd.h>
 
+#include "src/common/fd.h"
+#include "src/common/macros.h"
 #include "src/common/uid.h"
 #include "src/common/read_config.h"
 #include "src/common/proc_args.h"
+#include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 #include "src/interfaces/acct_gather_profile.h"
 #include "src/interfaces/jobacct_gather.h"
@@ -73,6 +78,8 @@ const char plugin_type[] = "";
 #define MAX_GROUP_NAME 64
 // #define MAX_DATASET_NAME 64
 
+#define DEFAULT_THREADS 4
+
 // #define ATTR_NODENAME "Node Name"
 // #define ATTR_STARTTIME "Start Time"
 #define ATTR_NSTEPS "Number of Steps"
@@ -134,11 +141,23 @@ typedef struct table {
 
 typedef struct {
 	char *file_name;
+	char *image;		/* file contents read ahead of the merge */
+	bool image_done;	/* read ahead finished, image may still be NULL */
+	size_t image_size;
 	int job_id;
 	char *node_name;
 	int step_id;
 } sh5util_file_t;
 
+/* State shared by the read ahead threads of _merge_step_files() */
+static sh5util_file_t **read_files = NULL;
+static int read_files_cnt = 0;
+static int read_next = 0;
+static int read_merged = 0;
+static char *read_dir = NULL;
+static pthread_mutex_t read_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t read_cond = PTHREAD_COND_INITIALIZER;
+
 static FILE* output_file;
 static bool group_mode = false;
 static const char *current_step;
@@ -188,6 +207,8 @@ static void _help_msg(void)
 	       " -p, --profiledir     Profile directory location where node-step files exist\n"
 	       "		               default is what is set in acct_gather.conf\n"
 	       " -S, --savefiles      Don't remove node-step files after merging them \n"
+	       " -T, --threads        Number of threads reading node-step files ahead of\n"
+	       "                      the merge, 0 to read them while merging (default 4)\n"
 	       " --user               User who profiled job. (Handy for root user, defaults to \n"
 	       "		               user running this command.)\n"
 	       " --usage              Display brief usage message\n");
@@ -255,6 +276,7 @@ static void _destroy_sh5util_file(void *arg)
 	object = (sh5util_file_t *)arg;
 
 	xfree(object->file_name);
+	xfree(object->image);
 	xfree(object->node_name);
 	xfree(object);
 }
@@ -332,6 +354,7 @@ static void _init_opts(void)
 	params.job_id = -1;
 	params.mode = SH5UTIL_MODE_MERGE;
 	params.step_id = -1;
+	params.threads = DEFAULT_THREADS;
 }
 
 static int _set_options(const int argc, char **argv)
@@ -356,6 +379,7 @@ static int _set_options(const int argc, char **argv)
 		{"profiledir", required_argument, 0, 'p'},
 		{"series", required_argument, 0, 's'},
 		{"savefiles", no_argument, 0, 'S'},
+		{"threads", required_argument, 0, 'T'},
 		{"usage", no_argument, 0, 'U'},
 		{"user", required_argument, 0, 'u'},
 		{"verbose", no_argument, 0, 'v'},
@@ -375,7 +399,7 @@ static int _set_options(const int argc, char **argv)
 
 	_init_opts();
 
-	while ((cc = getopt_long(argc, argv, "d:Ehi:Ij:l:LN:o:p:s:Su:UvV",
+	while ((cc = getopt_long(argc, argv, "d:Ehi:Ij:l:LN:o:p:s:ST:u:UvV",
 	                         long_options, &option_index)) != EOF) {
 		switch (cc) {
 		case 'd':
@@ -432,6 +456,14 @@ static int _set_options(const int argc, char **argv)
 		case 'S':
 			params.keepfiles = 1;
 			break;
+		case 'T':
+			params.threads = strtol(optarg, &next_str, 10);
+			if ((params.threads < 0) || next_str[0]) {
+				error("Bad value for --threads=\"%s\"",
+				      optarg);
+				return -1;
+			}
+			break;
 		case 'u':
 			if (uid_from_string(optarg, &u) < 0) {
 				error("No such user --uid=\"%s\"",
@@ -541,7 +573,18 @@ static int _merge_node_step_data(char* file_name, hid_t jgid_nodes,
 	char *group_name = NULL;
 	int rc = SLURM_SUCCESS;
 
-	fid_nodestep = H5Fopen(file_name, H5F_ACC_RDONLY, H5P_DEFAULT);
+	/*
+	 * The image stays owned by sh5util_file, HDF5 reads from it in place
+	 * instead of issuing many small reads against the profile directory.
+	 */
+	if (sh5util_file->image)
+		fid_nodestep = H5LTopen_file_image(
+			sh5util_file->image, sh5util_file->image_size,
+			(H5LT_FILE_IMAGE_DONT_COPY |
+			 H5LT_FILE_IMAGE_DONT_RELEASE));
+	else
+		fid_nodestep = H5Fopen(file_name, H5F_ACC_RDONLY,
+				       H5P_DEFAULT);
 	if (fid_nodestep < 0) {
 		error("Failed to open %s",file_name);
 		return SLURM_ERROR;
@@ -571,6 +614,80 @@ endit:
 	return rc;
 }
 
+/* Read a whole node-step file into memory, returns NULL on error */
+static char *_read_file_image(const char *path, size_t *size)
+{
+	struct stat st;
+	char *image = NULL;
+	size_t offset = 0;
+	ssize_t len;
+	int fd;
+
+	if ((fd = open(path, O_RDONLY | O_CLOEXEC)) < 0)
+		return NULL;
+
+	if ((fstat(fd, &st) < 0) || (st.st_size <= 0))
+		goto fail;
+
+	image = xmalloc_nz(st.st_size);
+	while (offset < st.st_size) {
+		len = read(fd, image + offset, st.st_size - offset);
+		if (len < 0) {
+			if ((errno == EINTR) || (errno == EAGAIN))
+				continue;
+			goto fail;
+		}
+		if (!len)
+			goto fail;
+		offset += len;
+	}
+
+	close(fd);
+	*size = offset;
+	return image;
+
+fail:
+	debug("%s: unable to read %s, it will be opened directly: %m",
+	      __func__, path);
+	close(fd);
+	xfree(image);
+	return NULL;
+}
+
+/*
+ * Read node-step files in merge order while the main thread copies the
+ * previous ones into the job file. HDF5 itself is only used by the main
+ * thread. At most params.threads * 2 files are held in memory.
+ */
+static void *_read_ahead(void *arg)
+{
+	sh5util_file_t *sh5util_file;
+	char *path;
+
+	slurm_mutex_lock(&read_mutex);
+	while (read_next < read_files_cnt) {
+		if (read_next >= (read_merged + (params.threads * 2))) {
+			slurm_cond_wait(&read_cond, &read_mutex);
+			continue;
+		}
+		sh5util_file = read_files[read_next++];
+		slurm_mutex_unlock(&read_mutex);
+
+		path = xstrdup_printf("%s/%s", read_dir,
+				      sh5util_file->file_name);
+		sh5util_file->image = _read_file_image(
+			path, &sh5util_file->image_size);
+		xfree(path);
+
+		slurm_mutex_lock(&read_mutex);
+		sh5util_file->image_done = true;
+		slurm_cond_broadcast(&read_cond);
+	}
+	slurm_mutex_unlock(&read_mutex);
+
+	return NULL;
+}
+
 /* Look for step and node files and merge them together into one job file */
 static int _merge_step_files(void)
 {
@@ -592,9 +709,9 @@ static int _merge_step_files(void)
 	int last_step = -1, step_cnt = 0;
 	int job_id;
 	int rc = SLURM_SUCCESS;
-	list_itr_t *itr;
 	list_t *file_list = NULL;
 	sh5util_file_t *sh5util_file = NULL;
+	pthread_t *threads = NULL;
 
 	step_dir = xstrdup_printf("%s/%s", params.dir, params.user);
 
@@ -676,11 +793,34 @@ static int _merge_step_files(void)
 	/* sort the files so they are in step order */
 	list_sort(file_list, (ListCmpF) _sh5util_sort_files_dec);
 
+	read_files_cnt = list_count(file_list);
+	read_files = xcalloc(read_files_cnt, sizeof(*read_files));
+	for (int i = 0; (sh5util_file = list_pop(file_list)); i++)
+		read_files[i] = sh5util_file;
+	read_next = 0;
+	read_merged = 0;
+	read_dir = step_dir;
+
+	if (params.threads) {
+		threads = xcalloc(params.threads, sizeof(*threads));
+		for (int i = 0; i < params.threads; i++)
+			slurm_thread_create(&threads[i], _read_ahead, NULL);
+	}
+
 	node_cnt = 0;
-	itr = list_iterator_create(file_list);
-	while ((sh5util_file = list_next(itr))) {
+	for (int i = 0; i < read_files_cnt; i++) {
+		sh5util_file = read_files[i];
 		//info("got file of %s", sh5util_file->file_name);
 
+		if (params.threads) {
+			slurm_mutex_lock(&read_mutex);
+			read_merged = i;
+			slurm_cond_broadcast(&read_cond);
+			while (!sh5util_file->image_done)
+				slurm_cond_wait(&read_cond, &read_mutex);
+			slurm_mutex_unlock(&read_mutex);
+		}
+
 		/* make a group for each step */
 		if (sh5util_file->step_id != last_step) {
 			last_step = sh5util_file->step_id;
@@ -735,13 +875,22 @@ static int _merge_step_files(void)
 			step_path, jgid_nodes, sh5util_file);
 		xfree(step_path);
 
+		xfree(sh5util_file->image);
 	}
-	list_iterator_destroy(itr);
 
 	put_int_attribute(fid_job, ATTR_NSTEPS, step_cnt);
 
 
 endit:
+	if (threads) {
+		for (int i = 0; i < params.threads; i++)
+			slurm_thread_join(threads[i]);
+		xfree(threads);
+	}
+	for (int i = 0; i < read_files_cnt; i++)
+		_destroy_sh5util_file(read_files[i]);
+	xfree(read_files);
+	read_files_cnt = 0;
 	FREE_NULL_LIST(file_list);
 	xfree(file_name);
 	xfree(step_dir);
@@ -59,6 +59,7 @@ typedef struct {
 	char *series;
 	char *data_item;
 	int step_id;
+	int threads;
 	char *user;
 	int verbose;
 } sh5util_opts_t;
@@ -45,6 +45,8 @@
  *  Copyright (C) 2002 The Regents of the University of California.
  \*****************************************************************************/
 
+#include "config.h"
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/types.h>
@@ -55,8 +57,13 @@
 #include <inttypes.h>
 #include <unistd.h>
 #include <math.h>
+#include <pthread.h>
 #include <curl/curl.h>
 
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
 #include "src/common/slurm_xlator.h"
 #include "src/common/fd.h"
 #include "src/common/macros.h"
@@ -65,11 +72,16 @@
 #include "src/common/slurm_protocol_defs.h"
 #include "src/common/slurm_time.h"
 #include "src/common/timers.h"
+#include "src/common/xhash.h"
 #include "src/common/xstring.h"
 #include "src/interfaces/proctrack.h"
 
+#define DEFAULT_INFLUXDB_BATCHES 16
 #define DEFAULT_INFLUXDB_TIMEOUT 10
 
+#define INFLUXDB_OVERFLOW_DROP 0
+#define INFLUXDB_OVERFLOW_AGGREGATE 1
+
 /*
  * These variables are required by the generic plugin interface.  If they
  * are not found in the plugin, the plugin loader will ignore it.
@@ -100,9 +112,12 @@ const char plugin_type[] = "acct_gather_profile/influxdb";
 const uint32_t plugin_version = SLURM_VERSION_NUMBER;
 
 typedef struct {
+	uint32_t batches;
+	bool compress;
 	char *host;
 	char *database;
 	uint32_t def;
+	uint32_t overflow;
 	char *password;
 	char *rt_policy;
 	uint32_t timeout;
@@ -127,12 +142,46 @@ union data_t{
 	double	 d;
 };
 
+/* Line protocol batch waiting in the send ring */
+typedef struct {
+	char *data;
+	int len;
+} batch_t;
+
+/* Last line of one series, used when aggregating queued batches */
+typedef struct {
+	const char *key;
+	uint32_t key_len;
+	const char *line;
+} series_t;
+
+typedef struct {
+	xhash_t *series_hash;
+	char *merged;
+	char *pos;
+} merge_args_t;
+
 static slurm_influxdb_conf_t influxdb_conf;
 static uint32_t g_profile_running = ACCT_GATHER_PROFILE_NOT_SET;
 static stepd_step_rec_t *g_job = NULL;
 
+/*
+ * Samples are appended to datastr. Once it is full it is moved to the batch
+ * ring, from which _sender_thread posts it, so a slow or unreachable
+ * InfluxDB never holds up the profiling thread. All of these are protected
+ * by send_mutex.
+ */
 static char *datastr = NULL;
 static int datastrlen = 0;
+static batch_t *batch_ring = NULL;
+static uint32_t batch_head = 0;
+static uint32_t batch_cnt = 0;
+static uint64_t dropped_batches = 0;
+static bool send_shutdown = false;
+static time_t send_deadline = 0;
+static pthread_t send_thread = 0;
+static pthread_mutex_t send_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t send_cond = PTHREAD_COND_INITIALIZER;
 
 static table_t *tables = NULL;
 static size_t tables_max_len = 0;
@@ -193,67 +242,143 @@ static size_t _write_callback(void *contents, size_t size, size_t nmemb,
 	return realsize;
 }
 
-/* Try to send data to influxdb */
-static int _send_data(const char *data)
+/* State kept by _sender_thread between posts */
+typedef struct {
+	CURL *curl_handle;
+	struct curl_slist *headers;
+	char *url;
+#ifdef HAVE_ZLIB
+	bool gzip_init;
+	z_stream gzip_stream;
+	char *gzip_buf;
+	size_t gzip_buf_size;
+#endif
+} sender_t;
+
+#ifdef HAVE_ZLIB
+/* Compress a batch into a gzip member, returns the compressed size or 0 */
+static size_t _gzip_batch(sender_t *sender, batch_t *batch)
+{
+	z_stream *zs = &sender->gzip_stream;
+	size_t bound;
+
+	if (!sender->gzip_init) {
+		/* 16 + MAX_WBITS writes a gzip header and trailer */
+		if (deflateInit2(zs, Z_BEST_SPEED, Z_DEFLATED, 16 + MAX_WBITS,
+				 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+			error("%s %s: deflateInit2 failed, sending data uncompressed",
+			      plugin_type, __func__);
+			influxdb_conf.compress = false;
+			return 0;
+		}
+		sender->gzip_init = true;
+	} else if (deflateReset(zs) != Z_OK) {
+		return 0;
+	}
+
+	bound = deflateBound(zs, batch->len);
+	if (bound > sender->gzip_buf_size) {
+		xrealloc(sender->gzip_buf, bound);
+		sender->gzip_buf_size = bound;
+	}
+
+	zs->next_in = (Bytef *) batch->data;
+	zs->avail_in = batch->len;
+	zs->next_out = (Bytef *) sender->gzip_buf;
+	zs->avail_out = sender->gzip_buf_size;
+
+	if (deflate(zs, Z_FINISH) != Z_STREAM_END)
+		return 0;
+
+	return zs->total_out;
+}
+#endif
+
+/* Set the options shared by every post on a new handle */
+static CURL *_sender_curl_init(sender_t *sender)
+{
+	CURL *curl_handle;
+
+	if ((curl_handle = curl_easy_init()) == NULL) {
+		error("%s %s: curl_easy_init: %m", plugin_type, __func__);
+		return NULL;
+	}
+
+	if (!sender->url)
+		xstrfmtcat(sender->url, "%s/write?db=%s&rp=%s&precision=s",
+			   influxdb_conf.host, influxdb_conf.database,
+			   influxdb_conf.rt_policy);
+
+	curl_easy_setopt(curl_handle, CURLOPT_URL, sender->url);
+	if (influxdb_conf.password)
+		curl_easy_setopt(curl_handle, CURLOPT_PASSWORD,
+				 influxdb_conf.password);
+	if (influxdb_conf.username)
+		curl_easy_setopt(curl_handle, CURLOPT_USERNAME,
+				 influxdb_conf.username);
+	curl_easy_setopt(curl_handle, CURLOPT_POST, 1L);
+	curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, _write_callback);
+	curl_easy_setopt(curl_handle, CURLOPT_TIMEOUT,
+			 (long) influxdb_conf.timeout);
+	/*
+	 * The handle lives as long as the sender thread, so libcurl keeps the
+	 * connection to InfluxDB open between batches.
+	 */
+	curl_easy_setopt(curl_handle, CURLOPT_TCP_KEEPALIVE, 1L);
+
+	return curl_handle;
+}
+
+/* Try to send one batch to influxdb */
+static int _send_batch(sender_t *sender, batch_t *batch)
 {
-	CURL *curl_handle = NULL;
 	CURLcode res;
 	struct http_response chunk;
 	int rc = SLURM_SUCCESS;
 	long response_code;
 	static int error_cnt = 0;
-	char *url = NULL;
-	size_t length;
+	char *body = batch->data;
+	size_t body_len = batch->len;
 
 	debug3("%s %s called", plugin_type, __func__);
 
-	/*
-	 * Every compute node which is sampling data will try to establish a
-	 * different connection to the influxdb server. In order to reduce the
-	 * number of connections, every time a new sampled data comes in, it
-	 * is saved in the 'datastr' buffer. Once this buffer is full, then we
-	 * try to open the connection and send this buffer, instead of opening
-	 * one per sample.
-	 */
-	if (data && ((datastrlen + strlen(data)) <= BUF_SIZE)) {
-		xstrcat(datastr, data);
-		length = strlen(data);
-		datastrlen += length;
-		log_flag(PROFILE, "%s %s: %zu bytes of data added to buffer. New buffer size: %d",
-			 plugin_type, __func__, length, datastrlen);
-		return rc;
-	}
-
 	DEF_TIMERS;
 	START_TIMER;
 
-	if ((curl_handle = curl_easy_init()) == NULL) {
-		error("%s %s: curl_easy_init: %m", plugin_type, __func__);
-		rc = SLURM_ERROR;
-		goto cleanup_easy_init;
+	if (!sender->curl_handle &&
+	    !(sender->curl_handle = _sender_curl_init(sender)))
+		return SLURM_ERROR;
+
+#ifdef HAVE_ZLIB
+	if (influxdb_conf.compress) {
+		size_t gzip_len = _gzip_batch(sender, batch);
+
+		if (gzip_len) {
+			body = sender->gzip_buf;
+			body_len = gzip_len;
+		}
 	}
+#endif
 
-	xstrfmtcat(url, "%s/write?db=%s&rp=%s&precision=s", influxdb_conf.host,
-		   influxdb_conf.database, influxdb_conf.rt_policy);
+	if (sender->headers)
+		curl_slist_free_all(sender->headers);
+	sender->headers = NULL;
+	if (body != batch->data)
+		sender->headers = curl_slist_append(NULL,
+						    "Content-Encoding: gzip");
 
 	chunk.message = xmalloc(1);
 	chunk.size = 0;
 
-	curl_easy_setopt(curl_handle, CURLOPT_URL, url);
-	if (influxdb_conf.password)
-		curl_easy_setopt(curl_handle, CURLOPT_PASSWORD,
-				 influxdb_conf.password);
-	curl_easy_setopt(curl_handle, CURLOPT_POST, 1);
-	curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDS, datastr);
-	curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDSIZE, strlen(datastr));
-	if (influxdb_conf.username)
-		curl_easy_setopt(curl_handle, CURLOPT_USERNAME,
-				 influxdb_conf.username);
-	curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, _write_callback);
-	curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, (void *) &chunk);
-	curl_easy_setopt(curl_handle, CURLOPT_TIMEOUT, influxdb_conf.timeout);
+	curl_easy_setopt(sender->curl_handle, CURLOPT_HTTPHEADER,
+			 sender->headers);
+	curl_easy_setopt(sender->curl_handle, CURLOPT_POSTFIELDS, body);
+	curl_easy_setopt(sender->curl_handle, CURLOPT_POSTFIELDSIZE,
+			 (long) body_len);
+	curl_easy_setopt(sender->curl_handle, CURLOPT_WRITEDATA,
+			 (void *) &chunk);
 
-	if ((res = curl_easy_perform(curl_handle)) != CURLE_OK) {
+	if ((res = curl_easy_perform(sender->curl_handle)) != CURLE_OK) {
 		if ((error_cnt++ % 100) == 0)
 			error("%s %s: curl_easy_perform failed to send data (discarded). Reason: %s",
 			      plugin_type, __func__, curl_easy_strerror(res));
@@ -261,7 +386,8 @@ static int _send_data(const char *data)
 		goto cleanup;
 	}
 
-	if ((res = curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE,
+	if ((res = curl_easy_getinfo(sender->curl_handle,
+				     CURLINFO_RESPONSE_CODE,
 				     &response_code)) != CURLE_OK) {
 		error("%s %s: curl_easy_getinfo response code failed: %s",
 		      plugin_type, __func__, curl_easy_strerror(res));
@@ -285,8 +411,9 @@ static int _send_data(const char *data)
 		       plugin_type, __func__, response_code);
 		if (slurm_conf.debug_flags & DEBUG_FLAG_PROFILE) {
 			/* Strip any trailing newlines. */
-			while (chunk.message[strlen(chunk.message) - 1] == '\n')
-				chunk.message[strlen(chunk.message) - 1] = '\0';
+			while (chunk.size &&
+			       (chunk.message[chunk.size - 1] == '\n'))
+				chunk.message[--chunk.size] = '\0';
 			info("%s %s: JSON response body: %s", plugin_type,
 			     __func__, chunk.message);
 		}
@@ -294,23 +421,262 @@ static int _send_data(const char *data)
 
 cleanup:
 	xfree(chunk.message);
-	xfree(url);
-cleanup_easy_init:
-	curl_easy_cleanup(curl_handle);
 
 	END_TIMER;
-	log_flag(PROFILE, "%s %s: took %s to send data",
-		 plugin_type, __func__, TIME_STR);
+	log_flag(PROFILE, "%s %s: took %s to send %zu bytes (%d uncompressed)",
+		 plugin_type, __func__, TIME_STR, body_len, batch->len);
+
+	return rc;
+}
+
+static void _sender_fini(sender_t *sender)
+{
+	if (sender->curl_handle)
+		curl_easy_cleanup(sender->curl_handle);
+	if (sender->headers)
+		curl_slist_free_all(sender->headers);
+	xfree(sender->url);
+#ifdef HAVE_ZLIB
+	if (sender->gzip_init)
+		deflateEnd(&sender->gzip_stream);
+	xfree(sender->gzip_buf);
+#endif
+}
+
+static void *_sender_thread(void *arg)
+{
+	sender_t sender = { 0 };
+	batch_t batch;
+	uint32_t discarded = 0;
+
+	debug3("%s %s called", plugin_type, __func__);
+
+	slurm_mutex_lock(&send_mutex);
+	while (true) {
+		if (!batch_cnt) {
+			if (send_shutdown)
+				break;
+			slurm_cond_wait(&send_cond, &send_mutex);
+			continue;
+		}
+
+		batch = batch_ring[batch_head];
+		batch_ring[batch_head].data = NULL;
+		batch_head = (batch_head + 1) % influxdb_conf.batches;
+		batch_cnt--;
+
+		/* Do not hold up the end of the step past the timeout */
+		if (send_shutdown && (time(NULL) >= send_deadline)) {
+			discarded++;
+			xfree(batch.data);
+			continue;
+		}
+
+		slurm_mutex_unlock(&send_mutex);
+		(void) _send_batch(&sender, &batch);
+		xfree(batch.data);
+		slurm_mutex_lock(&send_mutex);
+	}
+	slurm_mutex_unlock(&send_mutex);
+
+	if (discarded)
+		error("%s %s: discarded %u batches not sent within ProfileInfluxDBTimeout",
+		      plugin_type, __func__, discarded);
+
+	_sender_fini(&sender);
+
+	return NULL;
+}
+
+static void _series_id(void *item, const char **key, uint32_t *key_len)
+{
+	series_t *series = item;
+
+	*key = series->key;
+	*key_len = series->key_len;
+}
+
+/* Iterate every line of the queued batches followed by the open batch */
+static void _for_each_line(void (*func)(const char *line, int len,
+					void *arg), void *arg)
+{
+	for (uint32_t i = 0; i <= batch_cnt; i++) {
+		const char *line, *eol;
+
+		if (i < batch_cnt)
+			line = batch_ring[(batch_head + i) %
+					  influxdb_conf.batches].data;
+		else
+			line = datastr;
+
+		while (line && (eol = strchr(line, '\n'))) {
+			func(line, eol - line + 1, arg);
+			line = eol + 1;
+		}
+	}
+}
+
+/* A series is everything in a line before its value */
+static uint32_t _series_key_len(const char *line, int len)
+{
+	const char *value = strstr(line, " value=");
+
+	if (!value || ((value - line) >= len))
+		return len;
+	return value - line;
+}
+
+static void _add_series(const char *line, int len, void *arg)
+{
+	xhash_t *series_hash = arg;
+	uint32_t key_len = _series_key_len(line, len);
+	series_t *series;
+
+	if ((series = xhash_get(series_hash, line, key_len))) {
+		series->line = line;
+		return;
+	}
+
+	series = xmalloc(sizeof(*series));
+	series->key = line;
+	series->key_len = key_len;
+	series->line = line;
+	xhash_add(series_hash, series);
+}
+
+static void _merge_series(const char *line, int len, void *arg)
+{
+	merge_args_t *args = arg;
+	series_t *series = xhash_get(args->series_hash, line,
+				     _series_key_len(line, len));
+
+	if (series->line != line)
+		return;
+
+	memcpy(args->pos, line, len);
+	args->pos += len;
+}
+
+/*
+ * Collapse the queued batches and the open batch into a single open batch
+ * that only holds the newest sample of every series. Must hold send_mutex.
+ */
+static void _aggregate_batches(void)
+{
+	merge_args_t args = { 0 };
+	int total = datastrlen;
+
+	for (uint32_t i = 0; i < batch_cnt; i++)
+		total += batch_ring[(batch_head + i) %
+				    influxdb_conf.batches].len;
+
+	args.series_hash = xhash_init(_series_id, xfree_ptr);
+	_for_each_line(_add_series, args.series_hash);
+
+	args.merged = args.pos = xmalloc(total + 1);
+	_for_each_line(_merge_series, &args);
+	xhash_free(args.series_hash);
+
+	for (uint32_t i = 0; i < batch_cnt; i++)
+		xfree(batch_ring[(batch_head + i) %
+				 influxdb_conf.batches].data);
+
+	log_flag(PROFILE, "%s %s: aggregated %u batches of %d bytes into %ld bytes",
+		 plugin_type, __func__, batch_cnt + 1, total,
+		 (long) (args.pos - args.merged));
+
+	batch_head = 0;
+	batch_cnt = 0;
+	xfree(datastr);
+	datastr = args.merged;
+	datastrlen = args.pos - args.merged;
+}
+
+/* Move the open batch to the send ring. Must hold send_mutex. */
+static void _queue_batch(void)
+{
+	uint32_t tail;
+
+	if (!datastrlen)
+		return;
+
+	if (!batch_ring)
+		batch_ring = xcalloc(influxdb_conf.batches, sizeof(*batch_ring));
+
+	if (batch_cnt == influxdb_conf.batches) {
+		if (influxdb_conf.overflow == INFLUXDB_OVERFLOW_AGGREGATE) {
+			_aggregate_batches();
+		} else {
+			if ((dropped_batches++ % 100) == 0)
+				error("%s %s: InfluxDB is not keeping up, dropped %"PRIu64" batches so far",
+				      plugin_type, __func__, dropped_batches);
+			xfree(batch_ring[batch_head].data);
+			batch_head = (batch_head + 1) % influxdb_conf.batches;
+			batch_cnt--;
+		}
+	}
+
+	tail = (batch_head + batch_cnt) % influxdb_conf.batches;
+	batch_ring[tail].data = datastr;
+	batch_ring[tail].len = datastrlen;
+	batch_cnt++;
+	datastr = NULL;
+	datastrlen = 0;
+
+	if (!send_thread)
+		slurm_thread_create(&send_thread, _sender_thread, NULL);
+	slurm_cond_signal(&send_cond);
+}
+
+/* Queue data to be sent to influxdb, NULL flushes the open batch */
+static void _send_data(const char *data)
+{
+	size_t length = data ? strlen(data) : 0;
+
+	debug3("%s %s called", plugin_type, __func__);
+
+	slurm_mutex_lock(&send_mutex);
+
+	/*
+	 * Every compute node which is sampling data will try to establish a
+	 * different connection to the influxdb server. In order to reduce the
+	 * number of connections, every time a new sampled data comes in, it
+	 * is saved in the 'datastr' buffer. Once this buffer is full, it is
+	 * queued for the sender thread as one batch, instead of sending one
+	 * request per sample.
+	 */
+	if (!data || ((datastrlen + length) > BUF_SIZE))
+		_queue_batch();
 
 	if (data) {
-		datastr = xstrdup(data);
-		datastrlen = strlen(data);
-	} else {
-		datastr[0] = '\0';
-		datastrlen = 0;
+		xstrcat(datastr, data);
+		datastrlen += length;
+		log_flag(PROFILE, "%s %s: %zu bytes of data added to buffer. New buffer size: %d",
+			 plugin_type, __func__, length, datastrlen);
 	}
 
-	return rc;
+	slurm_mutex_unlock(&send_mutex);
+}
+
+/* Flush the open batch and wait for the queued ones to be sent */
+static void _stop_sender(void)
+{
+	slurm_mutex_lock(&send_mutex);
+	_queue_batch();
+	if (!send_thread) {
+		slurm_mutex_unlock(&send_mutex);
+		return;
+	}
+	send_shutdown = true;
+	send_deadline = time(NULL) + influxdb_conf.timeout;
+	slurm_cond_signal(&send_cond);
+	slurm_mutex_unlock(&send_mutex);
+
+	slurm_thread_join(send_thread);
+
+	slurm_mutex_lock(&send_mutex);
+	send_shutdown = false;
+	slurm_mutex_unlock(&send_mutex);
 }
 
 /*
@@ -329,7 +695,6 @@ extern int init(void)
 		return SLURM_ERROR;
 	}
 
-	datastr = xmalloc(BUF_SIZE);
 	return SLURM_SUCCESS;
 }
 
@@ -337,10 +702,12 @@ extern int fini(void)
 {
 	debug3("%s %s called", plugin_type, __func__);
 
+	_stop_sender();
 	curl_global_cleanup();
 
 	_free_tables();
 	xfree(datastr);
+	xfree(batch_ring);
 	xfree(influxdb_conf.host);
 	xfree(influxdb_conf.database);
 	xfree(influxdb_conf.password);
@@ -355,9 +722,12 @@ extern void acct_gather_profile_p_conf_options(s_p_options_t **full_options,
 	debug3("%s %s called", plugin_type, __func__);
 
 	s_p_options_t options[] = {
+		{"ProfileInfluxDBBatches", S_P_UINT32},
+		{"ProfileInfluxDBCompress", S_P_BOOLEAN},
 		{"ProfileInfluxDBHost", S_P_STRING},
 		{"ProfileInfluxDBDatabase", S_P_STRING},
 		{"ProfileInfluxDBDefault", S_P_STRING},
+		{"ProfileInfluxDBOverflow", S_P_STRING},
 		{"ProfileInfluxDBPass", S_P_STRING},
 		{"ProfileInfluxDBRTPolicy", S_P_STRING},
 		{"ProfileInfluxDBTimeout", S_P_UINT32},
@@ -375,7 +745,21 @@ extern void acct_gather_profile_p_conf_set(s_p_hashtbl_t *tbl)
 	debug3("%s %s called", plugin_type, __func__);
 
 	influxdb_conf.def = ACCT_GATHER_PROFILE_ALL;
+	influxdb_conf.batches = DEFAULT_INFLUXDB_BATCHES;
+#ifdef HAVE_ZLIB
+	influxdb_conf.compress = true;
+#else
+	influxdb_conf.compress = false;
+#endif
+	influxdb_conf.overflow = INFLUXDB_OVERFLOW_DROP;
+	influxdb_conf.timeout = DEFAULT_INFLUXDB_TIMEOUT;
 	if (tbl) {
+		if (s_p_get_uint32(&influxdb_conf.batches,
+				   "ProfileInfluxDBBatches", tbl) &&
+		    !influxdb_conf.batches)
+			fatal("ProfileInfluxDBBatches must be at least 1");
+		s_p_get_boolean(&influxdb_conf.compress,
+				"ProfileInfluxDBCompress", tbl);
 		s_p_get_string(&influxdb_conf.host, "ProfileInfluxDBHost", tbl);
 		if (s_p_get_string(&tmp, "ProfileInfluxDBDefault", tbl)) {
 			influxdb_conf.def =
@@ -387,17 +771,32 @@ extern void acct_gather_profile_p_conf_set(s_p_hashtbl_t *tbl)
 		}
 		s_p_get_string(&influxdb_conf.database,
 			       "ProfileInfluxDBDatabase", tbl);
+		if (s_p_get_string(&tmp, "ProfileInfluxDBOverflow", tbl)) {
+			if (!xstrcasecmp(tmp, "aggregate"))
+				influxdb_conf.overflow =
+					INFLUXDB_OVERFLOW_AGGREGATE;
+			else if (xstrcasecmp(tmp, "drop"))
+				fatal("ProfileInfluxDBOverflow can not be set to %s, please specify drop or aggregate",
+				      tmp);
+			xfree(tmp);
+		}
 		s_p_get_string(&influxdb_conf.password,
 			       "ProfileInfluxDBPass", tbl);
 		s_p_get_string(&influxdb_conf.rt_policy,
 			       "ProfileInfluxDBRTPolicy", tbl);
-		if (!s_p_get_uint32(&influxdb_conf.timeout,
-				    "ProfileInfluxDBTimeout", tbl))
-			influxdb_conf.timeout = DEFAULT_INFLUXDB_TIMEOUT;
+		s_p_get_uint32(&influxdb_conf.timeout,
+			       "ProfileInfluxDBTimeout", tbl);
 		s_p_get_string(&influxdb_conf.username,
 			       "ProfileInfluxDBUser", tbl);
 	}
 
+#ifndef HAVE_ZLIB
+	if (influxdb_conf.compress) {
+		error("ProfileInfluxDBCompress requires Slurm to be built with zlib, sending data uncompressed");
+		influxdb_conf.compress = false;
+	}
+#endif
+
 	if (!influxdb_conf.host)
 		fatal("No ProfileInfluxDBHost in your acct_gather.conf file. This is required to use the %s plugin",
 		      plugin_type);
@@ -471,6 +870,8 @@ extern int acct_gather_profile_p_node_step_end(void)
 
 	xassert(running_in_slurmstepd());
 
+	_stop_sender();
+
 	return rc;
 }
 
@@ -601,6 +1002,12 @@ extern int acct_gather_profile_p_add_sample_data(int table_id, void *data,
 
 extern void acct_gather_profile_p_conf_values(list_t **data)
 {
+	add_key_pair(*data, "ProfileInfluxDBBatches", "%u",
+		     influxdb_conf.batches);
+
+	add_key_pair_bool(*data, "ProfileInfluxDBCompress",
+			  influxdb_conf.compress);
+
 	add_key_pair(*data, "ProfileInfluxDBHost", "%s",
 		     influxdb_conf.host);
 
@@ -610,6 +1017,10 @@ extern void acct_gather_profile_p_conf_values(list_t **data)
 	add_key_pair(*data, "ProfileInfluxDBDefault", "%s",
 		     acct_gather_profile_to_string(influxdb_conf.def));
 
+	add_key_pair(*data, "ProfileInfluxDBOverflow", "%s",
+		     (influxdb_conf.overflow == INFLUXDB_OVERFLOW_AGGREGATE) ?
+		     "aggregate" : "drop");
+
 	/* skip over ProfileInfluxDBPass for security reasons */
 
 	add_key_pair(*data, "ProfileInfluxDBRTPolicy", "%s",
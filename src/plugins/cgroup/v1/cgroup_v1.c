@@ -1490,6 +1490,17 @@ extern cgroup_acct_t *cgroup_p_task_get_acct_data(uint32_t taskid)
 	return stats;
 }
 
+/* cgroup/v1 has neither memory.events nor cpu.pressure to watch. */
+extern int cgroup_p_step_start_acct_monitor(void (*callback)(void))
+{
+	return ESLURM_NOT_SUPPORTED;
+}
+
+extern void cgroup_p_step_stop_acct_monitor(void)
+{
+	return;
+}
+
 /* cgroup/v1 usec and ssec are provided in USER_HZ. */
 extern long int cgroup_p_get_acct_units(void)
 {
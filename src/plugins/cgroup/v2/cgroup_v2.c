@@ -48,6 +48,7 @@
 #include "slurm/slurm_errno.h"
 
 #include "src/common/bitstring.h"
+#include "src/common/fd.h"
 #include "src/common/list.h"
 #include "src/common/log.h"
 #include "src/common/timers.h"
@@ -66,6 +67,15 @@
 #define SYSTEM_CGDIR "system"
 #define CGROUP_MAX_RETRIES 100
 
+/*
+ * cpu.pressure trigger of the accounting monitor: 100ms of stall within 1s
+ * for some of the step's tasks. Events are then coalesced over
+ * ACCT_MONITOR_INTERVAL_MS so a throttled step does not poll continuously.
+ */
+#define ACCT_MONITOR_CPU_TRIGGER "some 100000 1000000"
+#define ACCT_MONITOR_INTERVAL_MS 1000
+#define ACCT_STAT_BUF_SIZE 8192
+
 const char plugin_name[] = "Cgroup v2 plugin";
 const char plugin_type[] = "cgroup/v2";
 const uint32_t plugin_version = SLURM_VERSION_NUMBER;
@@ -79,6 +89,9 @@ static bpf_program_t p[CG_LEVEL_CNT];
 static char *stepd_scope_path = NULL;
 static uint32_t task_special_id = NO_VAL;
 static char *invoc_id;
+static pthread_t acct_monitor_thread = 0;
+static int acct_monitor_pipe[2] = { -1, -1 };
+static void (*acct_monitor_callback)(void) = NULL;
 static char *ctl_names[] = {
 	[CG_TRACK] = "freezer",
 	[CG_CPUS] = "cpuset",
@@ -91,6 +104,10 @@ typedef struct {
 	xcgroup_t task_cg;
 	uint32_t taskid;
 	bpf_program_t p;
+	/* Accounting files, kept open for the life of the task cgroup */
+	int cpu_stat_fd;
+	int memory_current_fd;
+	int memory_stat_fd;
 } task_cg_info_t;
 
 typedef struct {
@@ -99,6 +116,7 @@ typedef struct {
 } foreach_pid_array_t;
 
 extern bool cgroup_p_has_feature(cgroup_ctl_feature_t f);
+extern void cgroup_p_step_stop_acct_monitor(void);
 extern int cgroup_p_task_addto(cgroup_ctl_type_t ctl, stepd_step_rec_t *step,
 			       pid_t pid, uint32_t task_id);
 
@@ -440,10 +458,18 @@ static int _setup_controllers()
 				int_cg_ns.avail_controllers);
 }
 
+static void _close_task_acct_fds(task_cg_info_t *task_cg)
+{
+	fd_close(&task_cg->cpu_stat_fd);
+	fd_close(&task_cg->memory_current_fd);
+	fd_close(&task_cg->memory_stat_fd);
+}
+
 static int _rmdir_task(void *x, void *arg)
 {
 	task_cg_info_t *t = (task_cg_info_t *) x;
 
+	_close_task_acct_fds(t);
 	if (common_cgroup_delete(&t->task_cg) != SLURM_SUCCESS)
 		log_flag(CGROUP, "Failed to delete %s: %m", t->task_cg.path);
 
@@ -464,6 +490,7 @@ static int _find_task_cg_info(void *x, void *key)
 static int _find_purge_task_special(task_cg_info_t *task_ptr, uint32_t *id)
 {
 	if (task_ptr->taskid == *id) {
+		_close_task_acct_fds(task_ptr);
 		if (common_cgroup_delete(&task_ptr->task_cg) != SLURM_SUCCESS)
 			log_flag(CGROUP, "Failed to cleanup %s: %m",
 				 task_ptr->task_cg.path);
@@ -478,6 +505,7 @@ static void _free_task_cg_info(void *x)
 	task_cg_info_t *task_cg = (task_cg_info_t *)x;
 
 	if (task_cg) {
+		_close_task_acct_fds(task_cg);
 		common_cgroup_destroy(&task_cg->task_cg);
 		free_ebpf_prog(&task_cg->p);
 		xfree(task_cg);
@@ -1208,6 +1236,7 @@ extern int fini(void)
 	 * we may not be stopping yet. When the process terminates systemd will
 	 * remove the remaining directories.
 	 */
+	cgroup_p_step_stop_acct_monitor();
 	FREE_NULL_BITMAP(int_cg_ns.avail_controllers);
 	common_cgroup_destroy(&int_cg[CG_LEVEL_SYSTEM]);
 	common_cgroup_destroy(&int_cg[CG_LEVEL_ROOT]);
@@ -2074,6 +2103,9 @@ extern int cgroup_p_task_addto(cgroup_ctl_type_t ctl, stepd_step_rec_t *step,
 					     &task_id))) {
 		task_cg_info = xmalloc(sizeof(*task_cg_info));
 		task_cg_info->taskid = task_id;
+		task_cg_info->cpu_stat_fd = -1;
+		task_cg_info->memory_current_fd = -1;
+		task_cg_info->memory_stat_fd = -1;
 		need_to_add = true;
 	}
 
@@ -2138,11 +2170,61 @@ extern int cgroup_p_task_addto(cgroup_ctl_type_t ctl, stepd_step_rec_t *step,
 	return SLURM_SUCCESS;
 }
 
+/*
+ * Read a task accounting file into buf, opening it only the first time. These
+ * files are read for every task on every poll, so keeping them open saves an
+ * open() and close() on each read.
+ */
+static int _read_task_acct_file(task_cg_info_t *task_cg_info, char *name,
+				int *fd, char *buf, size_t size)
+{
+	char *file_path = NULL;
+	ssize_t n;
+
+	if (*fd < 0) {
+		xstrfmtcat(file_path, "%s/%s", task_cg_info->task_cg.path,
+			   name);
+		*fd = open(file_path, O_RDONLY | O_CLOEXEC);
+		xfree(file_path);
+		if (*fd < 0)
+			return SLURM_ERROR;
+	}
+
+	if ((n = pread(*fd, buf, size - 1, 0)) < 0) {
+		fd_close(fd);
+		return SLURM_ERROR;
+	}
+	buf[n] = '\0';
+
+	return SLURM_SUCCESS;
+}
+
+/*
+ * Get the value of key from a flat keyed file like cpu.stat or memory.stat,
+ * made of "<key> <value>" lines.
+ */
+static int _get_key_value(char *buf, char *key, uint64_t *value)
+{
+	size_t len = strlen(key);
+	char *line = buf, *end;
+
+	while (line) {
+		if (!strncmp(line, key, len) && (line[len] == ' ')) {
+			*value = strtoull(line + len + 1, &end, 10);
+			if (end == (line + len + 1))
+				return SLURM_ERROR;
+			return SLURM_SUCCESS;
+		}
+		if ((line = strchr(line, '\n')))
+			line++;
+	}
+
+	return SLURM_ERROR;
+}
+
 extern cgroup_acct_t *cgroup_p_task_get_acct_data(uint32_t task_id)
 {
-	char *cpu_stat = NULL, *memory_stat = NULL, *memory_current = NULL;
-	char *ptr;
-	size_t tmp_sz = 0;
+	static char buf[ACCT_STAT_BUF_SIZE];
 	cgroup_acct_t *stats = NULL;
 	task_cg_info_t *task_cg_info;
 
@@ -2157,85 +2239,195 @@ extern cgroup_acct_t *cgroup_p_task_get_acct_data(uint32_t task_id)
 		return NULL;
 	}
 
-	if (common_cgroup_get_param(&task_cg_info->task_cg,
-				    "cpu.stat",
-				    &cpu_stat,
-				    &tmp_sz) != SLURM_SUCCESS) {
+	/*
+	 * Initialize values. A NO_VAL64 will indicate the caller that something
+	 * happened here. Values that aren't set here are returned as 0.
+	 */
+	stats = xmalloc(sizeof(*stats));
+	stats->usec = NO_VAL64;
+	stats->ssec = NO_VAL64;
+	stats->total_rss = NO_VAL64;
+	stats->total_pgmajfault = NO_VAL64;
+
+	if (_read_task_acct_file(task_cg_info, "cpu.stat",
+				 &task_cg_info->cpu_stat_fd, buf,
+				 sizeof(buf)) != SLURM_SUCCESS) {
 		if (task_id == task_special_id)
 			log_flag(CGROUP, "Cannot read task_special cpu.stat file");
 		else
 			log_flag(CGROUP, "Cannot read task %d cpu.stat file",
 				 task_id);
+	} else {
+		if (_get_key_value(buf, "user_usec", &stats->usec) !=
+		    SLURM_SUCCESS) {
+			stats->usec = NO_VAL64;
+			error("Cannot parse user_sec field in cpu.stat file");
+		}
+		if (_get_key_value(buf, "system_usec", &stats->ssec) !=
+		    SLURM_SUCCESS) {
+			stats->ssec = NO_VAL64;
+			error("Cannot parse system_usec field in cpu.stat file");
+		}
 	}
 
-	if (common_cgroup_get_param(&task_cg_info->task_cg,
-				    "memory.current",
-				    &memory_current,
-				    &tmp_sz) != SLURM_SUCCESS) {
+	/*
+	 * In cgroup/v1, total_rss was the hierarchical sum of # of bytes of
+	 * anonymous and swap cache memory (including transparent huge pages).
+	 *
+	 * In cgroup/v2 we use memory.current which includes all the
+	 * memory the app has touched. Using this value makes it consistent with
+	 * the OOM killer limit.
+	 */
+	if (_read_task_acct_file(task_cg_info, "memory.current",
+				 &task_cg_info->memory_current_fd, buf,
+				 sizeof(buf)) != SLURM_SUCCESS) {
 		if (task_id == task_special_id)
 			log_flag(CGROUP, "Cannot read task_special memory.current file");
 		else
 			log_flag(CGROUP, "Cannot read task %d memory.current file",
 				 task_id);
+	} else if (sscanf(buf, "%"PRIu64, &stats->total_rss) != 1) {
+		stats->total_rss = NO_VAL64;
+		error("Cannot parse memory.current file");
 	}
 
-	if (common_cgroup_get_param(&task_cg_info->task_cg,
-				    "memory.stat",
-				    &memory_stat,
-				    &tmp_sz) != SLURM_SUCCESS) {
+	if (_read_task_acct_file(task_cg_info, "memory.stat",
+				 &task_cg_info->memory_stat_fd, buf,
+				 sizeof(buf)) != SLURM_SUCCESS) {
 		if (task_id == task_special_id)
 			log_flag(CGROUP, "Cannot read task_special memory.stat file");
 		else
 			log_flag(CGROUP, "Cannot read task %d memory.stat file",
 				 task_id);
+	} else if (_get_key_value(buf, "pgmajfault",
+				  &stats->total_pgmajfault) != SLURM_SUCCESS) {
+		stats->total_pgmajfault = NO_VAL64;
+		log_flag(CGROUP, "Cannot parse pgmajfault field in memory.stat file");
 	}
 
-	/*
-	 * Initialize values. A NO_VAL64 will indicate the caller that something
-	 * happened here. Values that aren't set here are returned as 0.
-	 */
-	stats = xmalloc(sizeof(*stats));
-	stats->usec = NO_VAL64;
-	stats->ssec = NO_VAL64;
-	stats->total_rss = NO_VAL64;
-	stats->total_pgmajfault = NO_VAL64;
+	return stats;
+}
 
-	if (cpu_stat) {
-		ptr = xstrstr(cpu_stat, "user_usec");
-		if (ptr &&
-		    (sscanf(ptr, "user_usec %"PRIu64, &stats->usec) != 1))
-			error("Cannot parse user_sec field in cpu.stat file");
+static void *_acct_monitor(void *arg)
+{
+	int ifd = -1, psi_fd = -1, wd;
+	char *events_file = NULL, *pressure_file = NULL;
+	char buf[sizeof(struct inotify_event) + NAME_MAX + 1];
+	struct pollfd pfd[3];
+	int nfds = 1;
 
-		ptr = xstrstr(cpu_stat, "system_usec");
-		if (ptr &&
-		    (sscanf(ptr, "system_usec %"PRIu64, &stats->ssec) != 1))
-			error("Cannot parse system_usec field in cpu.stat file");
-		xfree(cpu_stat);
+	pfd[0].fd = acct_monitor_pipe[0];
+	pfd[0].events = POLLIN;
+
+	/* memory.events is hierarchical, so this covers every task */
+	xstrfmtcat(events_file, "%s/memory.events",
+		   int_cg[CG_LEVEL_STEP_USER].path);
+	if ((ifd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK)) < 0)
+		error("Cannot initialize inotify for %s: %m", events_file);
+	else if ((wd = inotify_add_watch(ifd, events_file, IN_MODIFY)) < 0) {
+		log_flag(CGROUP, "Cannot watch %s: %m", events_file);
+		fd_close(&ifd);
+	} else {
+		pfd[nfds].fd = ifd;
+		pfd[nfds++].events = POLLIN;
+	}
+
+	/* Register a PSI trigger, only available with CONFIG_PSI kernels */
+	xstrfmtcat(pressure_file, "%s/cpu.pressure",
+		   int_cg[CG_LEVEL_STEP_USER].path);
+	if ((psi_fd = open(pressure_file,
+			   O_RDWR | O_NONBLOCK | O_CLOEXEC)) < 0) {
+		log_flag(CGROUP, "Cannot open %s: %m", pressure_file);
+	} else if (write(psi_fd, ACCT_MONITOR_CPU_TRIGGER,
+			 strlen(ACCT_MONITOR_CPU_TRIGGER) + 1) < 0) {
+		log_flag(CGROUP, "Cannot set trigger in %s: %m",
+			 pressure_file);
+		fd_close(&psi_fd);
+	} else {
+		pfd[nfds].fd = psi_fd;
+		pfd[nfds++].events = POLLPRI;
 	}
 
-	/*
-	 * In cgroup/v1, total_rss was the hierarchical sum of # of bytes of
-	 * anonymous and swap cache memory (including transparent huge pages).
-	 *
-	 * In cgroup/v2 we use memory.current which includes all the
-	 * memory the app has touched. Using this value makes it consistent with
-	 * the OOM killer limit.
-	 */
-	if (memory_current) {
-		if (sscanf(memory_current, "%"PRIu64, &stats->total_rss) != 1)
-			error("Cannot parse memory.current file");
-		xfree(memory_current);
+	log_flag(CGROUP, "Accounting monitor watching %s%s%s",
+		 (ifd >= 0) ? "memory.events " : "",
+		 (psi_fd >= 0) ? "cpu.pressure " : "",
+		 (nfds == 1) ? "nothing" : "");
+
+	while (nfds > 1) {
+		bool notify = false;
+
+		if (poll(pfd, nfds, -1) < 0) {
+			if (errno == EINTR)
+				continue;
+			error("%s: poll: %m", __func__);
+			break;
+		}
+		if (pfd[0].revents)
+			break;
+
+		for (int i = 1; i < nfds; i++) {
+			if (!pfd[i].revents)
+				continue;
+			if (pfd[i].revents & (POLLERR | POLLNVAL)) {
+				/* The cgroup is going away */
+				pfd[i].fd = -1;
+				continue;
+			}
+			notify = true;
+			if (pfd[i].fd == ifd) {
+				while (read(ifd, buf, sizeof(buf)) > 0)
+					;
+			}
+		}
+
+		if (notify) {
+			acct_monitor_callback();
+			/* Coalesce events, but stay responsive to stop */
+			if (poll(pfd, 1, ACCT_MONITOR_INTERVAL_MS) > 0)
+				break;
+		}
+	}
+
+	fd_close(&ifd);
+	fd_close(&psi_fd);
+	xfree(events_file);
+	xfree(pressure_file);
+	return NULL;
+}
+
+extern int cgroup_p_step_start_acct_monitor(void (*callback)(void))
+{
+	if (!int_cg[CG_LEVEL_STEP_USER].path) {
+		error("%s: step cgroup not created", __func__);
+		return SLURM_ERROR;
 	}
 
-	if (memory_stat) {
-		ptr = xstrstr(memory_stat, "pgmajfault");
-		if (ptr && (sscanf(ptr, "pgmajfault %"PRIu64,
-				   &stats->total_pgmajfault) != 1))
-			log_flag(CGROUP, "Cannot parse pgmajfault field in memory.stat file");
-		xfree(memory_stat);
+	if (acct_monitor_thread)
+		return SLURM_SUCCESS;
+
+	if (pipe2(acct_monitor_pipe, O_CLOEXEC)) {
+		error("%s: pipe2: %m", __func__);
+		return SLURM_ERROR;
 	}
 
-	return stats;
+	acct_monitor_callback = callback;
+	slurm_thread_create(&acct_monitor_thread, _acct_monitor, NULL);
+
+	return SLURM_SUCCESS;
+}
+
+extern void cgroup_p_step_stop_acct_monitor(void)
+{
+	if (!acct_monitor_thread)
+		return;
+
+	if (write(acct_monitor_pipe[1], "", 1) < 0)
+		error("%s: Cannot stop accounting monitor: %m", __func__);
+	slurm_thread_join(acct_monitor_thread);
+
+	fd_close(&acct_monitor_pipe[0]);
+	fd_close(&acct_monitor_pipe[1]);
+	acct_monitor_callback = NULL;
 }
 
 /*
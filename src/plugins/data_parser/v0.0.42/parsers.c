@@ -8519,6 +8519,14 @@ static const parser_t PARSER_ARRAY(JOB_SUBMIT_REQ)[] = {
 #undef add_parse
 #undef add_parse_deprec
 
+#define add_parse(mtype, field, path, desc) \
+	add_parser(openapi_job_submit_batch_request_t, mtype, false, field, 0, path, desc)
+static const parser_t PARSER_ARRAY(JOB_SUBMIT_BATCH_REQ)[] = {
+	add_parse(STRING, script, "script", "Default batch script for jobs without a script"),
+	add_parse(JOB_DESC_MSG_LIST, jobs, "jobs", "Independent job descriptions"),
+};
+#undef add_parse
+
 #define add_flag(flag_value, flag_string, hidden, desc)               \
 	add_flag_bit_entry(FLAG_BIT_TYPE_BIT, XSTRINGIFY(flag_value), \
 			   flag_value, INFINITE64,                    \
@@ -9397,6 +9405,16 @@ static const parser_t PARSER_ARRAY(OPENAPI_JOB_SUBMIT_RESPONSE)[] = {
 #undef add_parse
 #undef add_parse_deprec
 
+#define add_parse(mtype, field, path, desc) \
+	add_parser(openapi_job_submit_batch_response_t, mtype, false, field, 0, path, desc)
+static const parser_t PARSER_ARRAY(OPENAPI_JOB_SUBMIT_BATCH_RESP)[] = {
+	add_parse(JOB_SUBMIT_RESPONSE_MSG_LIST, results, "results", "Job submission results in request order"),
+	add_openapi_response_meta(openapi_job_submit_batch_response_t),
+	add_openapi_response_errors(openapi_job_submit_batch_response_t),
+	add_openapi_response_warnings(openapi_job_submit_batch_response_t),
+};
+#undef add_parse
+
 #define add_parse_req(mtype, field, path, desc) \
 	add_parser(openapi_resp_job_info_msg_t, mtype, true, field, 0, path, desc)
 static const parser_t PARSER_ARRAY(OPENAPI_JOB_INFO_RESP)[] = {
@@ -9989,6 +10007,7 @@ static const parser_t parsers[] = {
 	addpap(OPENAPI_WARNING, openapi_resp_warning_t, NULL, free_openapi_resp_warning),
 	addpap(INSTANCE_CONDITION, slurmdb_instance_cond_t, NULL, slurmdb_destroy_instance_cond),
 	addpap(JOB_SUBMIT_REQ, openapi_job_submit_request_t, NULL, NULL),
+	addpap(JOB_SUBMIT_BATCH_REQ, openapi_job_submit_batch_request_t, NULL, NULL),
 	addpap(JOB_CONDITION, slurmdb_job_cond_t, NULL, slurmdb_destroy_job_cond),
 	addpap(QOS_CONDITION, slurmdb_qos_cond_t, NULL, slurmdb_destroy_qos_cond),
 	addpap(ASSOC_CONDITION, slurmdb_assoc_cond_t, NULL, slurmdb_destroy_assoc_cond),
@@ -10055,6 +10074,7 @@ static const parser_t parsers[] = {
 	addpap(OPENAPI_JOB_INFO_RESP, openapi_resp_job_info_msg_t, NULL, NULL),
 	addpap(OPENAPI_JOB_POST_RESPONSE, openapi_job_post_response_t, NULL, NULL),
 	addpap(OPENAPI_JOB_SUBMIT_RESPONSE, openapi_job_submit_response_t, NULL, NULL),
+	addpap(OPENAPI_JOB_SUBMIT_BATCH_RESP, openapi_job_submit_batch_response_t, NULL, NULL),
 	addpap(OPENAPI_NODES_RESP, openapi_resp_node_info_msg_t, NULL, NULL),
 	addpap(OPENAPI_PARTITION_RESP, openapi_resp_partitions_info_msg_t, NULL, NULL),
 	addpap(OPENAPI_RESERVATION_RESP, openapi_resp_reserve_info_msg_t, NULL, NULL),
@@ -10148,6 +10168,7 @@ static const parser_t parsers[] = {
 	addpl(TRES_LIST, TRES_PTR, NEED_NONE),
 	addpl(SINFO_DATA_LIST, SINFO_DATA_PTR, NEED_NONE),
 	addpl(JOB_DESC_MSG_LIST, JOB_DESC_MSG_PTR, NEED_NONE),
+	addpl(JOB_SUBMIT_RESPONSE_MSG_LIST, JOB_SUBMIT_RESPONSE_MSG_PTR, NEED_NONE),
 	addpl(OPENAPI_ERRORS, OPENAPI_ERROR_PTR, NEED_NONE),
 	addpl(OPENAPI_WARNINGS, OPENAPI_WARNING_PTR, NEED_NONE),
 	addpl(STRING_LIST, STRING, NEED_NONE),
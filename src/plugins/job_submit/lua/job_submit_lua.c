@@ -95,24 +95,36 @@ const char plugin_name[]       	= "Job submit lua plugin";
 const char plugin_type[]       	= "job_submit/lua";
 const uint32_t plugin_version   = SLURM_VERSION_NUMBER;
 
+#define LUA_CTX_KEY "_job_submit_lua_ctx"
+
 static char *lua_script_path;
-static time_t lua_script_last_loaded = (time_t) 0;
-static lua_State *L = NULL;
-static char *user_msg = NULL;
-time_t last_lua_jobs_update = (time_t) 0;
-time_t last_lua_resv_update = (time_t) 0;
 static const char *req_fxns[] = {
 	"slurm_job_submit",
 	"slurm_job_modify",
 	NULL
 };
+
+/* Lua state with the script loaded, used by a single thread at a time */
+typedef struct {
+	lua_State *L;
+	time_t load_time; /* mtime of script loaded in L */
+	time_t jobs_update; /* last_job_update when slurm.jobs was reset */
+	time_t resv_update; /* last_resv_update when slurm.reservations was reset */
+	char *user_msg;
+} lua_ctx_t;
+
 /*
- *  Mutex for protecting multi-threaded access to this plugin.
- *   (Only 1 thread at a time should be in here)
+ *  Pool of idle Lua states. slurmctld only holds read locks while calling
+ *   job_submit(), so up to lua_states submissions are evaluated at once,
+ *   each one in its own state.
  */
 static pthread_mutex_t lua_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t lua_cond = PTHREAD_COND_INITIALIZER;
+static list_t *lua_pool = NULL;
+static int lua_states = 1;
 
 typedef struct {
+	lua_State *L;
 	uint32_t submit_uid;
 	uint32_t user_id;
 } foreach_part_list_args_t;
@@ -217,7 +229,7 @@ static int _job_rec_field_index(lua_State *L)
 	return slurm_lua_job_record_field(L, job_ptr, name);
 }
 
-static int _foreach_update_jobs_global(void *x, void *arg)
+static int _foreach_push_job(void *x, void *arg)
 {
 	char job_id_buf[11]; /* Big enough for a uint32_t */
 	job_record_t *job_ptr = x;
@@ -247,25 +259,17 @@ static int _foreach_update_jobs_global(void *x, void *arg)
 	return 0;
 }
 
-/* Get the list of existing slurmctld job records. */
-static void _update_jobs_global(lua_State *st)
+/* Push table of the existing slurmctld job records. */
+static void _push_job_list(lua_State *st)
 {
-	if (last_lua_jobs_update >= last_job_update) {
-		return;
-	}
-
-	lua_getglobal(st, "slurm");
 	lua_newtable(st);
 
-	list_for_each(job_list, _foreach_update_jobs_global, st);
-	last_lua_jobs_update = last_job_update;
-
-	lua_setfield(st, -2, "jobs");
-	lua_pop(st, 1);
+	if (job_list)
+		list_for_each(job_list, _foreach_push_job, st);
 }
 
-static int _resv_field(const slurmctld_resv_t *resv_ptr,
-                       const char *name)
+static int _resv_field(lua_State *L, const slurmctld_resv_t *resv_ptr,
+		       const char *name)
 {
 	if (resv_ptr == NULL) {
 		error("_resv_field: resv_ptr is NULL");
@@ -319,10 +323,10 @@ static int _resv_field_index(lua_State *L)
 	lua_getfield(L, -1, "_resv_ptr");
 	resv_ptr = lua_touserdata(L, -1);
 
-	return _resv_field(resv_ptr, name);
+	return _resv_field(L, resv_ptr, name);
 }
 
-static int _foreach_update_resvs_global(void *x, void *arg)
+static int _foreach_push_resv(void *x, void *arg)
 {
 	slurmctld_resv_t *resv_ptr = x;
 	lua_State *st = arg;
@@ -349,21 +353,68 @@ static int _foreach_update_resvs_global(void *x, void *arg)
 	return 0;
 }
 
-/* Get the list of existing slurmctld reservation records. */
-static void _update_resvs_global(lua_State *st)
+/* Push table of the existing slurmctld reservation records. */
+static void _push_resv_list(lua_State *st)
 {
-	if (last_lua_resv_update >= last_resv_update) {
-		return;
-	}
-
-	lua_getglobal(st, "slurm");
 	lua_newtable(st);
 
-	list_for_each(resv_list, _foreach_update_resvs_global, st);
-	last_lua_resv_update = last_resv_update;
+	if (resv_list)
+		list_for_each(resv_list, _foreach_push_resv, st);
+}
+
+/*
+ * Build slurm.jobs and slurm.reservations on first access instead of on every
+ * call, so scripts not using them never walk the job or reservation lists.
+ */
+static int _slurm_field_index(lua_State *L)
+{
+	const char *name;
+
+	if (lua_type(L, 2) != LUA_TSTRING)
+		return 0;
 
-	lua_setfield(st, -2, "reservations");
-	lua_pop(st, 1);
+	name = lua_tostring(L, 2);
+	if (!xstrcmp(name, "jobs"))
+		_push_job_list(L);
+	else if (!xstrcmp(name, "reservations"))
+		_push_resv_list(L);
+	else
+		return 0;
+
+	/* Keep the table in slurm until the records change */
+	lua_pushvalue(L, 2);
+	lua_pushvalue(L, -2);
+	lua_rawset(L, 1);
+
+	return 1;
+}
+
+/* Drop slurm.jobs and slurm.reservations built before records changed. */
+static void _reset_slurm_records(lua_ctx_t *ctx)
+{
+	lua_State *L = ctx->L;
+	bool reset_jobs = (ctx->jobs_update < last_job_update);
+	bool reset_resvs = (ctx->resv_update < last_resv_update);
+
+	if (!reset_jobs && !reset_resvs)
+		return;
+
+	lua_getglobal(L, "slurm");
+	if (lua_istable(L, -1)) {
+		if (reset_jobs) {
+			lua_pushstring(L, "jobs");
+			lua_pushnil(L);
+			lua_rawset(L, -3);
+			ctx->jobs_update = last_job_update;
+		}
+		if (reset_resvs) {
+			lua_pushstring(L, "reservations");
+			lua_pushnil(L);
+			lua_rawset(L, -3);
+			ctx->resv_update = last_resv_update;
+		}
+	}
+	lua_pop(L, 1);
 }
 
 /* Set fields in the job request structure on job submit or modify */
@@ -417,7 +468,8 @@ static int _set_job_env_field(lua_State *L)
 	return 0;
 }
 
-static int _job_env_field(const job_desc_msg_t *job_desc, const char *name)
+static int _job_env_field(lua_State *L, const job_desc_msg_t *job_desc,
+			  const char *name)
 {
 	char *name_eq = "";
 	int i, name_len;
@@ -457,7 +509,7 @@ static int _get_job_env_field_name(lua_State *L)
 {
 	const job_desc_msg_t *job_desc = lua_touserdata(L, 1);
 	const char *name = luaL_checkstring(L, 2);
-	return _job_env_field(job_desc, name);
+	return _job_env_field(L, job_desc, name);
 }
 
 /* Get fields in an existing slurmctld job_descriptor record */
@@ -470,10 +522,10 @@ static int _job_env_field_index(lua_State *L)
 	lua_getmetatable(L, -2);
 	lua_getfield(L, -1, "_job_desc");
 	job_desc = lua_touserdata(L, -1);
-	return _job_env_field(job_desc, name);
+	return _job_env_field(L, job_desc, name);
 }
 
-static void _push_job_env(job_desc_msg_t *job_desc)
+static void _push_job_env(lua_State *L, job_desc_msg_t *job_desc)
 {
 	lua_newtable(L);
 
@@ -490,7 +542,8 @@ static void _push_job_env(job_desc_msg_t *job_desc)
 	lua_setmetatable(L, -2);
 }
 
-static int _get_job_req_field(const job_desc_msg_t *job_desc, const char *name)
+static int _get_job_req_field(lua_State *L, const job_desc_msg_t *job_desc,
+			      const char *name)
 {
 	int i;
 
@@ -571,7 +624,7 @@ static int _get_job_req_field(const job_desc_msg_t *job_desc, const char *name)
 	} else if (!xstrcmp(name, "end_time")) {
 		lua_pushnumber(L, job_desc->end_time);
 	} else if (!xstrcmp(name, "environment")) {
-		_push_job_env((job_desc_msg_t *) job_desc); // No const
+		_push_job_env(L, (job_desc_msg_t *) job_desc); // No const
 	} else if (!xstrcmp(name, "exc_nodes")) {
 		lua_pushstring(L, job_desc->exc_nodes);
 	} else if (!xstrcmp(name, "extra")) {
@@ -755,7 +808,7 @@ static int _get_job_req_field_name(lua_State *L)
 	const job_desc_msg_t *job_desc = lua_touserdata(L, 1);
 	const char *name = luaL_checkstring(L, 2);
 
-	return _get_job_req_field(job_desc, name);
+	return _get_job_req_field(L, job_desc, name);
 }
 
 /* Get fields in an existing slurmctld job_descriptor record */
@@ -769,7 +822,7 @@ static int _get_job_req_field_index(lua_State *L)
 	lua_getfield(L, -1, "_job_desc");
 	job_desc = lua_touserdata(L, -1);
 
-	return _get_job_req_field(job_desc, name);
+	return _get_job_req_field(L, job_desc, name);
 }
 
 /* Set fields in the job request structure on job submit or modify */
@@ -1068,7 +1121,7 @@ static int _set_job_req_field(lua_State *L)
 	return 0;
 }
 
-static void _push_job_desc(job_desc_msg_t *job_desc)
+static void _push_job_desc(lua_State *L, job_desc_msg_t *job_desc)
 {
 	lua_newtable(L);
 
@@ -1085,7 +1138,7 @@ static void _push_job_desc(job_desc_msg_t *job_desc)
 	lua_setmetatable(L, -2);
 }
 
-static void _push_job_rec(job_record_t *job_ptr)
+static void _push_job_rec(lua_State *L, job_record_t *job_ptr)
 {
 	lua_newtable(L);
 
@@ -1105,7 +1158,8 @@ static void _push_job_rec(job_record_t *job_ptr)
  * This is an incomplete list of partition record fields. Add more as needed
  * and send patches to slurm-dev@schedmd.com
  */
-static int _part_rec_field(const part_record_t *part_ptr, const char *name)
+static int _part_rec_field(lua_State *L, const part_record_t *part_ptr,
+			   const char *name)
 {
 	if (part_ptr == NULL) {
 		error("_get_part_field: part_ptr is NULL");
@@ -1196,7 +1250,7 @@ static int _get_part_rec_field (lua_State *L)
 	const part_record_t *part_ptr = lua_touserdata(L, 1);
 	const char *name = luaL_checkstring(L, 2);
 
-	return _part_rec_field(part_ptr, name);
+	return _part_rec_field(L, part_ptr, name);
 }
 
 static int _part_rec_field_index(lua_State *L)
@@ -1208,7 +1262,7 @@ static int _part_rec_field_index(lua_State *L)
 	lua_getfield(L, -1, "_part_rec_ptr");
 	part_ptr = lua_touserdata(L, -1);
 
-	return _part_rec_field(part_ptr, name);
+	return _part_rec_field(L, part_ptr, name);
 }
 
 static bool _user_can_use_part(uint32_t user_id, uint32_t submit_uid,
@@ -1237,6 +1291,7 @@ static int _foreach_push_partition_list(void *x, void *arg)
 {
 	part_record_t *part_ptr = x;
 	foreach_part_list_args_t *args = arg;
+	lua_State *L = args->L;
 
 	if (!_user_can_use_part(args->user_id, args->submit_uid, part_ptr))
 		return 0;
@@ -1263,9 +1318,11 @@ static int _foreach_push_partition_list(void *x, void *arg)
 	return 0;
 }
 
-static void _push_partition_list(uint32_t user_id, uint32_t submit_uid)
+static void _push_partition_list(lua_State *L, uint32_t user_id,
+				 uint32_t submit_uid)
 {
 	foreach_part_list_args_t args = {
+		.L = L,
 		.submit_uid = submit_uid,
 		.user_id = user_id,
 	};
@@ -1279,15 +1336,24 @@ static void _push_partition_list(uint32_t user_id, uint32_t submit_uid)
 static int _log_lua_user_msg (lua_State *L)
 {
 	const char *msg = lua_tostring(L, -1);
+	lua_ctx_t *ctx;
 	char *tmp = NULL;
 
-	if (user_msg) {
-		xstrfmtcat(tmp, "%s\n%s", user_msg, msg);
-		xfree(user_msg);
-		user_msg = tmp;
+	lua_getfield(L, LUA_REGISTRYINDEX, LUA_CTX_KEY);
+	ctx = lua_touserdata(L, -1);
+	lua_pop(L, 1);
+
+	if (!ctx) {
+		/* Only possible while the script itself is being loaded */
+		debug("%s: %s: dropping user message: %s",
+		      plugin_type, __func__, msg);
+	} else if (ctx->user_msg) {
+		xstrfmtcat(tmp, "%s\n%s", ctx->user_msg, msg);
+		xfree(ctx->user_msg);
+		ctx->user_msg = tmp;
 		tmp = NULL;
 	} else {
-		user_msg = xstrdup(msg);
+		ctx->user_msg = xstrdup(msg);
 	}
 
 	return (0);
@@ -1317,13 +1383,13 @@ static void _register_local_output_functions(lua_State *L)
 	luaL_loadstring(L, tmp_string);
 	lua_setfield(L, -2, "log_user");
 
+	lua_newtable(L);
+	lua_pushcfunction(L, _slurm_field_index);
+	lua_setfield(L, -2, "__index");
+	lua_setmetatable(L, -2);
+
 	/* Must be always done after we register the slurm_functions */
 	lua_setglobal(L, "slurm");
-
-	last_lua_jobs_update = 0;
-	_update_jobs_global(L);
-	last_lua_resv_update = 0;
-	_update_resvs_global(L);
 }
 
 static void _register_lua_slurm_struct_functions(lua_State *st)
@@ -1347,6 +1413,74 @@ static void _loadscript_extra(lua_State *st)
 	_register_lua_slurm_struct_functions(st);
 }
 
+static void _free_lua_ctx(void *x)
+{
+	lua_ctx_t *ctx = x;
+
+	if (ctx->L)
+		lua_close(ctx->L);
+	xfree(ctx->user_msg);
+	xfree(ctx);
+}
+
+/* Take an idle Lua state from the pool, waiting for one if needed */
+static lua_ctx_t *_get_lua_ctx(void)
+{
+	lua_ctx_t *ctx;
+
+	slurm_mutex_lock(&lua_lock);
+	while (!(ctx = list_pop(lua_pool)))
+		slurm_cond_wait(&lua_cond, &lua_lock);
+	slurm_mutex_unlock(&lua_lock);
+
+	return ctx;
+}
+
+static void _put_lua_ctx(lua_ctx_t *ctx)
+{
+	slurm_mutex_lock(&lua_lock);
+	list_push(lua_pool, ctx);
+	slurm_cond_signal(&lua_cond);
+	slurm_mutex_unlock(&lua_lock);
+}
+
+/* Reload the script into ctx if it changed since ctx last loaded it */
+static int _load_lua_ctx(lua_ctx_t *ctx)
+{
+	lua_State *old = ctx->L;
+	int rc;
+
+	rc = slurm_lua_loadscript(&ctx->L, "job_submit/lua",
+				  lua_script_path, req_fxns,
+				  &ctx->load_time, _loadscript_extra);
+
+	/* Lets _log_lua_user_msg() find where to store messages */
+	if (ctx->L && (ctx->L != old)) {
+		lua_pushlightuserdata(ctx->L, ctx);
+		lua_setfield(ctx->L, LUA_REGISTRYINDEX, LUA_CTX_KEY);
+	}
+
+	return rc;
+}
+
+static void _get_config(void)
+{
+	char *opt;
+
+	lua_states = 1;
+	/*                      0123456789012345678901 */
+	if ((opt = xstrcasestr(slurm_conf.sched_params,
+			       "job_submit_lua_states="))) {
+		lua_states = atoi(opt + 22);
+		if (lua_states < 1) {
+			error("%s: Invalid job_submit_lua_states=%d, using 1",
+			      plugin_type, lua_states);
+			lua_states = 1;
+		}
+	}
+	debug("%s: job_submit_lua_states=%d", plugin_type, lua_states);
+}
+
 /*
  *  NOTE: The init callback should never be called multiple times,
  *   let alone called from multiple threads. Therefore, locking
@@ -1359,20 +1493,29 @@ int init(void)
 	if ((rc = slurm_lua_init()) != SLURM_SUCCESS)
 		return rc;
 	lua_script_path = get_extra_conf_path("job_submit.lua");
+	_get_config();
 
-	return slurm_lua_loadscript(&L, "job_submit/lua",
-				    lua_script_path, req_fxns,
-				    &lua_script_last_loaded,
-				    _loadscript_extra);
+	/*
+	 * Load every state now so submissions never wait on a script load.
+	 * The script is only compiled once, the other states reuse the chunk.
+	 */
+	lua_pool = list_create(_free_lua_ctx);
+	for (int i = 0; i < lua_states; i++) {
+		lua_ctx_t *ctx = xmalloc(sizeof(*ctx));
+
+		list_append(lua_pool, ctx);
+		if ((rc = _load_lua_ctx(ctx)))
+			break;
+	}
+
+	return rc;
 }
 
 int fini(void)
 {
-	if (L) {
+	if (lua_pool) {
 		debug3("%s: Unloading Lua script", __func__);
-		lua_close(L);
-		L = NULL;
-		lua_script_last_loaded = 0;
+		FREE_NULL_LIST(lua_pool);
 	}
 	xfree(lua_script_path);
 
@@ -1387,14 +1530,14 @@ extern int job_submit(job_desc_msg_t *job_desc, uint32_t submit_uid,
 		      char **err_msg)
 {
 	int rc;
-	slurm_mutex_lock (&lua_lock);
+	lua_ctx_t *ctx = _get_lua_ctx();
+	lua_State *L;
 
-	rc = slurm_lua_loadscript(&L, "job_submit/lua",
-				  lua_script_path, req_fxns,
-				  &lua_script_last_loaded, _loadscript_extra);
+	rc = _load_lua_ctx(ctx);
 
 	if (rc != SLURM_SUCCESS)
 		goto out;
+	L = ctx->L;
 
 	/*
 	 *  All lua script functions should have been verified during
@@ -1404,11 +1547,10 @@ extern int job_submit(job_desc_msg_t *job_desc, uint32_t submit_uid,
 	if (lua_isnil(L, -1))
 		goto out;
 
-	_update_jobs_global(L);
-	_update_resvs_global(L);
+	_reset_slurm_records(ctx);
 
-	_push_job_desc(job_desc);
-	_push_partition_list(job_desc->user_id, submit_uid);
+	_push_job_desc(L, job_desc);
+	_push_partition_list(L, job_desc->user_id, submit_uid);
 	lua_pushnumber(L, submit_uid);
 	slurm_lua_stack_dump(
 		"job_submit/lua", "job_submit, before lua_pcall", L);
@@ -1427,12 +1569,12 @@ extern int job_submit(job_desc_msg_t *job_desc, uint32_t submit_uid,
 	}
 	slurm_lua_stack_dump(
 		"job_submit/lua", "job_submit, after lua_pcall", L);
-	if (user_msg) {
-		*err_msg = user_msg;
-		user_msg = NULL;
+	if (ctx->user_msg) {
+		*err_msg = ctx->user_msg;
+		ctx->user_msg = NULL;
 	}
 
-out:	slurm_mutex_unlock (&lua_lock);
+out:	_put_lua_ctx(ctx);
 	return rc;
 }
 
@@ -1441,14 +1583,14 @@ extern int job_modify(job_desc_msg_t *job_desc, job_record_t *job_ptr,
 		      uint32_t submit_uid, char **err_msg)
 {
 	int rc;
-	slurm_mutex_lock (&lua_lock);
+	lua_ctx_t *ctx = _get_lua_ctx();
+	lua_State *L;
 
-	rc = slurm_lua_loadscript(&L, "job_submit/lua",
-				  lua_script_path, req_fxns,
-				  &lua_script_last_loaded, _loadscript_extra);
+	rc = _load_lua_ctx(ctx);
 
 	if (rc == SLURM_ERROR)
 		goto out;
+	L = ctx->L;
 
 	/*
 	 *  All lua script functions should have been verified during
@@ -1458,12 +1600,11 @@ extern int job_modify(job_desc_msg_t *job_desc, job_record_t *job_ptr,
 	if (lua_isnil(L, -1))
 		goto out;
 
-	_update_jobs_global(L);
-	_update_resvs_global(L);
+	_reset_slurm_records(ctx);
 
-	_push_job_desc(job_desc);
-	_push_job_rec(job_ptr);
-	_push_partition_list(job_ptr->user_id, submit_uid);
+	_push_job_desc(L, job_desc);
+	_push_job_rec(L, job_ptr);
+	_push_partition_list(L, job_ptr->user_id, submit_uid);
 	lua_pushnumber(L, submit_uid);
 	slurm_lua_stack_dump(
 		"job_submit/lua", "job_modify, before lua_pcall", L);
@@ -1482,11 +1623,11 @@ extern int job_modify(job_desc_msg_t *job_desc, job_record_t *job_ptr,
 	}
 	slurm_lua_stack_dump(
 		"job_submit/lua", "job_modify, after lua_pcall", L);
-	if (user_msg) {
-		*err_msg = user_msg;
-		user_msg = NULL;
+	if (ctx->user_msg) {
+		*err_msg = ctx->user_msg;
+		ctx->user_msg = NULL;
 	}
 
-out:	slurm_mutex_unlock (&lua_lock);
+out:	_put_lua_ctx(ctx);
 	return rc;
 }
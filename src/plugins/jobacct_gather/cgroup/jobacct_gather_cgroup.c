@@ -45,6 +45,7 @@
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/slurm_protocol_defs.h"
 #include "src/interfaces/acct_gather_energy.h"
+#include "src/interfaces/acct_gather_profile.h"
 #include "src/common/xstring.h"
 #include "src/interfaces/cgroup.h"
 #include "src/interfaces/proctrack.h"
@@ -82,6 +83,18 @@ const char plugin_type[] = "jobacct_gather/cgroup";
 const uint32_t plugin_version = SLURM_VERSION_NUMBER;
 
 static bool is_first_task = true;
+static bool cgroup_only = false;
+
+/* The step cgroup reported memory events or cpu pressure, poll right away */
+static void _acct_event(void)
+{
+	acct_gather_profile_timer_t *timer =
+		&acct_gather_profile_timer[PROFILE_TASK];
+
+	slurm_mutex_lock(&timer->notify_mutex);
+	slurm_cond_signal(&timer->notify);
+	slurm_mutex_unlock(&timer->notify_mutex);
+}
 
 static void _prec_extra(jag_prec_t *prec, uint32_t taskid)
 {
@@ -158,6 +171,18 @@ extern int init (void)
 	if (running_in_slurmstepd()) {
 		jag_common_init(cgroup_g_get_acct_units());
 
+		/*
+		 * With proctrack/cgroup every process of a task is in its
+		 * cgroup, so the cgroup files alone account for all of them.
+		 */
+		if (xstrcasestr(slurm_conf.job_acct_gather_params,
+				"CgroupOnly")) {
+			if (xstrcasestr(slurm_conf.proctrack_type, "cgroup"))
+				cgroup_only = true;
+			else
+				error("JobAcctGatherParams=CgroupOnly requires proctrack/cgroup, ignoring it");
+		}
+
 		if (xcpuinfo_init() != SLURM_SUCCESS) {
 			return SLURM_ERROR;
 		}
@@ -183,6 +208,8 @@ extern int fini (void)
 	if (running_in_slurmstepd()) {
 		/* Only destroy step if it has been previously created */
 		if (!is_first_task) {
+			if (cgroup_only)
+				cgroup_g_step_stop_acct_monitor();
 			/* Remove job/uid/step directories */
 			cgroup_g_step_destroy(CG_MEMORY);
 			cgroup_g_step_destroy(CG_CPUACCT);
@@ -222,6 +249,8 @@ extern void jobacct_gather_p_poll_data(list_t *task_list, uint64_t cont_id,
 		memset(&callbacks, 0, sizeof(jag_callbacks_t));
 		first = 0;
 		callbacks.prec_extra = _prec_extra;
+		if (cgroup_only)
+			callbacks.get_precs = jag_common_get_task_precs;
 	}
 
 	jag_common_poll_data(task_list, cont_id, &callbacks, profile);
@@ -252,6 +281,16 @@ extern int jobacct_gather_p_add_task(pid_t pid, jobacct_id_t *jobacct_id)
 			return SLURM_ERROR;
 		}
 		is_first_task = false;
+
+		if (cgroup_only &&
+		    ((rc = cgroup_g_step_start_acct_monitor(_acct_event)) !=
+		     SLURM_SUCCESS)) {
+			if (rc == ESLURM_NOT_SUPPORTED)
+				debug("cgroup plugin can't watch memory events or cpu pressure, only polling for accounting");
+			else
+				error("Cannot watch memory events or cpu pressure of the step");
+			rc = SLURM_SUCCESS;
+		}
 	}
 
 	if (cgroup_g_task_addto(CG_CPUACCT, jobacct_id->step, pid,
@@ -38,8 +38,10 @@
 
 #include <dirent.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <signal.h>
 #include <stdlib.h>
+#include <sys/resource.h>
 #include <time.h>
 #include <ctype.h>
 
@@ -49,6 +51,7 @@
 #include "src/interfaces/jobacct_gather.h"
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/slurm_protocol_defs.h"
+#include "src/common/xhash.h"
 #include "src/interfaces/acct_gather_energy.h"
 #include "src/interfaces/acct_gather_filesystem.h"
 #include "src/interfaces/acct_gather_interconnect.h"
@@ -73,19 +76,93 @@ char **assoc_mgr_tres_name_array;
 static int cpunfo_frequency = 0;
 static long conv_units = 0;
 list_t *prec_list = NULL;
+static xhash_t *prec_hash = NULL;	/* same precs as prec_list, by pid */
 
 static int my_pagesize = 0;
 static int energy_profile = ENERGY_DATA_NODE_ENERGY_UP;
 
-static int _find_prec(void *x, void *key)
+/* /proc descriptors kept open between polls, and how many we may keep */
+static int proc_fd_cnt = 0;
+static int proc_fd_max = 0;
+
+/* Reused between calls of _get_offspring_data() */
+static uint32_t visit_gen = 0;
+static jag_prec_t **walk_stack = NULL;
+static int walk_stack_size = 0;
+
+static void _prec_hash_id(void *item, const char **key, uint32_t *key_len)
 {
-	jag_prec_t *prec = (jag_prec_t *) x;
-	pid_t pid = *(pid_t *) key;
+	jag_prec_t *prec = item;
 
-	if (prec->pid == pid)
-		return 1;
+	*key = (const char *) &prec->pid;
+	*key_len = sizeof(prec->pid);
+}
 
-	return 0;
+static jag_prec_t *_find_prec(pid_t pid)
+{
+	return xhash_get(prec_hash, (const char *) &pid, sizeof(pid));
+}
+
+static void _close_proc_fd(int *fd)
+{
+	if (*fd < 0)
+		return;
+
+	close(*fd);
+	*fd = -1;
+	proc_fd_cnt--;
+}
+
+static void _close_prec_fds(jag_prec_t *prec)
+{
+	_close_proc_fd(&prec->io_fd);
+	_close_proc_fd(&prec->smaps_fd);
+	_close_proc_fd(&prec->stat_fd);
+	_close_proc_fd(&prec->statm_fd);
+}
+
+/*
+ * Read /proc/<pid>/<name> into sbuf. The file is kept open in *fd so the
+ * next poll only costs a pread(), unless we already hold proc_fd_max
+ * descriptors. A descriptor left over from an earlier poll fails once its
+ * process is gone, in which case the file is opened again in case the pid
+ * was reused.
+ *
+ * RET: number of bytes read or -1 on error
+ */
+static ssize_t _read_proc_file(pid_t pid, const char *name, int *fd,
+			       char *sbuf, size_t size)
+{
+	char path[64];
+	bool opened = false;
+	int attempts = 1;
+	ssize_t n;
+
+again:
+	if (*fd < 0) {
+		snprintf(path, sizeof(path), "/proc/%d/%s", (int) pid, name);
+		if ((*fd = open(path, O_RDONLY | O_CLOEXEC)) < 0)
+			return -1;
+		proc_fd_cnt++;
+		opened = true;
+	}
+
+	while (((n = pread(*fd, sbuf, size - 1, 0)) < 0) &&
+	       ((errno == EINTR) || (errno == EAGAIN)) && (attempts++ < 100))
+		;
+	if (n <= 0) {
+		_close_proc_fd(fd);
+		if (opened)
+			return -1;
+		opened = true;
+		goto again;
+	}
+	sbuf[n] = '\0';
+
+	if (proc_fd_cnt > proc_fd_max)
+		_close_proc_fd(fd);
+
+	return n;
 }
 
 /* return weighted frequency in mhz */
@@ -140,43 +217,66 @@ inline static bool _get_freq(char *str)
 	return true;
 }
 
-/*
- * collects the Pss value from /proc/<pid>/smaps
- */
-static int _get_pss(char *proc_smaps_file, jag_prec_t *prec)
+/* Return the value of a "Pss:" line of /proc/<pid>/smaps, 0 otherwise */
+static uint64_t _get_pss_line(char *line)
 {
-        uint64_t pss;
-	uint64_t p;
-        char line[128];
-        FILE *fp;
-	int i;
+	uint64_t p = 0;
 
-	fp = fopen(proc_smaps_file, "r");
-        if (!fp) {
-                return -1;
-        }
+	if (xstrncmp(line, "Pss:", 4))
+		return 0;
+
+	for (int i = 4; line[i] && (line[i] != '\n'); i++) {
+		if (!isdigit(line[i]))
+			continue;
+		if (sscanf(&line[i], "%"PRIu64"", &p) != 1)
+			p = 0;
+		break;
+	}
 
-	if (fcntl(fileno(fp), F_SETFD, FD_CLOEXEC) == -1)
-		error("%s: fcntl(%s): %m", __func__, proc_smaps_file);
-	pss = 0;
+	return p;
+}
+
+/*
+ * collects the Pss value from /proc/<pid>/smaps_rollup, or /proc/<pid>/smaps
+ * on kernels without it
+ */
+static int _get_pss(jag_prec_t *prec)
+{
+	static int use_smaps_rollup = -1;
+	uint64_t pss = 0;
+	char path[64];
+	char line[128];
+	FILE *fp;
 
-        while (fgets(line,sizeof(line),fp)) {
+	if (use_smaps_rollup == -1) {
+		snprintf(path, sizeof(path), "/proc/%d/smaps_rollup",
+			 (int) prec->pid);
+		use_smaps_rollup = !access(path, R_OK);
+	}
 
-                if (xstrncmp(line, "Pss:", 4) != 0) {
-                        continue;
-                }
+	if (use_smaps_rollup) {
+		/* A handful of lines, read it like the other small files */
+		char sbuf[2048], *next = sbuf;
+
+		if (_read_proc_file(prec->pid, "smaps_rollup", &prec->smaps_fd,
+				    sbuf, sizeof(sbuf)) < 0)
+			return -1;
+		while (next) {
+			pss += _get_pss_line(next);
+			if ((next = strchr(next, '\n')))
+				next++;
+		}
+		goto done;
+	}
 
-                for (i = 4; i < sizeof(line); i++) {
+	snprintf(path, sizeof(path), "/proc/%d/smaps", (int) prec->pid);
+	fp = fopen(path, "re");
+	if (!fp) {
+		return -1;
+	}
 
-                        if (!isdigit(line[i])) {
-                                continue;
-                        }
-                        if (sscanf(&line[i],"%"PRIu64"", &p) == 1) {
-                                pss += p;
-                        }
-                        break;
-                }
-        }
+	while (fgets(line, sizeof(line), fp))
+		pss += _get_pss_line(line);
 
 	/* Check for error
 	 */
@@ -185,8 +285,10 @@ static int _get_pss(char *proc_smaps_file, jag_prec_t *prec)
 		return -1;
 	}
 
-        fclose(fp);
-        /* Sanity checks */
+	fclose(fp);
+
+done:
+	/* Sanity checks */
 
         if (pss > 0) {
 		pss *= 1024; /* Scale KB to B */
@@ -194,8 +296,8 @@ static int _get_pss(char *proc_smaps_file, jag_prec_t *prec)
 			prec->tres_data[TRES_ARRAY_MEM].size_read = pss;
         }
 
-	log_flag(JAG, "%s read pss %"PRIu64" for process %s",
-		 __func__, pss, proc_smaps_file);
+	log_flag(JAG, "%s read pss %"PRIu64" for process %d",
+		 __func__, pss, prec->pid);
 
         return 0;
 }
@@ -301,7 +403,7 @@ again:
 
 /* _get_process_data_line() - get line of data from /proc/<pid>/stat
  *
- * IN:	in - input file descriptor
+ * IN:	sbuf - contents of the file, modified while parsing
  * OUT:	prec - the destination for the data
  *
  * RETVAL:	==0 - no valid data
@@ -312,9 +414,9 @@ again:
  * embedded ')'s. Such names confuse %s (see scanf(3)), so the string is split
  * and %39c is used instead. (except for embedded ')' "(%[^)]c)" would work.
  */
-static int _get_process_data_line(int in, jag_prec_t *prec) {
-	char sbuf[512], *tmp;
-	int num_read, nvals;
+static int _get_process_data_line(char *sbuf, jag_prec_t *prec) {
+	char *tmp;
+	int nvals;
 	char cmd[40], state[1];
 	int ppid, pgrp, session, tty_nr, tpgid;
 	long unsigned flags, minflt, cminflt, majflt, cmajflt;
@@ -323,11 +425,6 @@ static int _get_process_data_line(int in, jag_prec_t *prec) {
 	long unsigned f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13;
 	int exit_signal, last_cpu;
 
-	num_read = read(in, sbuf, (sizeof(sbuf) - 1));
-	if (num_read <= 0)
-		return 0;
-	sbuf[num_read] = '\0';
-
 	/*
 	 * split into "PID (cmd" and "<rest>" replace trailing ')' with NULL
 	 */
@@ -359,16 +456,9 @@ static int _get_process_data_line(int in, jag_prec_t *prec) {
 	if ((nvals < 37) || (rss < 0))
 		return 0;
 
-	/*
-	 * If current pid corresponds to a Light Weight Process (Thread POSIX)
-	 * or there was an error, skip it, we will only account the original
-	 * process (pid==tgid).
-	 */
-	if (_is_a_lwp(prec->pid))
-		return 0;
-
 	/* Copy the values that slurm records into our data structure */
 	prec->ppid  = ppid;
+	prec->starttime = starttime;
 
 	prec->tres_data[TRES_ARRAY_PAGES].size_read = majflt;
 	prec->tres_data[TRES_ARRAY_VMEM].size_read = vsize;
@@ -386,7 +476,7 @@ static int _get_process_data_line(int in, jag_prec_t *prec) {
 
 /* _get_process_memory_line() - get line of data from /proc/<pid>/statm
  *
- * IN:	in - input file descriptor
+ * IN:	sbuf - contents of the file
  * OUT:	prec - the destination for the data
  *
  * RETVAL:	==0 - no valid data
@@ -397,17 +487,11 @@ static int _get_process_data_line(int in, jag_prec_t *prec) {
  * and return the updated struct.
  *
  */
-static int _get_process_memory_line(int in, jag_prec_t *prec)
+static int _get_process_memory_line(char *sbuf, jag_prec_t *prec)
 {
-	char sbuf[256];
-	int num_read, nvals;
+	int nvals;
 	long int size, rss, share, text, lib, data, dt;
 
-	num_read = read(in, sbuf, (sizeof(sbuf) - 1));
-	if (num_read <= 0)
-		return 0;
-	sbuf[num_read] = '\0';
-
 	nvals = sscanf(sbuf,
 		       "%ld %ld %ld %ld %ld %ld %ld",
 		       &size, &rss, &share, &text, &lib, &data, &dt);
@@ -428,24 +512,20 @@ static int _get_process_memory_line(int in, jag_prec_t *prec)
 	return 1;
 }
 
-static int _remove_share_data(char *proc_statm_file, jag_prec_t *prec)
+static int _remove_share_data(jag_prec_t *prec)
 {
-	FILE *statm_fp = NULL;
-	int rc = 0, fd;
-
-	if (!(statm_fp = fopen(proc_statm_file, "r")))
-		return rc;  /* Assume the process went away */
-	fd = fileno(statm_fp);
-	if (fcntl(fd, F_SETFD, FD_CLOEXEC) == -1)
-		error("%s: fcntl(%s): %m", __func__, proc_statm_file);
-	rc = _get_process_memory_line(fd, prec);
-	fclose(statm_fp);
-	return rc;
+	char sbuf[256];
+
+	if (_read_proc_file(prec->pid, "statm", &prec->statm_fd, sbuf,
+			    sizeof(sbuf)) < 0)
+		return 0;  /* Assume the process went away */
+
+	return _get_process_memory_line(sbuf, prec);
 }
 
 /* _get_process_io_data_line() - get line of data from /proc/<pid>/io
  *
- * IN:	in - input file descriptor
+ * IN:	sbuf - contents of the file
  * OUT:	prec - the destination for the data
  *
  * RETVAL:	==0 - no valid data
@@ -456,25 +536,16 @@ static int _remove_share_data(char *proc_statm_file, jag_prec_t *prec)
  * wrchar: <# of characters written>
  *   . . .
  */
-static int _get_process_io_data_line(int in, jag_prec_t *prec) {
-	char sbuf[256];
+static int _get_process_io_data_line(char *sbuf, jag_prec_t *prec) {
 	char f1[7], f3[7];
-	int num_read, nvals;
+	int nvals;
 	uint64_t rchar, wchar;
 
-	num_read = read(in, sbuf, (sizeof(sbuf) - 1));
-	if (num_read <= 0)
-		return 0;
-	sbuf[num_read] = '\0';
-
 	nvals = sscanf(sbuf, "%s %"PRIu64" %s %"PRIu64"",
 		       f1, &rchar, f3, &wchar);
 	if (nvals < 4)
 		return 0;
 
-	if (_is_a_lwp(prec->pid))
-		return 0;
-
 	/* keep real value here since we aren't doubles */
 	prec->tres_data[TRES_ARRAY_FS_DISK].size_read = rchar;
 	prec->tres_data[TRES_ARRAY_FS_DISK].size_write = wchar;
@@ -496,25 +567,30 @@ static int _init_tres(jag_prec_t *prec, void *empty)
 	return SLURM_SUCCESS;
 }
 
-void _set_smaps_file(char **proc_smaps_file, pid_t pid)
+static jag_prec_t *_create_prec(pid_t pid, int tres_count)
 {
-	static int use_smaps_rollup = -1;
+	jag_prec_t *prec;
 
-	if (use_smaps_rollup == -1) {
-		xstrfmtcat(*proc_smaps_file, "/proc/%d/smaps_rollup", pid);
-		FILE *fd = fopen(*proc_smaps_file, "r");
-		if (fd) {
-			fclose(fd);
-			use_smaps_rollup = 1;
-			return;
-		}
-		use_smaps_rollup = 0;
+	if (!tres_count) {
+		assoc_mgr_lock_t locks = {
+			NO_LOCK, NO_LOCK, NO_LOCK, NO_LOCK,
+			READ_LOCK, NO_LOCK, NO_LOCK };
+		assoc_mgr_lock(&locks);
+		tres_count = g_tres_count;
+		assoc_mgr_unlock(&locks);
 	}
 
-	if (use_smaps_rollup)
-		xstrfmtcat(*proc_smaps_file, "/proc/%d/smaps_rollup", pid);
-	else
-		xstrfmtcat(*proc_smaps_file, "/proc/%d/smaps", pid);
+	prec = xmalloc(sizeof(*prec));
+	prec->pid = pid;
+	prec->io_fd = -1;
+	prec->smaps_fd = -1;
+	prec->stat_fd = -1;
+	prec->statm_fd = -1;
+	prec->tres_count = tres_count;
+	prec->tres_data = xcalloc(prec->tres_count,
+				  sizeof(acct_gather_data_t));
+
+	return prec;
 }
 
 static void _handle_stats(pid_t pid, jag_callbacks_t *callbacks, int tres_count)
@@ -522,11 +598,10 @@ static void _handle_stats(pid_t pid, jag_callbacks_t *callbacks, int tres_count)
 	static int no_share_data = -1;
 	static int use_pss = -1;
 	static int disable_gpu_acct = -1;
-	char *proc_file = NULL;
-	FILE *stat_fp = NULL;
-	FILE *io_fp = NULL;
-	int fd, fd2;
+	char sbuf[512];
+	unsigned long starttime;
 	jag_prec_t *prec = NULL;
+	bool created = false;
 
 	/* UsePSS and NoShare are only compatible with the linux plugin. */
 	if ((no_share_data == -1) &&
@@ -554,87 +629,78 @@ static void _handle_stats(pid_t pid, jag_callbacks_t *callbacks, int tres_count)
 			disable_gpu_acct = 0;
 	}
 
-	xstrfmtcat(proc_file, "/proc/%u/stat", pid);
-	if (!(stat_fp = fopen(proc_file, "r")))
-		return;  /* Assume the process went away */
 	/*
-	 * Close the file on exec() of user tasks.
-	 *
-	 * NOTE: If we fork() slurmstepd after the
-	 * fopen() above and before the fcntl() below,
-	 * then the user task may have this extra file
-	 * open, which can cause problems for
-	 * checkpoint/restart, but this should be a very rare
-	 * problem in practice.
+	 * Precs live as long as their process, so the files under /proc they
+	 * read from stay open (with O_CLOEXEC so user tasks never see them)
+	 * and only a new pid costs an allocation.
 	 */
-	fd = fileno(stat_fp);
-	if (fcntl(fd, F_SETFD, FD_CLOEXEC) == -1)
-		error("%s: fcntl(%s): %m", __func__, proc_file);
-
-	prec = xmalloc(sizeof(*prec));
-
-	if (!tres_count) {
-		assoc_mgr_lock_t locks = {
-			NO_LOCK, NO_LOCK, NO_LOCK, NO_LOCK,
-			READ_LOCK, NO_LOCK, NO_LOCK };
-		assoc_mgr_lock(&locks);
-		tres_count = g_tres_count;
-		assoc_mgr_unlock(&locks);
+	if (!(prec = _find_prec(pid))) {
+		prec = _create_prec(pid, tres_count);
+		created = true;
 	}
 
-	prec->tres_count = tres_count;
-	prec->tres_data = xcalloc(prec->tres_count,
-				  sizeof(acct_gather_data_t));
+	if (_read_proc_file(pid, "stat", &prec->stat_fd, sbuf,
+			    sizeof(sbuf)) < 0)
+		goto bail_out;  /* Assume the process went away */
 
 	(void)_init_tres(prec, NULL);
 
-	if (!_get_process_data_line(fd, prec)) {
-		fclose(stat_fp);
+	starttime = prec->starttime;
+	if (!_get_process_data_line(sbuf, prec))
 		goto bail_out;
-	}
 
-	fclose(stat_fp);
+	/*
+	 * If current pid corresponds to a Light Weight Process (Thread POSIX)
+	 * or there was an error, skip it, we will only account the original
+	 * process (pid==tgid). This only needs checking once per process.
+	 */
+	if (created || (starttime != prec->starttime)) {
+		int lwp = _is_a_lwp(pid);
+
+		if (lwp < 0) {
+			prec->starttime = 0;
+			goto bail_out;
+		}
+		prec->lwp = lwp;
+	}
+	if (prec->lwp) {
+		_close_proc_fd(&prec->io_fd);
+		_close_proc_fd(&prec->smaps_fd);
+		_close_proc_fd(&prec->statm_fd);
+		goto found;
+	}
 
 	if (!disable_gpu_acct)
 		gpu_g_usage_read(pid, prec->tres_data);
 
 	/* Remove shared data from rss */
-	if (no_share_data) {
-		xfree(proc_file);
-		xstrfmtcat(proc_file, "/proc/%u/statm", pid);
-		if (!_remove_share_data(proc_file, prec))
-			goto bail_out;
-	}
+	if (no_share_data && !_remove_share_data(prec))
+		goto bail_out;
 
 	/* Use PSS instead if RSS */
-	if (use_pss) {
-		xfree(proc_file);
-		_set_smaps_file(&proc_file, pid);
-		if (_get_pss(proc_file, prec) == -1)
-			goto bail_out;
-	}
+	if (use_pss && (_get_pss(prec) == -1))
+		goto bail_out;
 
-	xfree(proc_file);
-	xstrfmtcat(proc_file, "/proc/%u/io", pid);
-	if ((io_fp = fopen(proc_file, "r"))) {
-		fd2 = fileno(io_fp);
-		if (fcntl(fd2, F_SETFD, FD_CLOEXEC) == -1)
-			error("%s: fcntl: %m", __func__);
-		if (!_get_process_io_data_line(fd2, prec)) {
-			fclose(io_fp);
-			goto bail_out;
-		}
-		fclose(io_fp);
-	}
+	if ((_read_proc_file(pid, "io", &prec->io_fd, sbuf,
+			     sizeof(sbuf)) > 0) &&
+	    !_get_process_io_data_line(sbuf, prec))
+		goto bail_out;
 
-	destroy_jag_prec(list_remove_first(prec_list, _find_prec, &prec->pid));
-	list_append(prec_list, prec);
-	xfree(proc_file);
+found:
+	prec->completed = false;
+	if (created) {
+		list_append(prec_list, prec);
+		xhash_add(prec_hash, prec);
+	}
 	return;
 
 bail_out:
-	xfree(prec->tres_data);
-	xfree(prec);
+	/*
+	 * A prec kept from an earlier poll stays marked as completed, so it is
+	 * aggregated into its ancestor and removed like any ended process.
+	 */
+	if (created)
+		destroy_jag_prec(prec);
 	return;
 }
 
@@ -695,6 +761,32 @@ static list_t *_get_precs(list_t *task_list, uint64_t cont_id,
 	return prec_list;
 }
 
+extern list_t *jag_common_get_task_precs(list_t *task_list, uint64_t cont_id,
+					 jag_callbacks_t *callbacks)
+{
+	struct jobacctinfo *jobacct = NULL;
+	jag_prec_t *prec = NULL;
+	list_itr_t *itr;
+
+	xassert(task_list);
+
+	list_for_each(prec_list, _mark_as_completed, NULL);
+
+	itr = list_iterator_create(task_list);
+	while ((jobacct = list_next(itr))) {
+		if (!(prec = _find_prec(jobacct->pid))) {
+			prec = _create_prec(jobacct->pid, jobacct->tres_count);
+			list_append(prec_list, prec);
+			xhash_add(prec_hash, prec);
+		}
+		(void)_init_tres(prec, NULL);
+		prec->completed = false;
+	}
+	list_iterator_destroy(itr);
+
+	return prec_list;
+}
+
 static void _record_profile(struct jobacctinfo *jobacct)
 {
 	enum {
@@ -832,8 +924,16 @@ static void _record_profile(struct jobacctinfo *jobacct)
 extern void jag_common_init(long plugin_units)
 {
 	uint32_t profile_opt;
+	struct rlimit rlim;
 
 	prec_list = list_create(destroy_jag_prec);
+	prec_hash = xhash_init(_prec_hash_id, NULL);
+
+	/* Leave at least half of the descriptors to the rest of slurmstepd */
+	if (!getrlimit(RLIMIT_NOFILE, &rlim) && (rlim.rlim_cur != RLIM_INFINITY))
+		proc_fd_max = MIN(rlim.rlim_cur / 2, INT_MAX);
+	else
+		proc_fd_max = 512;
 
 	acct_gather_profile_g_get(ACCT_GATHER_PROFILE_RUNNING,
 				  &profile_opt);
@@ -854,7 +954,10 @@ extern void jag_common_init(long plugin_units)
 
 extern void jag_common_fini(void)
 {
+	xhash_free(prec_hash);
 	FREE_NULL_LIST(prec_list);
+	xfree(walk_stack);
+	walk_stack_size = 0;
 }
 
 extern void destroy_jag_prec(void *object)
@@ -864,6 +967,7 @@ extern void destroy_jag_prec(void *object)
 	if (!prec)
 		return;
 
+	_close_prec_fds(prec);
 	xfree(prec->tres_data);
 	xfree(prec);
 	return;
@@ -897,31 +1001,53 @@ static void _print_jag_prec(jag_prec_t *prec)
 	log_flag(JAG, "usec \t%f", prec->usec);
 }
 
-static int _list_find_prec_by_pid(void *x, void *key)
+static int _reset_links(void *x, void *empty)
 {
-        jag_prec_t *j = (jag_prec_t *) x;
-        pid_t pid = *(pid_t *) key;
+	jag_prec_t *prec = x;
 
-        if (!j->visited && (j->pid == pid))
-                return 1;
-        return 0;
+	prec->child = NULL;
+	prec->sibling = NULL;
+
+	return SLURM_SUCCESS;
 }
 
-static int _list_find_prec_by_ppid(void *x, void *key)
+static int _link_to_parent(void *x, void *empty)
 {
-        jag_prec_t *j = (jag_prec_t *) x;
-        pid_t pid = *(pid_t *) key;
+	jag_prec_t *prec = x, *parent;
 
-        if (!j->visited && (j->ppid == pid))
-                return 1;
-        return 0;
+	if (prec->lwp || (prec->ppid == prec->pid) ||
+	    !(parent = _find_prec(prec->ppid)) || parent->lwp)
+		return SLURM_SUCCESS;
+
+	prec->sibling = parent->child;
+	parent->child = prec;
+
+	return SLURM_SUCCESS;
 }
 
-static int _reset_visited(jag_prec_t *prec, void *empty)
+/*
+ * Build the process tree of this poll once so each task only walks its own
+ * descendants instead of searching the whole prec_list for every child.
+ */
+static void _link_precs(void)
 {
-	prec->visited = false;
+	(void)list_for_each(prec_list, _reset_links, NULL);
+	(void)list_for_each(prec_list, _link_to_parent, NULL);
+}
 
-	return SLURM_SUCCESS;
+static int _purge_prec(void *x, void *key)
+{
+	jag_prec_t *prec = x;
+
+	if (!prec->purge && !(prec->lwp && prec->completed)) {
+		/* Kept around, but nothing left to read for it */
+		if (prec->completed)
+			_close_prec_fds(prec);
+		return 0;
+	}
+
+	xhash_delete(prec_hash, (const char *) &prec->pid, sizeof(prec->pid));
+	return 1;
 }
 
 static void _aggregate_prec(jag_prec_t *prec, jag_prec_t *ancestor)
@@ -972,7 +1098,6 @@ static void _aggregate_prec(jag_prec_t *prec, jag_prec_t *ancestor)
 					prec->tres_data[i].size_write;
 		}
 	}
-	prec->visited = true;
 }
 
 /*
@@ -989,6 +1114,8 @@ static void _aggregate_prec(jag_prec_t *prec, jag_prec_t *ancestor)
  *			tree.
  *	pid		The process for which we are currently looking
  *			for offspring.
+ *			The tree is walked through the child/sibling links
+ *			built by _link_precs() for this poll.
  * IN/OUT:
  *      permanent_anc Pointer to the original ancestor. Changes to
  *	              it are saved, so we can permanently save
@@ -1003,41 +1130,50 @@ static void _get_offspring_data(list_t *prec_list, jag_prec_t *ancestor,
 {
 	jag_prec_t *prec = NULL;
 	jag_prec_t *prec_tmp = NULL;
-	list_t *tmp_list = NULL;
-
-	/* reset all precs to be not visited */
-	(void)list_for_each(prec_list, (ListForF)_reset_visited, NULL);
+	int depth = 0;
 
 	/* See if we can find a prec from the given pid */
-	if (!(prec = list_find_first(prec_list, _list_find_prec_by_pid, &pid)))
+	if (!(prec = _find_prec(pid)) || prec->purge)
 		return;
 
-	prec->visited = true;
+	/* A new generation makes every prec not visited */
+	if (!++visit_gen)
+		visit_gen++;
+	prec->visited = visit_gen;
 
-	tmp_list = list_create(NULL);
-	list_append(tmp_list, prec);
+	if (!walk_stack_size) {
+		walk_stack_size = 64;
+		walk_stack = xcalloc(walk_stack_size, sizeof(*walk_stack));
+	}
+	walk_stack[depth++] = prec;
 
-	while ((prec_tmp = list_dequeue(tmp_list))) {
-		while ((prec = list_find_first(prec_list,
-					      _list_find_prec_by_ppid,
-					       &(prec_tmp->pid)))) {
+	while (depth) {
+		prec_tmp = walk_stack[--depth];
+		for (prec = prec_tmp->child; prec; prec = prec->sibling) {
+			if ((prec->visited == visit_gen) || prec->purge)
+				continue;
+			prec->visited = visit_gen;
 			_aggregate_prec(prec, ancestor);
 			/*
 			 * If the prec disappeared (pid is dead) aggregate its
-			 * statistics and remove it from the prec_list to avoid
-			 * having to agreggate it on every iteration.
+			 * statistics and remove it from the prec_list once
+			 * this poll is done to avoid having to agreggate it on
+			 * every iteration.
 			 */
 			if (prec->completed) {
 				_aggregate_prec(prec, permanent_anc);
 				log_flag(JAG, "Removing completed process %d",
 					 prec->pid);
-				list_remove_first(prec_list, _find_prec,
-						  &prec->pid);
+				prec->purge = true;
+			}
+			if (depth == walk_stack_size) {
+				walk_stack_size *= 2;
+				xrecalloc(walk_stack, walk_stack_size,
+					  sizeof(*walk_stack));
 			}
-			list_append(tmp_list, prec);
+			walk_stack[depth++] = prec;
 		}
 	}
-	FREE_NULL_LIST(tmp_list);
 
 	return;
 }
@@ -1080,6 +1216,7 @@ extern void jag_common_poll_data(list_t *task_list, uint64_t cont_id,
 
 	(void)list_for_each(prec_list, (ListForF)_init_tres, NULL);
 	(*(callbacks->get_precs))(task_list, cont_id, callbacks);
+	_link_precs();
 
 	if (!list_count(prec_list) || !task_list || !list_count(task_list))
 		goto finished;	/* We have no business being here! */
@@ -1089,8 +1226,7 @@ extern void jag_common_poll_data(list_t *task_list, uint64_t cont_id,
 		double cpu_calc;
 		double last_total_cputime;
 		jag_prec_t *permanent_anc;
-		if (!(prec = list_find_first(prec_list, _find_prec,
-					     &jobacct->pid)))
+		if (!(prec = _find_prec(jobacct->pid)) || prec->purge)
 			continue;
 		/*
 		 * We can't use the prec from the list as we need to keep it in
@@ -1278,5 +1414,7 @@ extern void jag_common_poll_data(list_t *task_list, uint64_t cont_id,
 						total_job_vsize);
 
 finished:
+	/* Drop what the walks aggregated and threads that went away */
+	(void)list_delete_all(prec_list, _purge_prec, NULL);
 	processing = 0;
 }
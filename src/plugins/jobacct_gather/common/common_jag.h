@@ -42,13 +42,22 @@
 #include "src/common/list.h"
 
 typedef struct jag_prec {	/* process record */
-	bool	visited;
+	uint32_t visited;	/* walk generation that last visited this */
 	int	act_cpufreq;	/* actual average cpu frequency */
+	struct jag_prec *child;	/* first child in the current process tree */
 	bool    completed;       /* the process no longer exists */
+	int	io_fd;		/* /proc/<pid>/io kept open between polls */
 	int	last_cpu;	/* last cpu */
+	bool	lwp;		/* thread of another process, never accounted */
 	pid_t	pid;
 	pid_t	ppid;
+	bool	purge;		/* completed and aggregated, remove after poll */
+	struct jag_prec *sibling; /* next child of the same parent */
+	int	smaps_fd;	/* /proc/<pid>/smaps_rollup kept open */
 	double  ssec; /* system cpu time: To normalize divide by system hertz */
+	unsigned long starttime; /* from /proc/<pid>/stat, detects pid reuse */
+	int	stat_fd;	/* /proc/<pid>/stat kept open between polls */
+	int	statm_fd;	/* /proc/<pid>/statm kept open between polls */
 	/* Units of tres_[in|out] should be raw numbers (bytes/joules) */
 	int     tres_count; /* count of tres in the tres_data */
 	acct_gather_data_t *tres_data; /* array of tres data */
@@ -70,4 +79,11 @@ extern void destroy_jag_prec(void *object);
 extern void jag_common_poll_data(list_t *task_list, uint64_t cont_id,
 				 jag_callbacks_t *callbacks, bool profile);
 
+/*
+ * get_precs callback for plugins gathering all usage through prec_extra, e.g.
+ * from the task cgroups. Keeps one prec per task and never reads /proc.
+ */
+extern list_t *jag_common_get_task_precs(list_t *task_list, uint64_t cont_id,
+					 jag_callbacks_t *callbacks);
+
 #endif
@@ -35,19 +35,21 @@
 
 #include "config.h"
 
-#if HAVE_JSON_C_INC
-#include <json-c/json.h>
-#else
-#include <json/json.h>
-#endif
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "slurm/slurm.h"
 #include "src/common/slurm_xlator.h"
 
 #include "src/common/data.h"
 #include "src/common/log.h"
+#include "src/common/pack.h"
 #include "src/common/read_config.h"
 #include "src/common/xassert.h"
+#include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 #include "src/interfaces/serializer.h"
 
@@ -85,8 +87,6 @@ const char *mime_types[] = {
 	NULL
 };
 
-static json_object *_data_to_json(const data_t *d);
-
 extern int serializer_p_init(void)
 {
 	log_flag(DATA, "loaded");
@@ -102,131 +102,716 @@ extern int serializer_p_fini(void)
 }
 
 
-static json_object *_try_parse(const char *src, size_t stringlen,
-			       struct json_tokener *tok)
+#define MAGIC_READER 0x1ab1ee1f
+/* same nesting limit as the default json-c tokener */
+#define JSON_MAX_DEPTH 32
+/* strings shorter than this are stored inline in data_t without allocation */
+#define JSON_INLINE_STRING 8
+
+typedef struct {
+	int magic; /* MAGIC_READER */
+	const char *start;
+	const char *pos;
+	const char *end;
+	int depth;
+	char *key; /* scratch buffer for dictionary keys */
+	size_t key_size;
+	const char *err; /* description of parsing failure */
+} reader_t;
+
+static int _read_value(reader_t *r, data_t *d);
+
+static int _read_fail(reader_t *r, const char *err)
+{
+	xassert(r->magic == MAGIC_READER);
+
+	if (!r->err)
+		r->err = err;
+
+	return ESLURM_REST_FAIL_PARSING;
+}
+
+/* Get next character or -1 at end of source */
+static int _peek(const reader_t *r)
+{
+	if ((r->pos >= r->end) || !*r->pos)
+		return -1;
+
+	return (unsigned char) *r->pos;
+}
+
+/* Skip white space and comments (which json-c also accepts) */
+static int _skip_space(reader_t *r)
 {
-	json_object *jobj = json_tokener_parse_ex(tok, src, stringlen);
+	while (r->pos < r->end) {
+		switch (*r->pos) {
+		case ' ':
+		case '\t':
+		case '\n':
+		case '\r':
+			r->pos++;
+			break;
+		case '/':
+			if (((r->pos + 1) < r->end) && (r->pos[1] == '/')) {
+				const char *eol = memchr(r->pos, '\n',
+							 (r->end - r->pos));
+				r->pos = (eol ? (eol + 1) : r->end);
+			} else if (((r->pos + 1) < r->end) &&
+				   (r->pos[1] == '*')) {
+				const char *c = r->pos + 2;
+
+				while ((c = memchr(c, '*', (r->end - c))) &&
+				       ((c + 1) < r->end) && (c[1] != '/'))
+					c++;
+
+				if (!c || ((c + 1) >= r->end))
+					return _read_fail(r,
+							  "unterminated comment");
+				r->pos = c + 2;
+			} else {
+				return SLURM_SUCCESS;
+			}
+			break;
+		default:
+			return SLURM_SUCCESS;
+		}
+	}
+
+	return SLURM_SUCCESS;
+}
 
-	if (jobj == NULL) {
-		enum json_tokener_error jerr = json_tokener_get_error(tok);
-		error("%s: JSON parsing error %zu bytes: %s",
-		      __func__, stringlen, json_tokener_error_desc(jerr));
-		return NULL;
+static int _hex4(const char *src)
+{
+	int value = 0;
+
+	for (int i = 0; i < 4; i++) {
+		const char c = src[i];
+
+		value <<= 4;
+		if ((c >= '0') && (c <= '9'))
+			value |= c - '0';
+		else if ((c >= 'a') && (c <= 'f'))
+			value |= c - 'a' + 10;
+		else if ((c >= 'A') && (c <= 'F'))
+			value |= c - 'A' + 10;
+		else
+			return -1;
+	}
+
+	return value;
+}
+
+static char *_utf8_encode(char *dst, uint32_t cp)
+{
+	if (cp < 0x80) {
+		*dst++ = cp;
+	} else if (cp < 0x800) {
+		*dst++ = 0xc0 | (cp >> 6);
+		*dst++ = 0x80 | (cp & 0x3f);
+	} else if (cp < 0x10000) {
+		*dst++ = 0xe0 | (cp >> 12);
+		*dst++ = 0x80 | ((cp >> 6) & 0x3f);
+		*dst++ = 0x80 | (cp & 0x3f);
+	} else {
+		*dst++ = 0xf0 | (cp >> 18);
+		*dst++ = 0x80 | ((cp >> 12) & 0x3f);
+		*dst++ = 0x80 | ((cp >> 6) & 0x3f);
+		*dst++ = 0x80 | (cp & 0x3f);
+	}
+
+	return dst;
+}
+
+/*
+ * Decode escaped string contents into dst which must have room for at least
+ * (end - src + 1) bytes as decoding never grows the string.
+ * RET number of bytes written (without '\0') or -1 on invalid escape
+ */
+static ssize_t _decode_string(const char *src, const char *end, char *dst)
+{
+	char *start = dst;
+
+	while (src < end) {
+		const char *esc = memchr(src, '\\', (end - src));
+		int cp;
+
+		if (!esc) {
+			memcpy(dst, src, (end - src));
+			dst += end - src;
+			break;
+		}
+
+		memcpy(dst, src, (esc - src));
+		dst += esc - src;
+		src = esc + 1;
+
+		if (src >= end)
+			return -1;
+
+		switch (*src++) {
+		case '"':
+			*dst++ = '"';
+			break;
+		case '\'':
+			*dst++ = '\'';
+			break;
+		case '\\':
+			*dst++ = '\\';
+			break;
+		case '/':
+			*dst++ = '/';
+			break;
+		case 'b':
+			*dst++ = '\b';
+			break;
+		case 'f':
+			*dst++ = '\f';
+			break;
+		case 'n':
+			*dst++ = '\n';
+			break;
+		case 'r':
+			*dst++ = '\r';
+			break;
+		case 't':
+			*dst++ = '\t';
+			break;
+		case 'u':
+			if (((end - src) < 4) || ((cp = _hex4(src)) < 0))
+				return -1;
+			src += 4;
+
+			/* combine UTF-16 surrogate pair */
+			if ((cp >= 0xd800) && (cp <= 0xdbff) &&
+			    ((end - src) >= 6) && (src[0] == '\\') &&
+			    (src[1] == 'u')) {
+				int low = _hex4(src + 2);
+
+				if ((low >= 0xdc00) && (low <= 0xdfff)) {
+					cp = 0x10000 + ((cp - 0xd800) << 10) +
+					     (low - 0xdc00);
+					src += 6;
+				}
+			}
+
+			dst = _utf8_encode(dst, cp);
+			break;
+		default:
+			return -1;
+		}
+	}
+
+	*dst = '\0';
+	return (dst - start);
+}
+
+/*
+ * Find end of quoted string starting at r->pos.
+ * IN/OUT r - reader with pos at opening quote, moved past closing quote
+ * OUT str_start - first byte of string contents
+ * OUT str_end - closing quote
+ * OUT escaped - true if string contains escapes
+ */
+static int _scan_string(reader_t *r, const char **str_start,
+			const char **str_end, bool *escaped)
+{
+	const char quote = *r->pos;
+	const char *p = r->pos + 1;
+	const char *q = NULL;
+
+	*str_start = p;
+	*escaped = false;
+
+	while (true) {
+		const char *esc;
+
+		/*
+		 * Let memchr() do the heavy lifting for long strings. The quote
+		 * found last time is still the candidate unless it was escaped,
+		 * so every byte is only searched once.
+		 */
+		if ((!q || (q < p)) &&
+		    !(q = memchr(p, quote, (r->end - p))))
+			return _read_fail(r, "unterminated string");
+
+		if (!(esc = memchr(p, '\\', (q - p)))) {
+			*str_end = q;
+			r->pos = q + 1;
+			return SLURM_SUCCESS;
+		}
+
+		*escaped = true;
+		/* skip escaped character which may be the quote */
+		p = esc + 2;
+
+		if (p > r->end)
+			return _read_fail(r, "unterminated string");
+	}
+}
+
+static int _read_string(reader_t *r, data_t *d)
+{
+	const char *start, *end;
+	bool escaped;
+	ssize_t len;
+	char *str;
+	int rc;
+
+	if ((rc = _scan_string(r, &start, &end, &escaped)))
+		return rc;
+
+	if ((end - start) < JSON_INLINE_STRING) {
+		char tmp[JSON_INLINE_STRING];
+
+		if (_decode_string(start, end, tmp) < 0)
+			return _read_fail(r, "invalid escape in string");
+
+		data_set_string(d, tmp);
+		return SLURM_SUCCESS;
+	}
+
+	str = xmalloc((end - start) + 1);
+
+	if (!escaped) {
+		memcpy(str, start, (end - start));
+		len = end - start;
+	} else if ((len = _decode_string(start, end, str)) < 0) {
+		xfree(str);
+		return _read_fail(r, "invalid escape in string");
+	}
+
+	if (len < JSON_INLINE_STRING) {
+		/* escapes made string short enough to store inline */
+		data_set_string(d, str);
+		xfree(str);
+	} else {
+		data_set_string_own(d, str);
+	}
+
+	return SLURM_SUCCESS;
+}
+
+/* Read dictionary key into reusable r->key */
+static int _read_key(reader_t *r)
+{
+	const char *start, *end;
+	bool escaped;
+	int rc;
+
+	if ((rc = _scan_string(r, &start, &end, &escaped)))
+		return rc;
+
+	if (r->key_size <= (end - start)) {
+		r->key_size = (end - start) + 1;
+		xrealloc_nz(r->key, r->key_size);
+	}
+
+	if (!escaped) {
+		memcpy(r->key, start, (end - start));
+		r->key[end - start] = '\0';
+	} else if (_decode_string(start, end, r->key) < 0) {
+		return _read_fail(r, "invalid escape in key");
+	}
+
+	return SLURM_SUCCESS;
+}
+
+static int _read_number(reader_t *r, data_t *d)
+{
+	const char *start = r->pos;
+	bool is_float = false;
+	char tmp[64];
+	size_t len;
+	char *end = NULL;
+
+	while (r->pos < r->end) {
+		const char c = *r->pos;
+
+		if ((c == '.') || (c == 'e') || (c == 'E'))
+			is_float = true;
+		else if (!isdigit((unsigned char) c) && (c != '-') &&
+			 (c != '+'))
+			break;
+
+		r->pos++;
+	}
+
+	/* copy into NUL terminated buffer as source may not be terminated */
+	if ((len = (r->pos - start)) >= sizeof(tmp))
+		return _read_fail(r, "number too long");
+
+	memcpy(tmp, start, len);
+	tmp[len] = '\0';
+
+	errno = 0;
+	if (!is_float) {
+		int64_t value = strtoll(tmp, &end, 10);
+
+		if (!errno && (end == (tmp + len))) {
+			data_set_int(d, value);
+			return SLURM_SUCCESS;
+		}
+	}
+
+	/* floats and integers too large for int64_t */
+	errno = 0;
+	data_set_float(d, strtod(tmp, &end));
+
+	if (!len || (end != (tmp + len)))
+		return _read_fail(r, "invalid number");
+
+	return SLURM_SUCCESS;
+}
+
+/* Match literal word (case insensitive like json-c) */
+static bool _read_word(reader_t *r, const char *word)
+{
+	const size_t len = strlen(word);
+
+	if (((r->end - r->pos) < len) || strncasecmp(r->pos, word, len))
+		return false;
+
+	/* reject longer words such as "nullable" */
+	if (((r->pos + len) < r->end) && isalnum((unsigned char) r->pos[len]))
+		return false;
+
+	r->pos += len;
+	return true;
+}
+
+static int _read_list(reader_t *r, data_t *d)
+{
+	int rc;
+
+	data_set_list(d);
+	r->pos++;
+
+	if ((rc = _skip_space(r)))
+		return rc;
+
+	while (_peek(r) != ']') {
+		if ((rc = _read_value(r, data_list_append(d))) ||
+		    (rc = _skip_space(r)))
+			return rc;
+
+		if (_peek(r) == ',') {
+			/* json-c also accepts a trailing comma */
+			r->pos++;
+			if ((rc = _skip_space(r)))
+				return rc;
+		} else if (_peek(r) != ']') {
+			return _read_fail(r, "expected ',' or ']'");
+		}
+	}
+
+	r->pos++;
+	return SLURM_SUCCESS;
+}
+
+static int _read_dict(reader_t *r, data_t *d)
+{
+	int rc;
+
+	data_set_dict(d);
+	r->pos++;
+
+	if ((rc = _skip_space(r)))
+		return rc;
+
+	while (_peek(r) != '}') {
+		if ((_peek(r) != '"') && (_peek(r) != '\''))
+			return _read_fail(r, "expected quoted key");
+
+		if ((rc = _read_key(r)) || (rc = _skip_space(r)))
+			return rc;
+
+		if (_peek(r) != ':')
+			return _read_fail(r, "expected ':'");
+		r->pos++;
+
+		if ((rc = _skip_space(r)) ||
+		    (rc = _read_value(r, data_key_set(d, r->key))) ||
+		    (rc = _skip_space(r)))
+			return rc;
+
+		if (_peek(r) == ',') {
+			/* json-c also accepts a trailing comma */
+			r->pos++;
+			if ((rc = _skip_space(r)))
+				return rc;
+		} else if (_peek(r) != '}') {
+			return _read_fail(r, "expected ',' or '}'");
+		}
 	}
-	if (tok->char_offset < stringlen)
-		log_flag(DATA, "%s: Extra %zu characters after JSON string detected",
-		     __func__, (stringlen - tok->char_offset));
 
-	return jobj;
+	r->pos++;
+	return SLURM_SUCCESS;
 }
 
-static data_t *_json_to_data(json_object *jobj, data_t *d)
+static int _read_value(reader_t *r, data_t *d)
 {
-	size_t arraylen = 0;
+	int rc;
 
-	if (!d)
-		d = data_new();
+	switch (_peek(r)) {
+	case '{':
+	case '[':
+		if (++r->depth > JSON_MAX_DEPTH)
+			return _read_fail(r, "nesting too deep");
+
+		if (_peek(r) == '{')
+			rc = _read_dict(r, d);
+		else
+			rc = _read_list(r, d);
+
+		r->depth--;
+		return rc;
+	case '"':
+	case '\'':
+		return _read_string(r, d);
+	case '-':
+		if (_read_word(r, "-Infinity")) {
+			data_set_float(d, -INFINITY);
+			return SLURM_SUCCESS;
+		}
+		/* fall through */
+	case '0':
+	case '1':
+	case '2':
+	case '3':
+	case '4':
+	case '5':
+	case '6':
+	case '7':
+	case '8':
+	case '9':
+		return _read_number(r, d);
+	}
 
-	switch (json_object_get_type(jobj)) {
-	case json_type_null:
+	if (_read_word(r, "true"))
+		data_set_bool(d, true);
+	else if (_read_word(r, "false"))
+		data_set_bool(d, false);
+	else if (_read_word(r, "null"))
 		data_set_null(d);
-		break;
-	case json_type_boolean:
-		data_set_bool(d, json_object_get_boolean(jobj));
-		break;
-	case json_type_double:
-		data_set_float(d, json_object_get_double(jobj));
-		break;
-	case json_type_int:
-		data_set_int(d, json_object_get_int64(jobj));
-		break;
-	case json_type_object:
-		data_set_dict(d);
-		/* warning: json_object_object_foreach is an evil macro */
-		json_object_object_foreach(jobj, key, val) {
-			_json_to_data(val, data_key_set(d, key));
+	else if (_read_word(r, "NaN"))
+		data_set_float(d, NAN);
+	else if (_read_word(r, "Infinity"))
+		data_set_float(d, INFINITY);
+	else
+		return _read_fail(r, "unexpected character");
+
+	return SLURM_SUCCESS;
+}
+
+#define MAGIC_WRITER 0x1ab0ee1f
+#define JSON_INDENT "  "
+
+typedef struct {
+	int magic; /* MAGIC_WRITER */
+	buf_t *buf;
+	bool pretty;
+	bool first; /* next entry is first in dict or list */
+	int depth;
+	int rc;
+} writer_t;
+
+static void _write_data(writer_t *w, const data_t *d);
+
+static void _write(writer_t *w, const char *src, size_t len)
+{
+	xassert(w->magic == MAGIC_WRITER);
+
+	if (w->rc || !len)
+		return;
+
+	/* always leave room for the trailing '\0' */
+	if (remaining_buf(w->buf) <= len) {
+		/* double the size, large dumps are written a token at a time */
+		uint32_t grow = MAX(size_buf(w->buf), (len + 1));
+
+		if ((((uint64_t) size_buf(w->buf)) + grow) > MAX_BUF_SIZE)
+			grow = len + 1;
+		if ((w->rc = try_grow_buf(w->buf, grow)))
+			return;
+	}
+
+	memcpy((w->buf->head + w->buf->processed), src, len);
+	w->buf->processed += len;
+	w->buf->head[w->buf->processed] = '\0';
+}
+
+#define _write_str(w, str) _write(w, str, strlen(str))
+
+static void _write_indent(writer_t *w)
+{
+	if (!w->pretty)
+		return;
+
+	_write(w, "\n", 1);
+	for (int i = 0; i < w->depth; i++)
+		_write(w, JSON_INDENT, (sizeof(JSON_INDENT) - 1));
+}
+
+/* Write string as quoted JSON string, escaped the same way as json-c */
+static void _write_string(writer_t *w, const char *str)
+{
+	const char *start = str;
+
+	_write(w, "\"", 1);
+
+	for (; str && *str; str++) {
+		const unsigned char c = *str;
+		char esc[7];
+
+		switch (c) {
+		case '"':
+		case '\\':
+		case '/':
+			esc[0] = '\\';
+			esc[1] = c;
+			esc[2] = '\0';
+			break;
+		case '\b':
+			strcpy(esc, "\\b");
+			break;
+		case '\f':
+			strcpy(esc, "\\f");
+			break;
+		case '\n':
+			strcpy(esc, "\\n");
+			break;
+		case '\r':
+			strcpy(esc, "\\r");
+			break;
+		case '\t':
+			strcpy(esc, "\\t");
+			break;
+		default:
+			if (c >= 0x20)
+				continue;
+			snprintf(esc, sizeof(esc), "\\u%04x", c);
 		}
-		break;
-	case json_type_array:
-		arraylen = json_object_array_length(jobj);
-		data_set_list(d);
-		for (size_t i = 0; i < arraylen; i++)
-			_json_to_data(json_object_array_get_idx(jobj, i),
-				      data_list_append(d));
-		break;
-	case json_type_string:
-		data_set_string(d, json_object_get_string(jobj));
-		break;
-	default:
-		fatal_abort("%s: unknown JSON type", __func__);
-	};
 
-	return d;
+		/* flush unescaped run before the escape sequence */
+		_write(w, start, (str - start));
+		_write_str(w, esc);
+		start = str + 1;
+	}
+
+	if (str)
+		_write(w, start, (str - start));
+	_write(w, "\"", 1);
 }
 
-static data_for_each_cmd_t _convert_dict_json(const char *key,
-					      const data_t *data,
-					      void *arg)
+static void _write_float(writer_t *w, double value)
 {
-	json_object *jobj = arg;
-	json_object *jobject = _data_to_json(data);
+	char tmp[32];
+	int len;
+
+	if (isnan(value)) {
+		_write_str(w, "NaN");
+		return;
+	} else if (isinf(value)) {
+		_write_str(w, ((value < 0) ? "-Infinity" : "Infinity"));
+		return;
+	}
+
+	/* use the shortest form that still parses back to the same value */
+	len = snprintf(tmp, sizeof(tmp), "%.15g", value);
+	if (strtod(tmp, NULL) != value)
+		len = snprintf(tmp, sizeof(tmp), "%.17g", value);
+	_write(w, tmp, len);
 
-	json_object_object_add(jobj, key, jobject);
-	return DATA_FOR_EACH_CONT;
+	/* make sure value is still parsed as a float */
+	if (!strpbrk(tmp, ".eE"))
+		_write(w, ".0", 2);
 }
 
-static data_for_each_cmd_t _convert_list_json(const data_t *data, void *arg)
+static data_for_each_cmd_t _write_dict_entry(const char *key,
+					     const data_t *data, void *arg)
 {
-	json_object *jobj = arg;
-	json_object *jarray = _data_to_json(data);
+	writer_t *w = arg;
 
-	json_object_array_add(jobj, jarray);
-	return DATA_FOR_EACH_CONT;
+	if (!w->first)
+		_write(w, ",", 1);
+	w->first = false;
+
+	_write_indent(w);
+	_write_string(w, key);
+
+	if (w->pretty)
+		_write(w, ": ", 2);
+	else
+		_write(w, ":", 1);
+
+	_write_data(w, data);
+
+	return (w->rc ? DATA_FOR_EACH_FAIL : DATA_FOR_EACH_CONT);
 }
 
-static json_object *_data_to_json(const data_t *d)
+static data_for_each_cmd_t _write_list_entry(const data_t *data, void *arg)
 {
-	if (!d)
-		return NULL;
+	writer_t *w = arg;
+
+	if (!w->first)
+		_write(w, ",", 1);
+	w->first = false;
+
+	_write_indent(w);
+	_write_data(w, data);
+
+	return (w->rc ? DATA_FOR_EACH_FAIL : DATA_FOR_EACH_CONT);
+}
+
+static void _write_data(writer_t *w, const data_t *d)
+{
+	char tmp[24];
+	int len;
+
+	if (w->rc)
+		return;
 
 	switch (data_get_type(d)) {
 	case DATA_TYPE_NULL:
-		return NULL;
+		_write_str(w, "null");
 		break;
 	case DATA_TYPE_BOOL:
-		return json_object_new_boolean(data_get_bool(d));
+		_write_str(w, (data_get_bool(d) ? "true" : "false"));
 		break;
 	case DATA_TYPE_FLOAT:
-		return json_object_new_double(data_get_float(d));
+		_write_float(w, data_get_float(d));
 		break;
 	case DATA_TYPE_INT_64:
-		return json_object_new_int64(data_get_int(d));
+		len = snprintf(tmp, sizeof(tmp), "%"PRId64, data_get_int(d));
+		_write(w, tmp, len);
 		break;
 	case DATA_TYPE_DICT:
-	{
-		json_object *jobj = json_object_new_object();
-		if (data_dict_for_each_const(d, _convert_dict_json, jobj) < 0)
-			error("%s: unexpected error calling _convert_dict_json()",
+		_write(w, "{", 1);
+		w->first = true;
+		w->depth++;
+		if (data_dict_for_each_const(d, _write_dict_entry, w) < 0)
+			error("%s: unexpected error calling _write_dict_entry()",
 			      __func__);
-		return jobj;
-	}
+		w->depth--;
+		_write_indent(w);
+		_write(w, "}", 1);
+		w->first = false;
+		break;
 	case DATA_TYPE_LIST:
-	{
-		json_object *jobj = json_object_new_array();
-		if (data_list_for_each_const(d, _convert_list_json, jobj) < 0)
-			error("%s: unexpected error calling _convert_list_json()",
+		_write(w, "[", 1);
+		w->first = true;
+		w->depth++;
+		if (data_list_for_each_const(d, _write_list_entry, w) < 0)
+			error("%s: unexpected error calling _write_list_entry()",
 			      __func__);
-		return jobj;
-	}
+		w->depth--;
+		_write_indent(w);
+		_write(w, "]", 1);
+		w->first = false;
+		break;
 	case DATA_TYPE_STRING:
-	{
-		const char *str = data_get_string(d);
-		if (str)
-			return json_object_new_string(str);
-		else
-			return json_object_new_string("");
+		_write_string(w, data_get_string(d));
 		break;
-	}
 	default:
 		fatal_abort("%s: unknown type", __func__);
 	};
@@ -236,31 +821,38 @@ extern int serialize_p_data_to_string(char **dest, size_t *length,
 				      const data_t *src,
 				      serializer_flags_t flags)
 {
-	struct json_object *jobj = _data_to_json(src);
-	int jflags = 0;
+	writer_t w = {
+		.magic = MAGIC_WRITER,
+		.buf = init_buf(0),
+		.pretty = (flags == SER_FLAGS_PRETTY),
+	};
 
 	/* can't be pretty and compact at the same time! */
 	xassert((flags & (SER_FLAGS_PRETTY | SER_FLAGS_COMPACT)) !=
 		(SER_FLAGS_PRETTY | SER_FLAGS_COMPACT));
 
-	switch (flags) {
-	case SER_FLAGS_PRETTY:
-		jflags = JSON_C_TO_STRING_SPACED | JSON_C_TO_STRING_PRETTY;
-		break;
-	case SER_FLAGS_COMPACT: /* fallthrough */
-	default:
-		jflags = JSON_C_TO_STRING_PLAIN;
+	/*
+	 * Write JSON directly from the data_t tree instead of converting it to
+	 * json-c objects first, to avoid holding another full copy of large
+	 * responses.
+	 */
+	if (src)
+		_write_data(&w, src);
+	else
+		_write_str(&w, "null");
+
+	if (w.rc) {
+		error("%s: unable to write JSON: %s",
+		      __func__, slurm_strerror(w.rc));
+		FREE_NULL_BUFFER(w.buf);
+		return w.rc;
 	}
 
-	/* string will die with jobj */
-	*dest = xstrdup(json_object_to_json_string_ext(jobj, jflags));
 	if (length) {
 		/* add 1 for \0 */
-		*length = strlen(*dest) + 1;
+		*length = get_buf_offset(w.buf) + 1;
 	}
-
-	/* put is equiv to free() */
-	json_object_put(jobj);
+	*dest = xfer_buf_data(w.buf);
 
 	return SLURM_SUCCESS;
 }
@@ -268,33 +860,43 @@ extern int serialize_p_data_to_string(char **dest, size_t *length,
 extern int serialize_p_string_to_data(data_t **dest, const char *src,
 				      size_t length)
 {
-	json_object *jobj = NULL;
 	data_t *data = NULL;
-	struct json_tokener *tok = json_tokener_new();
+	reader_t r = {
+		.magic = MAGIC_READER,
+		.start = src,
+		.pos = src,
+		.end = (src + length),
+	};
 	int rc;
 
-	if (!tok)
-		return ENOMEM;
-
 	if (!src)
 		return ESLURM_DATA_PTR_NULL;
 
-	/* json-c has hard limit of 32 bits */
-	if (length >= INT32_MAX) {
-		error("%s: unable to parse JSON: too large",
-		      __func__);
-		return ESLURM_DATA_TOO_LARGE;
-	}
+	/*
+	 * Parse directly into data_t without building a json-c object tree
+	 * first to avoid allocating and copying every value twice.
+	 */
+	data = data_new();
 
-	jobj = _try_parse(src, length, tok);
-	if (jobj) {
-		data = _json_to_data(jobj, NULL);
-		json_object_put(jobj);
-		rc = SLURM_SUCCESS;
-	} else
-		rc = ESLURM_REST_FAIL_PARSING;
+	if (!(rc = _skip_space(&r)) && (_peek(&r) < 0))
+		rc = _read_fail(&r, "no JSON value found");
+
+	if (!rc)
+		rc = _read_value(&r, data);
+
+	if (!rc)
+		rc = _skip_space(&r);
+
+	if (rc) {
+		error("%s: JSON parsing error at byte %zu of %zu: %s",
+		      __func__, (size_t) (r.pos - r.start), length, r.err);
+		FREE_NULL_DATA(data);
+	} else if (_peek(&r) >= 0) {
+		log_flag(DATA, "%s: Extra %zu characters after JSON string detected",
+			 __func__, (size_t) (r.end - r.pos));
+	}
 
-	json_tokener_free(tok);
+	xfree(r.key);
 
 	*dest = data;
 	return rc;
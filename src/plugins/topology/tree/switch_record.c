@@ -46,12 +46,67 @@ typedef struct slurm_conf_switches {
 				 * connected to this switch, if any */
 } slurm_conf_switches_t;
 
+/* Number of most recently used fanout plans kept in fanout_plan_cache */
+#define FANOUT_PLAN_CACHE_SIZE 16
+
+/*
+ * Precomputed split of a set of nodes into per-switch forwarding branches.
+ * Messages are usually sent to the same node sets over and over again (all
+ * nodes, a partition, a job allocation), so the walk of the switch tree is
+ * done once and then reused until the switch table is rebuilt.
+ */
+typedef struct {
+	bitstr_t *nodes_bitmap;		/* nodes this plan was built for */
+	bitstr_t **fwd_bitmaps;		/* nodes reached through each branch */
+	int fwd_cnt;			/* number of fwd_bitmaps */
+	bitstr_t *single_bitmap;	/* nodes not under any common switch,
+					 * each one gets its own branch */
+	int single_cnt;			/* nodes set in single_bitmap */
+	bool leaf_switch;		/* all nodes are on one leaf switch */
+	uint64_t last_used;		/* fanout_plan_ticks when last used */
+} fanout_plan_t;
+
 switch_record_t *switch_record_table = NULL;
 int switch_record_cnt = 0;
 int switch_levels = 0; /* number of switch levels */
 
 static s_p_hashtbl_t *conf_hashtbl = NULL;
 
+static pthread_mutex_t fanout_plan_mutex = PTHREAD_MUTEX_INITIALIZER;
+static fanout_plan_t *fanout_plan_cache[FANOUT_PLAN_CACHE_SIZE];
+static uint64_t fanout_plan_ticks = 0;
+static uint64_t fanout_plan_hits = 0;
+static uint64_t fanout_plan_misses = 0;
+
+static void _fanout_plan_free(fanout_plan_t *plan)
+{
+	if (!plan)
+		return;
+
+	for (int i = 0; i < plan->fwd_cnt; i++)
+		FREE_NULL_BITMAP(plan->fwd_bitmaps[i]);
+	xfree(plan->fwd_bitmaps);
+	FREE_NULL_BITMAP(plan->nodes_bitmap);
+	FREE_NULL_BITMAP(plan->single_bitmap);
+	xfree(plan);
+}
+
+/* Plans reference switch and node indexes, drop them on any table change */
+static void _fanout_plan_cache_flush(void)
+{
+	slurm_mutex_lock(&fanout_plan_mutex);
+	for (int i = 0; i < FANOUT_PLAN_CACHE_SIZE; i++) {
+		_fanout_plan_free(fanout_plan_cache[i]);
+		fanout_plan_cache[i] = NULL;
+	}
+	if (fanout_plan_hits || fanout_plan_misses)
+		log_flag(ROUTE, "fanout plan cache flushed after %"PRIu64" hits and %"PRIu64" misses",
+			 fanout_plan_hits, fanout_plan_misses);
+	fanout_plan_hits = 0;
+	fanout_plan_misses = 0;
+	slurm_mutex_unlock(&fanout_plan_mutex);
+}
+
 static void _log_switches(void)
 {
 	int i, j;
@@ -93,6 +148,8 @@ static void _log_switches(void)
 /* Free all memory associated with switch_record_table structure */
 extern void switch_record_table_destroy(void)
 {
+	_fanout_plan_cache_flush();
+
 	if (!switch_record_table)
 		return;
 
@@ -572,3 +629,207 @@ extern void switch_record_validate(void)
 	_log_switches();
 }
 
+
+/*
+ * Move the nodes of each child switch of parent found in nodes_bitmap into
+ * their own branch of plan.
+ */
+static void _fanout_plan_subtree(fanout_plan_t *plan, bitstr_t *nodes_bitmap,
+				 int parent, int *msg_count)
+{
+	int lst_count = 0, sw_count;
+
+	for (int i = 0; i < switch_record_table[parent].num_switches; i++) {
+		int k = switch_record_table[parent].switch_index[i];
+		bitstr_t *fwd_bitmap;
+
+		if (!bit_overlap_any(switch_record_table[k].node_bitmap,
+				     nodes_bitmap))
+			continue; /* no nodes on this switch in message list */
+
+		fwd_bitmap = bit_copy(switch_record_table[k].node_bitmap);
+		bit_and(fwd_bitmap, nodes_bitmap);
+		sw_count = bit_set_count(fwd_bitmap);
+		/* Now remove nodes from this switch from message list */
+		bit_and_not(nodes_bitmap, fwd_bitmap);
+		if (slurm_conf.debug_flags & DEBUG_FLAG_ROUTE) {
+			char *buf = bitmap2node_name(fwd_bitmap);
+			debug("ROUTE: ... sublist[%d] switch=%s :: %s",
+			      plan->fwd_cnt, switch_record_table[k].name, buf);
+			xfree(buf);
+		}
+		plan->fwd_bitmaps[plan->fwd_cnt++] = fwd_bitmap;
+		lst_count += sw_count;
+		if (lst_count == *msg_count)
+			break; /* all nodes in message are in a child list */
+	}
+	*msg_count -= lst_count;
+}
+
+static fanout_plan_t *_fanout_plan_build(bitstr_t *msg_bitmap)
+{
+	int i, j, k, msg_count, switch_count;
+	int s_first, s_last;
+	bitstr_t *nodes_bitmap = bit_copy(msg_bitmap);
+	bitstr_t *switch_bitmap = NULL;		/* switches  */
+	fanout_plan_t *plan = xmalloc(sizeof(*plan));
+
+	plan->nodes_bitmap = bit_copy(msg_bitmap);
+
+	/* Find lowest level switches containing all the nodes in the list */
+	switch_bitmap = bit_alloc(switch_record_cnt);
+	for (j = 0; j < switch_record_cnt; j++) {
+		if ((switch_record_table[j].level == 0 ) &&
+		    bit_overlap_any(switch_record_table[j].node_bitmap,
+				    nodes_bitmap)) {
+				bit_set(switch_bitmap, j);
+		}
+	}
+
+	switch_count = bit_set_count(switch_bitmap);
+
+	for (i = 1; i <= switch_levels; i++) {
+		/* All nodes in message list are in one switch */
+		if (switch_count < 2)
+			break;
+		for (j = 0; j < switch_record_cnt; j++) {
+			if (switch_count < 2)
+				break;
+			if (switch_record_table[j].level == i) {
+				int first_child = -1, child_cnt = 0, num_desc;
+				num_desc = switch_record_table[j].
+						num_desc_switches;
+				for (k = 0; k < num_desc; k++) {
+					int index = switch_record_table[j].
+						switch_desc_index[k];
+					if (bit_test(switch_bitmap, index)) {
+						child_cnt++;
+						if (child_cnt > 1) {
+							bit_clear(switch_bitmap,
+								  index);
+						} else {
+							first_child = index;
+						}
+					}
+				}
+				if (child_cnt > 1) {
+					bit_clear(switch_bitmap, first_child);
+					bit_set(switch_bitmap, j);
+					switch_count -= (child_cnt - 1);
+				}
+			}
+		}
+	}
+
+	s_first = bit_ffs(switch_bitmap);
+	if (s_first != -1)
+		s_last = bit_fls(switch_bitmap);
+	else
+		s_last = -2;
+
+	if (switch_count == 1 && switch_record_table[s_first].level == 0 &&
+	    bit_super_set(nodes_bitmap,
+			  switch_record_table[s_first].node_bitmap)) {
+		/* This is a leaf switch. Construct list based on TreeWidth */
+		plan->leaf_switch = true;
+		goto fini;
+	}
+
+	plan->fwd_bitmaps = xcalloc(switch_record_cnt, sizeof(bitstr_t *));
+	msg_count = bit_set_count(nodes_bitmap);
+	for (j = s_first; j <= s_last; j++) {
+		xassert(msg_count);
+
+		if (!bit_test(switch_bitmap, j))
+			continue;
+		_fanout_plan_subtree(plan, nodes_bitmap, j, &msg_count);
+	}
+	xassert(msg_count == bit_set_count(nodes_bitmap));
+	if (msg_count) {
+		if (slurm_conf.debug_flags & DEBUG_FLAG_ROUTE) {
+			char *buf = bitmap2node_name(nodes_bitmap);
+			debug("ROUTE: didn't find switch containing nodes=%s",
+			      buf);
+			xfree(buf);
+		}
+		plan->single_bitmap = nodes_bitmap;
+		plan->single_cnt = msg_count;
+		nodes_bitmap = NULL;
+	}
+
+fini:
+	FREE_NULL_BITMAP(nodes_bitmap);
+	FREE_NULL_BITMAP(switch_bitmap);
+
+	return plan;
+}
+
+/* Caller must hold fanout_plan_mutex */
+static fanout_plan_t *_fanout_plan_find(bitstr_t *nodes_bitmap)
+{
+	int64_t nodes_size = bit_size(nodes_bitmap);
+	int oldest = 0;
+	fanout_plan_t *plan;
+
+	fanout_plan_ticks++;
+
+	for (int i = 0; i < FANOUT_PLAN_CACHE_SIZE; i++) {
+		if (!(plan = fanout_plan_cache[i])) {
+			oldest = i;
+			continue;
+		}
+
+		if ((bit_size(plan->nodes_bitmap) == nodes_size) &&
+		    bit_equal(plan->nodes_bitmap, nodes_bitmap)) {
+			plan->last_used = fanout_plan_ticks;
+			fanout_plan_hits++;
+			return plan;
+		}
+
+		if (fanout_plan_cache[oldest] &&
+		    (plan->last_used < fanout_plan_cache[oldest]->last_used))
+			oldest = i;
+	}
+
+	/* Replace least recently used plan */
+	fanout_plan_misses++;
+	plan = _fanout_plan_build(nodes_bitmap);
+	plan->last_used = fanout_plan_ticks;
+	_fanout_plan_free(fanout_plan_cache[oldest]);
+	fanout_plan_cache[oldest] = plan;
+
+	return plan;
+}
+
+extern bool switch_record_split_nodes(bitstr_t *nodes_bitmap,
+				      hostlist_t ***sp_hl, int *count)
+{
+	fanout_plan_t *plan;
+	node_record_t *node_ptr;
+	int i;
+
+	slurm_mutex_lock(&fanout_plan_mutex);
+	plan = _fanout_plan_find(nodes_bitmap);
+
+	if (plan->leaf_switch) {
+		slurm_mutex_unlock(&fanout_plan_mutex);
+		return true;
+	}
+
+	*sp_hl = xcalloc(plan->fwd_cnt + plan->single_cnt,
+			 sizeof(hostlist_t *));
+	*count = 0;
+	for (i = 0; i < plan->fwd_cnt; i++)
+		(*sp_hl)[(*count)++] = bitmap2hostlist(plan->fwd_bitmaps[i]);
+
+	for (i = 0; plan->single_bitmap &&
+		    (node_ptr = next_node_bitmap(plan->single_bitmap, &i));
+	     i++) {
+		(*sp_hl)[*count] = hostlist_create(NULL);
+		hostlist_push_host((*sp_hl)[*count], node_ptr->name);
+		(*count)++;
+	}
+	slurm_mutex_unlock(&fanout_plan_mutex);
+
+	return false;
+}
@@ -72,4 +72,19 @@ extern void switch_record_table_destroy(void);
 
 extern void switch_record_validate(void);
 
+/*
+ * Split nodes_bitmap into topology aware forwarding branches.
+ *
+ * The split of each node set is cached and reused for later messages to the
+ * same nodes until the switch table is rebuilt on reconfiguration.
+ *
+ * IN nodes_bitmap - bitmap of all nodes the message is sent to
+ * OUT sp_hl - xmalloc()'d array of hostlists, one per branch
+ * OUT count - number of hostlists in sp_hl
+ * RET true if all nodes are on a single leaf switch and should be split
+ *     based on TreeWidth instead, in which case sp_hl and count are not set
+ */
+extern bool switch_record_split_nodes(bitstr_t *nodes_bitmap,
+				      hostlist_t ***sp_hl, int *count);
+
 #endif
@@ -61,6 +61,8 @@
 #define OPT_LONG_SEND_LIBS 0x103
 #define OPT_LONG_AUTOCOMP  0x104
 #define OPT_LONG_TREE_WIDTH 0x105
+#define OPT_LONG_WINDOW    0x106
+#define OPT_LONG_CHAINS    0x107
 
 
 /* getopt_long options, integers but not characters */
@@ -81,6 +83,7 @@ extern void parse_command_line(int argc, char **argv)
 	int option_index;
 	static struct option long_options[] = {
 		{"autocomplete", required_argument, 0, OPT_LONG_AUTOCOMP},
+		{"chains",    required_argument, 0, OPT_LONG_CHAINS},
 		{"compress",  optional_argument, 0, 'C'},
 		{"exclude",   required_argument, 0, OPT_LONG_EXCLUDE},
 		{"fanout",    required_argument, 0, 'F'},
@@ -93,6 +96,7 @@ extern void parse_command_line(int argc, char **argv)
 		{"timeout",   required_argument, 0, 't'},
 		{"verbose",   no_argument,       0, 'v'},
 		{"version",   no_argument,       0, 'V'},
+		{"window",    required_argument, 0, OPT_LONG_WINDOW},
 		{"help",      no_argument,       0, OPT_LONG_HELP},
 		{"usage",     no_argument,       0, OPT_LONG_USAGE},
 		{NULL,        0,                 0, 0}
@@ -101,14 +105,34 @@ extern void parse_command_line(int argc, char **argv)
 	if ((tmp = conf_get_opt_str(slurm_conf.bcast_parameters,
 				    "Compression="))) {
 		params.compress = parse_compress_type(tmp);
+		params.compress_level = parse_compress_level(tmp);
+		xfree(tmp);
+	}
+	if ((tmp = conf_get_opt_str(slurm_conf.bcast_parameters,
+				    "CacheDir="))) {
+		params.flags |= BCAST_FLAG_CACHE;
+		xfree(tmp);
+	}
+	if ((tmp = conf_get_opt_str(slurm_conf.bcast_parameters,
+				    "Chains="))) {
+		params.chains = atoi(tmp);
+		xfree(tmp);
+	}
+	if ((tmp = conf_get_opt_str(slurm_conf.bcast_parameters,
+				    "Window="))) {
+		params.window = atoi(tmp);
 		xfree(tmp);
 	}
 
 	if (slurm_conf.bcast_exclude)
 		params.exclude = xstrdup(slurm_conf.bcast_exclude);
 
-	if ((env_val = getenv("SBCAST_COMPRESS")))
+	if ((env_val = getenv("SBCAST_CHAINS")))
+		params.chains = atoi(env_val);
+	if ((env_val = getenv("SBCAST_COMPRESS"))) {
 		params.compress = parse_compress_type(env_val);
+		params.compress_level = parse_compress_level(env_val);
+	}
 	if ((env_val = getenv("SBCAST_EXCLUDE"))) {
 		xfree(params.exclude);
 		params.exclude = xstrdup(env_val);
@@ -146,6 +170,8 @@ extern void parse_command_line(int argc, char **argv)
 		params.block_size = 8 * 1024 * 1024;
 	if ( ( env_val = getenv("SBCAST_TIMEOUT") ) )
 		params.timeout = (atoi(env_val) * 1000);
+	if ((env_val = getenv("SBCAST_WINDOW")))
+		params.window = atoi(env_val);
 
 	optind = 0;
 	while ((opt_char = getopt_long(argc, argv, "C::fF:j:ps:t:vV",
@@ -158,6 +184,10 @@ extern void parse_command_line(int argc, char **argv)
 			break;
 		case (int)'C':
 			params.compress = parse_compress_type(optarg);
+			params.compress_level = parse_compress_level(optarg);
+			break;
+		case OPT_LONG_CHAINS:
+			params.chains = atoi(optarg);
 			break;
 		case (int) OPT_LONG_EXCLUDE:
 			xfree(params.exclude);
@@ -201,6 +231,9 @@ extern void parse_command_line(int argc, char **argv)
 		case (int) 'V':
 			print_slurm_version();
 			exit(0);
+		case OPT_LONG_WINDOW:
+			params.window = atoi(optarg);
+			break;
 		case (int) OPT_LONG_HELP:
 			_help();
 			exit(0);
@@ -289,7 +322,9 @@ static void _print_options( void )
 {
 	info("-----------------------------");
 	info("block_size = %u", params.block_size);
+	info("chains     = %d", params.chains);
 	info("compress   = %u", params.compress);
+	info("compress_level = %d", params.compress_level);
 	info("exclude    = %s", params.exclude);
 	info("force      = %s",
 	     (params.flags & BCAST_FLAG_FORCE) ? "true" : "false");
@@ -300,6 +335,7 @@ static void _print_options( void )
 	     (params.flags & BCAST_FLAG_SEND_LIBS) ? "true" : "false");
 	info("timeout    = %d", params.timeout);
 	info("verbose    = %d", params.verbose);
+	info("window     = %d", params.window);
 	info("source     = %s", params.src_fname);
 	info("dest       = %s", params.dst_fname);
 	info("-----------------------------");
@@ -308,13 +344,14 @@ static void _print_options( void )
 
 static void _usage( void )
 {
-	printf("Usage: sbcast [--exclude] [-CfFjpvV] [--send-libs] SOURCE DEST\n");
+	printf("Usage: sbcast [--exclude] [-CfFjpvV] [--chains] [--send-libs] [--window] SOURCE DEST\n");
 }
 
 static void _help( void )
 {
 	printf ("\
 Usage: sbcast [OPTIONS] SOURCE DEST\n\
+  --chains=num          forward blocks node to node down this many chains\n\
   -C, --compress[=lib]  compress the file being transmitted\n\
   --exclude=<path_list> shared object paths to be excluded\n\
   -f, --force           replace destination file as required\n\
@@ -326,6 +363,7 @@ Usage: sbcast [OPTIONS] SOURCE DEST\n\
   -t, --timeout=secs    specify message timeout (seconds)\n\
   -v, --verbose         provide detailed event logging\n\
   -V, --version         print version information and exit\n\
+  --window=num          number of blocks sent concurrently\n\
 \nHelp options:\n\
   --help                show this help message\n\
   --usage               display brief usage message\n");
@@ -70,6 +70,7 @@
 #include "src/common/parse_time.h"
 #include "src/common/port_mgr.h"
 #include "src/common/slurm_protocol_pack.h"
+#include "src/common/str_intern.h"
 #include "src/common/timers.h"
 #include "src/common/track_script.h"
 #include "src/common/tres_bind.h"
@@ -120,6 +121,8 @@
 #define SLURM_CREATE_JOB_FLAG_NO_ALLOCATE_0 0
 #define TOP_PRIORITY 0xffff0000	/* large, but leave headroom for higher */
 #define PURGE_OLD_JOB_IN_SEC 2592000 /* 30 days in seconds */
+#define PURGE_BUSY_MIN_DELAY 10	/* Retry busy job records after seconds */
+#define PURGE_BUSY_MAX_DELAY 600
 
 #define JOB_HASH_INX(_job_id)	(_job_id % hash_table_size)
 #define JOB_ARRAY_HASH_INX(_job_id, _task_id)		\
@@ -217,6 +220,11 @@ static struct   job_record **job_array_hash_j = NULL;
 static struct   job_record **job_array_hash_t = NULL;
 static bool     kill_invalid_dep;
 static time_t   last_file_write_time = (time_t) 0;
+static time_t   next_purge_time = (time_t) 0;
+static time_t   purge_busy_delay = PURGE_BUSY_MIN_DELAY;
+static bool     purge_busy = false;
+static time_t   next_pend_test_time = (time_t) 0;
+static time_t   last_pend_test_update = (time_t) 0;
 static uint32_t max_array_size = NO_VAL;
 static bitstr_t *requeue_exit = NULL;
 static bitstr_t *requeue_exit_hold = NULL;
@@ -3273,6 +3281,10 @@ void init_job_conf(void)
 
 	last_job_update = time(NULL);
 
+	/* MinJobAge or KillWait may have changed, test all records again */
+	next_purge_time = 0;
+	purge_busy_delay = PURGE_BUSY_MIN_DELAY;
+
 	if (!purge_files_list) {
 		purge_files_list = list_create(xfree_ptr);
 	}
@@ -3521,12 +3533,13 @@ extern job_record_t *job_array_split(job_record_t *job_ptr, bool list_add)
 	 */
 	details_new->preempt_start_time = 0;
 
-	details_new->acctg_freq = xstrdup(job_details->acctg_freq);
+	details_new->acctg_freq = str_intern_ref(job_details->acctg_freq);
 	if (job_details->argc) {
 		details_new->argv =
 			xcalloc((job_details->argc + 1), sizeof(char *));
 		for (i = 0; i < job_details->argc; i++) {
-			details_new->argv[i] = xstrdup(job_details->argv[i]);
+			details_new->argv[i] =
+				str_intern_ref(job_details->argv[i]);
 		}
 	}
 	details_new->cpu_bind = xstrdup(job_details->cpu_bind);
@@ -3567,7 +3580,7 @@ extern job_record_t *job_array_split(job_record_t *job_ptr, bool list_add)
 		details_new->mc_ptr = xmalloc(i);
 		memcpy(details_new->mc_ptr, job_details->mc_ptr, i);
 	}
-	details_new->mem_bind = xstrdup(job_details->mem_bind);
+	details_new->mem_bind = str_intern_ref(job_details->mem_bind);
 	details_new->mem_bind_type = job_details->mem_bind_type;
 	if (job_details->req_node_bitmap) {
 		details_new->req_node_bitmap =
@@ -3575,14 +3588,14 @@ extern job_record_t *job_array_split(job_record_t *job_ptr, bool list_add)
 	}
 	details_new->req_context = xstrdup(job_details->req_context);
 	details_new->req_nodes = xstrdup(job_details->req_nodes);
-	details_new->std_err = xstrdup(job_details->std_err);
-	details_new->std_in = xstrdup(job_details->std_in);
-	details_new->std_out = xstrdup(job_details->std_out);
-	details_new->submit_line = xstrdup(job_details->submit_line);
-	details_new->work_dir = xstrdup(job_details->work_dir);
+	details_new->std_err = str_intern_ref(job_details->std_err);
+	details_new->std_in = str_intern_ref(job_details->std_in);
+	details_new->std_out = str_intern_ref(job_details->std_out);
+	details_new->submit_line = str_intern_ref(job_details->submit_line);
+	details_new->work_dir = str_intern_ref(job_details->work_dir);
 	details_new->x11_magic_cookie = xstrdup(job_details->x11_magic_cookie);
-	details_new->env_hash = xstrdup(job_details->env_hash);
-	details_new->script_hash = xstrdup(job_details->script_hash);
+	details_new->env_hash = str_intern_ref(job_details->env_hash);
+	details_new->script_hash = str_intern_ref(job_details->script_hash);
 
 	if (job_ptr->gres_list_req) {
 		if (details_new->whole_node & WHOLE_NODE_REQUIRED) {
@@ -7349,7 +7362,7 @@ static int _job_create(job_desc_msg_t *job_desc, int allocate, int will_run,
 
 	if (job_desc->script
 	    &&  (!will_run)) {	/* don't bother with copy if just a test */
-		char *tmp;
+		char *tmp, *tmp_hash = NULL;
 		if ((error_code = _copy_job_desc_to_file(job_desc,
 							 job_ptr->job_id))) {
 			error_code = ESLURM_WRITING_TO_FILE;
@@ -7361,10 +7374,10 @@ static int _job_create(job_desc_msg_t *job_desc, int allocate, int will_run,
 			tmp = xstring_bytes2hex(job_desc->env_hash.hash,
 						sizeof(job_desc->env_hash.hash),
 						NULL);
-			job_ptr->details->env_hash =
-				xstrdup_printf("%d:%s",
-					       job_desc->env_hash.type,
-					       tmp);
+			xstrfmtcat(tmp_hash, "%d:%s",
+				   job_desc->env_hash.type, tmp);
+			job_ptr->details->env_hash = str_intern(tmp_hash);
+			xfree(tmp_hash);
 			xfree(tmp);
 		}
 
@@ -7373,10 +7386,10 @@ static int _job_create(job_desc_msg_t *job_desc, int allocate, int will_run,
 				job_desc->script_hash.hash,
 				sizeof(job_desc->script_hash.hash), NULL);
 
-			job_ptr->details->script_hash =
-				xstrdup_printf("%d:%s",
-					       job_desc->script_hash.type,
-					       tmp);
+			xstrfmtcat(tmp_hash, "%d:%s",
+				   job_desc->script_hash.type, tmp);
+			job_ptr->details->script_hash = str_intern(tmp_hash);
+			xfree(tmp_hash);
 			xfree(tmp);
 		}
 	} else
@@ -8213,7 +8226,7 @@ static int _copy_job_desc_to_job_record(job_desc_msg_t *job_desc,
 					bitstr_t **req_bitmap,
 					bitstr_t **exc_bitmap)
 {
-	int error_code;
+	int error_code, i;
 	job_details_t *detail_ptr;
 	job_record_t *job_ptr;
 
@@ -8372,10 +8385,13 @@ static int _copy_job_desc_to_job_record(job_desc_msg_t *job_desc,
 
 	detail_ptr = job_ptr->details;
 	detail_ptr->argc = job_desc->argc;
-	detail_ptr->argv = job_desc->argv;
-	job_desc->argv   = (char **) NULL; /* nothing left to free */
-	job_desc->argc   = 0;		   /* nothing left to free */
-	detail_ptr->acctg_freq = xstrdup(job_desc->acctg_freq);
+	if (job_desc->argc) {
+		detail_ptr->argv = xcalloc((job_desc->argc + 1),
+					   sizeof(char *));
+		for (i = 0; i < job_desc->argc; i++)
+			detail_ptr->argv[i] = str_intern(job_desc->argv[i]);
+	}
+	detail_ptr->acctg_freq = str_intern(job_desc->acctg_freq);
 	detail_ptr->cpu_bind_type = job_desc->cpu_bind_type;
 	detail_ptr->cpu_bind   = xstrdup(job_desc->cpu_bind);
 	detail_ptr->cpu_freq_gov = job_desc->cpu_freq_gov;
@@ -8504,11 +8520,11 @@ static int _copy_job_desc_to_job_record(job_desc_msg_t *job_desc,
 		detail_ptr->pn_min_tmp_disk = job_desc->pn_min_tmp_disk;
 
 	detail_ptr->segment_size = job_desc->segment_size;
-	detail_ptr->std_err = xstrdup(job_desc->std_err);
-	detail_ptr->std_in = xstrdup(job_desc->std_in);
-	detail_ptr->std_out = xstrdup(job_desc->std_out);
-	detail_ptr->submit_line = xstrdup(job_desc->submit_line);
-	detail_ptr->work_dir = xstrdup(job_desc->work_dir);
+	detail_ptr->std_err = str_intern(job_desc->std_err);
+	detail_ptr->std_in = str_intern(job_desc->std_in);
+	detail_ptr->std_out = str_intern(job_desc->std_out);
+	detail_ptr->submit_line = str_intern(job_desc->submit_line);
+	detail_ptr->work_dir = str_intern(job_desc->work_dir);
 	if (job_desc->begin_time > time(NULL))
 		detail_ptr->begin_time = job_desc->begin_time;
 	job_ptr->select_jobinfo = select_g_select_jobinfo_alloc();
@@ -8954,10 +8970,6 @@ void job_time_limit(void)
 			last_job_update = now;
 		}
 
-		/* Don't enforce time limits for configuring hetjobs */
-		if (_het_job_configuring_test(job_ptr))
-			continue;
-
 		/*
 		 * Only running jobs can be killed due to timeout. Do not kill
 		 * suspended jobs due to timeout.
@@ -8965,6 +8977,10 @@ void job_time_limit(void)
 		if (!IS_JOB_RUNNING(job_ptr))
 			continue;
 
+		/* Don't enforce time limits for configuring hetjobs */
+		if (_het_job_configuring_test(job_ptr))
+			continue;
+
 		/*
 		 * everything above here is considered "quick", and skips the
 		 * timeout at the bottom of the loop by using a continue.
@@ -9589,16 +9605,40 @@ static int _list_find_job_id(void *job_entry, void *key)
 	return 0;
 }
 
+/* Lower *next_purge to when, if next_purge is set */
+static void _purge_at(time_t *next_purge, time_t when)
+{
+	if (next_purge && (when < *next_purge))
+		*next_purge = when;
+}
+
+/*
+ * Test a record again after purge_busy_delay. Used while waiting on something
+ * that does not change the job state when it is done (steps, burst buffer
+ * stage out, federation sync). The delay grows while records stay busy.
+ */
+static void _purge_busy(time_t *next_purge, time_t now)
+{
+	if (!next_purge)
+		return;
+	purge_busy = true;
+	_purge_at(next_purge, now + purge_busy_delay);
+}
+
 /*
  * _list_find_job_old - find old entries in the job list,
- *	see common/list.h for documentation, key is ignored
+ *	see common/list.h for documentation
  * job_entry IN - job pointer
- * key IN - if not NULL, then skip hetjobs
+ * key IN - if not NULL, then skip hetjobs. Points to a time_t which is
+ *	lowered to the earliest time at which a record that was not purged
+ *	may need to be tested again.
  */
 static int _list_find_job_old(void *job_entry, void *key)
 {
 	time_t kill_age, min_age, now = time(NULL);
+	time_t kill_wait = slurm_conf.kill_wait + 2 * slurm_conf.msg_timeout;
 	job_record_t *job_ptr = (job_record_t *) job_entry;
+	time_t *next_purge = key;
 
 	if ((job_ptr->job_id == NO_VAL) && IS_JOB_REVOKED(job_ptr))
 		return 1;
@@ -9607,12 +9647,12 @@ static int _list_find_job_old(void *job_entry, void *key)
 		return 0;
 
 	if (IS_JOB_COMPLETING(job_ptr) && !LOTS_OF_AGENTS) {
-		kill_age = now - (slurm_conf.kill_wait +
-		                  2 * slurm_conf.msg_timeout);
+		kill_age = now - kill_wait;
 		if (job_ptr->time_last_active < kill_age) {
 			job_ptr->time_last_active = now;
 			re_kill_job(job_ptr);
 		}
+		_purge_at(next_purge, job_ptr->time_last_active + kill_wait);
 		return 0;       /* Job still completing */
 	}
 
@@ -9632,16 +9672,24 @@ static int _list_find_job_old(void *job_entry, void *key)
 		if (origin &&
 		    (!origin->fed.send ||
 		     (((persist_conn_t *) origin->fed.send)->fd == -1) ||
-		     !origin->fed.sync_sent))
+		     !origin->fed.sync_sent)) {
+			_purge_busy(next_purge, now);
 			return 0;
+		}
+	}
+
+	if (!(IS_JOB_COMPLETED(job_ptr))) {
+		if (IS_JOB_COMPLETING(job_ptr))
+			_purge_busy(next_purge, now);
+		return 0;	/* Job still active */
 	}
 
 	min_age = now - slurm_conf.min_job_age;
-	if (job_ptr->end_time > min_age)
+	if (job_ptr->end_time > min_age) {
+		_purge_at(next_purge,
+			  job_ptr->end_time + slurm_conf.min_job_age);
 		return 0;	/* Too new to purge */
-
-	if (!(IS_JOB_COMPLETED(job_ptr)))
-		return 0;	/* Job still active */
+	}
 
 	if (job_ptr->step_list && list_count(job_ptr->step_list)) {
 		debug("%pJ still has %d active steps",
@@ -9657,20 +9705,27 @@ static int _list_find_job_old(void *job_entry, void *key)
 			info("Force purge of %pJ. It ended over 30 days ago, the slurmctld thinks there are still steps running but they are most likely bogus. In any case you might want to check nodes %s to make sure nothing remains of the job.",
 			     job_ptr, job_ptr->nodes);
 			goto end_it;
-		} else
+		} else {
+			_purge_busy(next_purge, now);
 			return 0;	/* steps are still active */
+		}
 	}
 
 	if (job_ptr->array_recs) {
 		if (job_ptr->array_recs->tot_run_tasks ||
 		    !_test_job_array_purged(job_ptr->array_job_id)) {
-			/* Some tasks from this job array still active */
+			/*
+			 * Some tasks from this job array still active. Their
+			 * state changes and purges bring the walk back here.
+			 */
 			return 0;
 		}
 	}
 
-	if (bb_g_job_test_stage_out(job_ptr) != 1)
+	if (bb_g_job_test_stage_out(job_ptr) != 1) {
+		_purge_busy(next_purge, now);
 		return 0;      /* Stage out in progress */
+	}
 
 	/* If we don't have a db_index by now and we are running with
 	 * the slurmdbd, lets put it on the list to be handled later
@@ -9681,6 +9736,10 @@ end_it:
 	if (slurm_with_slurmdbd() && !job_ptr->db_index)
 		jobacct_storage_g_job_start(acct_db_conn, job_ptr);
 
+	/* The array meta record may be purgeable once its tasks are gone */
+	if (job_ptr->array_task_id != NO_VAL)
+		_purge_at(next_purge, now);
+
 	return 1;		/* Purge the job */
 }
 
@@ -11101,8 +11160,10 @@ static inline bool _purge_complete_het_job(job_record_t *het_job_leader)
 	}
 	list_iterator_destroy(iter);
 
-	if (incomplete_job)
+	if (incomplete_job) {
+		_purge_busy(&next_purge_time, time(NULL));
 		return false;
+	}
 
 	purge_job_rec.het_job_id = het_job_leader->het_job_id;
 	i = list_delete_all(job_list, &_purge_het_job_filter, &purge_job_rec);
@@ -11144,6 +11205,46 @@ void handle_invalid_dependency(job_record_t *job_ptr)
 	fed_mgr_remove_remote_dependencies(job_ptr);
 }
 
+/*
+ * Test deadline and dependencies of a pending job.
+ * next_test is lowered to the earliest time at which a deadline may be
+ * exceeded.
+ */
+static void _test_pending_job(job_record_t *job_ptr, time_t *next_test)
+{
+	uint32_t limit = NO_VAL;
+
+	if (!IS_JOB_PENDING(job_ptr))
+		return;
+
+	if ((job_ptr->deadline) && (job_ptr->deadline != NO_VAL)) {
+		if (!deadline_ok(job_ptr, __func__))
+			return;
+
+		/* See deadline_ok() for when a deadline is exceeded */
+		if ((job_ptr->time_min) && (job_ptr->time_min != NO_VAL))
+			limit = job_ptr->time_min;
+		else if (job_ptr->time_limit != INFINITE)
+			limit = job_ptr->time_limit;
+		if ((limit != NO_VAL) &&
+		    ((job_ptr->deadline - (time_t) limit * 60) < *next_test))
+			*next_test = job_ptr->deadline - (time_t) limit * 60;
+	}
+
+	/*
+	 * If the dependency is already invalid there's no reason to
+	 * keep checking it.
+	 */
+	if (job_ptr->state_reason == WAIT_DEP_INVALID)
+		return;
+	if (test_job_dependency(job_ptr, NULL) == FAIL_DEPEND) {
+		/* Check what are the job disposition
+		 * to deal with invalid dependecies
+		 */
+		handle_invalid_dependency(job_ptr);
+	}
+}
+
 /*
  * purge_old_job - purge old job records.
  *	The jobs must have completed at least MIN_JOB_AGE minutes ago.
@@ -11155,6 +11256,7 @@ void purge_old_job(void)
 	list_itr_t *job_iterator;
 	job_record_t *job_ptr;
 	int i, purge_job_count;
+	time_t now = time(NULL);
 
 	xassert(verify_lock(CONF_LOCK, READ_LOCK));
 	xassert(verify_lock(JOB_LOCK, WRITE_LOCK));
@@ -11165,34 +11267,42 @@ void purge_old_job(void)
 		debug("%s: job file deletion is falling behind, "
 		      "%d left to remove", __func__, purge_job_count);
 
-	job_iterator = list_iterator_create(job_list);
-	while ((job_ptr = list_next(job_iterator))) {
-		if (_purge_complete_het_job(job_ptr))
-			continue;
-		if (!IS_JOB_PENDING(job_ptr))
-			continue;
-
-		if ((job_ptr->deadline) && (job_ptr->deadline != NO_VAL) &&
-		    !deadline_ok(job_ptr, __func__))
-			continue;
-
+	/*
+	 * A dependency can only become invalid when some job record changes,
+	 * which updates last_job_update. Remote dependencies are updated
+	 * without that, so always test them in a federation.
+	 */
+	if (fed_mgr_fed_rec || (last_pend_test_update != last_job_update) ||
+	    (now >= next_pend_test_time)) {
+		last_pend_test_update = last_job_update;
+		next_pend_test_time = now + PURGE_OLD_JOB_IN_SEC;
 		/*
-		 * If the dependency is already invalid there's no reason to
-		 * keep checking it.
+		 * This cannot be a list_for_each, test_job_dependency() needs
+		 * to call list_find_first() on the job_list.
 		 */
-		if (job_ptr->state_reason == WAIT_DEP_INVALID)
-			continue;
-		if (test_job_dependency(job_ptr, NULL) == FAIL_DEPEND) {
-			/* Check what are the job disposition
-			 * to deal with invalid dependecies
-			 */
-			handle_invalid_dependency(job_ptr);
-		}
+		job_iterator = list_iterator_create(job_list);
+		while ((job_ptr = list_next(job_iterator)))
+			_test_pending_job(job_ptr, &next_pend_test_time);
+		list_iterator_destroy(job_iterator);
 	}
-	list_iterator_destroy(job_iterator);
 	fed_mgr_test_remote_dependencies();
 
-	i = list_delete_all(job_list, &_list_find_job_old, "");
+	/*
+	 * Only walk every record once some job may have aged past MinJobAge
+	 * or need to be killed again. The previous walk and
+	 * purge_job_state_change() keep track of when that is.
+	 */
+	if (now < next_purge_time)
+		return;
+	next_purge_time = now + PURGE_OLD_JOB_IN_SEC;
+	purge_busy = false;
+
+	job_iterator = list_iterator_create(job_list);
+	while ((job_ptr = list_next(job_iterator)))
+		(void) _purge_complete_het_job(job_ptr);
+	list_iterator_destroy(job_iterator);
+
+	i = list_delete_all(job_list, &_list_find_job_old, &next_purge_time);
 	if (i) {
 		debug2("purge_old_job: purged %d old job records", i);
 		last_job_update = time(NULL);
@@ -11200,6 +11310,50 @@ void purge_old_job(void)
 		slurm_cond_signal(&purge_thread_cond);
 		slurm_mutex_unlock(&purge_thread_lock);
 	}
+
+	if (purge_busy)
+		purge_busy_delay = MIN(purge_busy_delay * 2,
+				       PURGE_BUSY_MAX_DELAY);
+	else
+		purge_busy_delay = PURGE_BUSY_MIN_DELAY;
+}
+
+/*
+ * purge_old_job_at - have purge_old_job() test job records again no later
+ *	than when
+ */
+extern void purge_old_job_at(time_t when)
+{
+	if (when < next_purge_time)
+		next_purge_time = when;
+}
+
+/*
+ * purge_job_state_change - note that a job is about to change state so
+ *	purge_old_job() knows when the record may need to be tested again
+ * IN job_ptr - job about to be updated
+ * IN new_state - new value of job_ptr->job_state
+ */
+extern void purge_job_state_change(job_record_t *job_ptr, uint32_t new_state)
+{
+	time_t when;
+
+	if (!((new_state ^ job_ptr->job_state) &
+	      (JOB_STATE_BASE | JOB_COMPLETING | JOB_REVOKED)))
+		return;
+
+	if (new_state & JOB_REVOKED)
+		when = 0;
+	else if (new_state & JOB_COMPLETING)
+		when = time(NULL) + slurm_conf.kill_wait +
+		       2 * slurm_conf.msg_timeout;
+	else if ((new_state & JOB_STATE_BASE) > JOB_SUSPENDED)
+		when = time(NULL) + slurm_conf.min_job_age;
+	else
+		return;
+
+	if (when < next_purge_time)
+		next_purge_time = when;
 }
 
 extern void free_old_jobs(void)
@@ -13663,8 +13817,8 @@ static int _update_job(job_record_t *job_ptr, job_desc_msg_t *job_desc,
 			error_code = ESLURM_JOB_NOT_PENDING;
 			goto fini;
 		} else if (detail_ptr) {
-			xfree(detail_ptr->work_dir);
-			detail_ptr->work_dir = xstrdup(job_desc->work_dir);
+			FREE_NULL_INTERNED(detail_ptr->work_dir);
+			detail_ptr->work_dir = str_intern(job_desc->work_dir);
 			sched_info("%s: setting work_dir to %s for %pJ",
 				   __func__, detail_ptr->work_dir, job_ptr);
 			update_accounting = true;
@@ -13679,10 +13833,10 @@ static int _update_job(job_record_t *job_ptr, job_desc_msg_t *job_desc,
 		if (!IS_JOB_PENDING(job_ptr))
 			error_code = ESLURM_JOB_NOT_PENDING;
 		else if (detail_ptr && job_desc->std_err[0] == '\0')
-			xfree(detail_ptr->std_err);
+			FREE_NULL_INTERNED(detail_ptr->std_err);
 		else if (detail_ptr) {
-			xfree(detail_ptr->std_err);
-			detail_ptr->std_err = xstrdup(job_desc->std_err);
+			FREE_NULL_INTERNED(detail_ptr->std_err);
+			detail_ptr->std_err = str_intern(job_desc->std_err);
 		}
 	}
 	if (error_code != SLURM_SUCCESS)
@@ -13696,10 +13850,10 @@ static int _update_job(job_record_t *job_ptr, job_desc_msg_t *job_desc,
 		if (!IS_JOB_PENDING(job_ptr))
 			error_code = ESLURM_JOB_NOT_PENDING;
 		else if (detail_ptr && job_desc->std_in[0] == '\0')
-			xfree(detail_ptr->std_in);
+			FREE_NULL_INTERNED(detail_ptr->std_in);
 		else if (detail_ptr) {
-			xfree(detail_ptr->std_in);
-			detail_ptr->std_in = xstrdup(job_desc->std_in);
+			FREE_NULL_INTERNED(detail_ptr->std_in);
+			detail_ptr->std_in = str_intern(job_desc->std_in);
 		}
 	}
 	if (error_code != SLURM_SUCCESS)
@@ -13713,10 +13867,10 @@ static int _update_job(job_record_t *job_ptr, job_desc_msg_t *job_desc,
 		if (!IS_JOB_PENDING(job_ptr))
 			error_code = ESLURM_JOB_NOT_PENDING;
 		else if (detail_ptr && job_desc->std_out[0] == '\0')
-			xfree(detail_ptr->std_out);
+			FREE_NULL_INTERNED(detail_ptr->std_out);
 		else if (detail_ptr) {
-			xfree(detail_ptr->std_out);
-			detail_ptr->std_out = xstrdup(job_desc->std_out);
+			FREE_NULL_INTERNED(detail_ptr->std_out);
+			detail_ptr->std_out = str_intern(job_desc->std_out);
 		}
 	}
 	if (error_code != SLURM_SUCCESS)
@@ -299,6 +299,7 @@ extern void job_state_set(job_record_t *job_ptr, uint32_t state)
 	_log_job_state_change(job_ptr, state);
 
 	on_job_state_change(job_ptr, state);
+	purge_job_state_change(job_ptr, state);
 
 	job_ptr->job_state = state;
 }
@@ -324,6 +325,7 @@ extern void job_state_set_flag(job_record_t *job_ptr, uint32_t flag)
 	_log_job_state_change(job_ptr, job_state);
 
 	on_job_state_change(job_ptr, job_state);
+	purge_job_state_change(job_ptr, job_state);
 
 	job_ptr->job_state = job_state;
 }
@@ -341,6 +343,7 @@ extern void job_state_unset_flag(job_record_t *job_ptr, uint32_t flag)
 	_log_job_state_change(job_ptr, job_state);
 
 	on_job_state_change(job_ptr, job_state);
+	purge_job_state_change(job_ptr, job_state);
 
 	job_ptr->job_state = job_state;
 }
@@ -165,6 +165,7 @@ extern void prep_epilog_slurmctld_callback(int rc, uint32_t job_id,
 
 	/* all async prologs have completed, continue on now */
 	job_ptr->epilog_running = false;
+	purge_old_job_at(job_ptr->end_time + slurm_conf.min_job_age);
 
 	/*
 	 * Clear the JOB_COMPLETING flag only if the node count is 0
@@ -3905,6 +3905,172 @@ send_msg:
 	xfree(job_submit_user_msg);
 }
 
+/* Validate one job of a REQUEST_SUBMIT_BATCH_JOBS under job_read_lock */
+static int _validate_batch_jobs_req(slurm_msg_t *msg, job_desc_msg_t *job_desc,
+				    submit_response_msg_t *resp)
+{
+	int rc;
+
+	if ((rc = _valid_id("REQUEST_SUBMIT_BATCH_JOBS", job_desc,
+			    msg->auth_uid, msg->auth_gid,
+			    msg->protocol_version)))
+		return rc;
+
+	_set_hostname(msg, &job_desc->alloc_node);
+	_set_identity(msg, &job_desc->id);
+
+	if (!job_desc->alloc_node || !job_desc->alloc_node[0]) {
+		error("REQUEST_SUBMIT_BATCH_JOBS lacks alloc_node from uid=%u",
+		      msg->auth_uid);
+		return ESLURM_INVALID_NODE_NAME;
+	}
+
+	dump_job_desc(job_desc);
+
+	job_desc->het_job_offset = NO_VAL;
+	return validate_job_create_req(job_desc, msg->auth_uid,
+				       &resp->job_submit_user_msg);
+}
+
+/* Create one job of a REQUEST_SUBMIT_BATCH_JOBS under job_write_lock */
+static int _create_batch_jobs_req(slurm_msg_t *msg, job_desc_msg_t *job_desc,
+				  submit_response_msg_t *resp)
+{
+	int rc = SLURM_SUCCESS;
+	job_record_t *job_ptr = NULL;
+	char *err_msg = NULL;
+
+	rc = job_allocate(job_desc, job_desc->immediate, false, NULL, 0,
+			  msg->auth_uid, false, &job_ptr, &err_msg,
+			  msg->protocol_version);
+
+	/*
+	 * Same as _slurm_rpc_submit_batch_job(): a job which was created and
+	 * did not fail is submitted even if rc is set (e.g. it can not run
+	 * yet), and the user gets both its job id and rc.
+	 */
+	if (!job_ptr || (rc && (job_ptr->job_state == JOB_FAILED))) {
+		if (!rc)
+			rc = SLURM_ERROR;
+	} else if (job_desc->immediate && rc) {
+		rc = ESLURM_CAN_NOT_START_IMMEDIATELY;
+	} else {
+		resp->job_id = job_ptr->job_id;
+	}
+
+	if (err_msg) {
+		xstrfmtcat(resp->job_submit_user_msg, "%s%s",
+			   (resp->job_submit_user_msg ? "\n" : ""), err_msg);
+		xfree(err_msg);
+	}
+
+	return rc;
+}
+
+/*
+ * _slurm_rpc_submit_batch_jobs - process RPC to submit many independent batch
+ * jobs. Every job is validated under a single read lock and then created under
+ * a single write lock. A rejected job does not stop the others from being
+ * submitted and its error is reported in its own response entry.
+ */
+static void _slurm_rpc_submit_batch_jobs(slurm_msg_t *msg)
+{
+	static int active_rpc_cnt = 0;
+	DEF_TIMERS;
+	list_t *job_req_list = msg->data;
+	list_t *resp_list = NULL;
+	list_itr_t *iter, *resp_iter;
+	job_desc_msg_t *job_desc_msg;
+	submit_response_msg_t *resp;
+	int *rcs = NULL, i, submitted = 0, job_cnt;
+	/* Locks: Read config, read job, read node, read partition */
+	slurmctld_lock_t job_read_lock = {
+		READ_LOCK, READ_LOCK, READ_LOCK, READ_LOCK, READ_LOCK };
+	/* Locks: Read config, write job, write node, read partition, read
+	 * federation */
+	slurmctld_lock_t job_write_lock = {
+		READ_LOCK, WRITE_LOCK, WRITE_LOCK, READ_LOCK, READ_LOCK };
+
+	START_TIMER;
+	if (!job_req_list || !(job_cnt = list_count(job_req_list))) {
+		info("REQUEST_SUBMIT_BATCH_JOBS from uid=%u with empty job list",
+		     msg->auth_uid);
+		slurm_send_rc_msg(msg, SLURM_ERROR);
+		return;
+	}
+	if (slurmctld_config.submissions_disabled) {
+		info("Submissions disabled on system");
+		slurm_send_rc_msg(msg, ESLURM_SUBMISSIONS_DISABLED);
+		return;
+	}
+	if (fed_mgr_fed_rec) {
+		/* Sibling submission forwards each original request */
+		info("REQUEST_SUBMIT_BATCH_JOBS from uid=%u rejected as cluster is federated",
+		     msg->auth_uid);
+		slurm_send_rc_msg(msg, ESLURM_NOT_SUPPORTED);
+		return;
+	}
+
+	resp_list = list_create(
+		(ListDelF) slurm_free_submit_response_response_msg);
+	rcs = xcalloc(job_cnt, sizeof(*rcs));
+
+	/* Validate every request (locks are for job_submit plugin use) */
+	lock_slurmctld(job_read_lock);
+	iter = list_iterator_create(job_req_list);
+	for (i = 0; (job_desc_msg = list_next(iter)); i++) {
+		resp = xmalloc(sizeof(*resp));
+		resp->step_id = SLURM_BATCH_SCRIPT;
+		list_append(resp_list, resp);
+
+		rcs[i] = _validate_batch_jobs_req(msg, job_desc_msg, resp);
+	}
+	list_iterator_destroy(iter);
+	unlock_slurmctld(job_read_lock);
+
+	/* Create all of the valid jobs */
+	_throttle_start(&active_rpc_cnt);
+	lock_slurmctld(job_write_lock);
+	START_TIMER;	/* Restart after we have locks */
+	iter = list_iterator_create(job_req_list);
+	resp_iter = list_iterator_create(resp_list);
+	for (i = 0; (job_desc_msg = list_next(iter)); i++) {
+		resp = list_next(resp_iter);
+
+		if (!rcs[i])
+			rcs[i] = _create_batch_jobs_req(msg, job_desc_msg,
+							resp);
+		resp->error_code = rcs[i];
+
+		if (resp->job_id) {
+			submitted++;
+		} else {
+			debug("%s: job %d of %d rejected: %s",
+			      __func__, (i + 1), job_cnt,
+			      slurm_strerror(rcs[i]));
+		}
+	}
+	list_iterator_destroy(resp_iter);
+	list_iterator_destroy(iter);
+	unlock_slurmctld(job_write_lock);
+	_throttle_fini(&active_rpc_cnt);
+	END_TIMER2(__func__);
+
+	info("%s: submitted %d of %d jobs %s",
+	     __func__, submitted, job_cnt, TIME_STR);
+
+	(void) send_msg_response(msg, RESPONSE_SUBMIT_BATCH_JOBS, resp_list);
+
+	if (submitted) {
+		schedule_job_save();	/* Has own locks */
+		schedule_node_save();	/* Has own locks */
+		queue_job_scheduler();
+	}
+
+	FREE_NULL_LIST(resp_list);
+	xfree(rcs);
+}
+
 /* _slurm_rpc_update_job - process RPC to update the configuration of a
  * job (e.g. priority)
  */
@@ -6613,6 +6779,9 @@ slurmctld_rpc_t slurmctld_rpcs[] =
 	},{
 		.msg_type = REQUEST_SUBMIT_BATCH_HET_JOB,
 		.func = _slurm_rpc_submit_batch_het_job,
+	},{
+		.msg_type = REQUEST_SUBMIT_BATCH_JOBS,
+		.func = _slurm_rpc_submit_batch_jobs,
 	},{
 		.msg_type = REQUEST_UPDATE_FRONT_END,
 		.func = _slurm_rpc_update_front_end,
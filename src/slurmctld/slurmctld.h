@@ -1623,6 +1623,22 @@ extern void handle_invalid_dependency(job_record_t *job_ptr);
  */
 void purge_old_job(void);
 
+/*
+ * purge_old_job_at - have purge_old_job() test job records again no later
+ *	than when
+ * NOTE: WRITE lock jobs before entry
+ */
+extern void purge_old_job_at(time_t when);
+
+/*
+ * purge_job_state_change - note that a job is about to change state so
+ *	purge_old_job() knows when the record may need to be tested again
+ * IN job_ptr - job about to be updated
+ * IN new_state - new value of job_ptr->job_state
+ * NOTE: WRITE lock jobs before entry
+ */
+extern void purge_job_state_change(job_record_t *job_ptr, uint32_t new_state);
+
 /*
  * Free memory from purged job records. This is a distinct phase from
  * purge_old_job() so this can run outside of the job write lock.
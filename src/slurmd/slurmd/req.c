@@ -57,6 +57,7 @@
 #include <signal.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/param.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -255,6 +256,13 @@ static active_job_t active_job_id[JOB_STATE_CNT] = {{0}};
 static pthread_mutex_t prolog_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 #define FILE_BCAST_TIMEOUT 300
+#define BCAST_CACHE_COPY_SIZE (1024 * 1024)
+/*
+ * Cache entries are copied while the sender waits for the reply, only use
+ * them for files that can be copied well within MessageTimeout. This is
+ * the copy rate assumed per second of MessageTimeout.
+ */
+#define BCAST_CACHE_RATE (50 * 1024 * 1024)
 static pthread_rwlock_t file_bcast_lock = PTHREAD_RWLOCK_INITIALIZER;
 static list_t *file_bcast_list = NULL;
 static list_t *bcast_libdir_list = NULL;
@@ -4281,6 +4289,7 @@ static void _free_file_bcast_info_t(void *arg)
 	if (!f)
 		return;
 
+	xfree(f->file_hash);
 	xfree(f->fname);
 	if (f->fd)
 		close(f->fd);
@@ -4391,12 +4400,251 @@ void file_bcast_purge(void)
 	/* destroying list before exit, no need to unlock */
 }
 
+static int _bcast_pwrite(int fd, char *data, uint64_t len, uint64_t offset)
+{
+	uint64_t done = 0;
+	ssize_t inx;
+
+	while (len - done) {
+		inx = pwrite(fd, &data[done], (len - done), (offset + done));
+		if (inx == -1) {
+			if ((errno == EINTR) || (errno == EAGAIN))
+				continue;
+			return errno;
+		}
+		done += inx;
+	}
+
+	return SLURM_SUCCESS;
+}
+
+/* Copy size bytes from the start of in_fd to out_fd */
+static int _bcast_copy(int in_fd, int out_fd, uint64_t size)
+{
+	char *buf = xmalloc(BCAST_CACHE_COPY_SIZE);
+	uint64_t offset = 0;
+	ssize_t len;
+	int rc = SLURM_SUCCESS;
+
+	while (offset < size) {
+		len = pread(in_fd, buf, MIN(BCAST_CACHE_COPY_SIZE,
+					    (size - offset)), offset);
+		if (len == -1) {
+			if ((errno == EINTR) || (errno == EAGAIN))
+				continue;
+			rc = errno;
+			break;
+		} else if (!len) {
+			rc = EIO;
+			break;
+		}
+		if ((rc = _bcast_pwrite(out_fd, buf, len, offset)))
+			break;
+		offset += len;
+	}
+	xfree(buf);
+
+	return rc;
+}
+
+/*
+ * Path of a file's content in the broadcast cache, or NULL if the cache is
+ * not configured. Entries are kept per user so that knowing the hash of a
+ * file never gives access to another user's data.
+ */
+static char *_bcast_cache_path(uid_t uid, const char *file_hash)
+{
+	char *cache_dir, *path = NULL;
+
+	if (!(cache_dir = conf_get_opt_str(slurm_conf.bcast_parameters,
+					   "CacheDir=")))
+		return NULL;
+
+	/* the hash is sent by the user, don't let it name another path */
+	if ((strlen(file_hash) != BCAST_HASH_HEX_LEN) ||
+	    (strspn(file_hash, "0123456789abcdef") != BCAST_HASH_HEX_LEN)) {
+		error("sbcast: uid:%u sent an invalid file hash", uid);
+		xfree(cache_dir);
+		return NULL;
+	}
+
+	xstrfmtcat(path, "%s/%u/%s", cache_dir, uid, file_hash);
+	xfree(cache_dir);
+
+	return path;
+}
+
+/* Largest file which is read from or added to the broadcast cache */
+static uint64_t _bcast_cache_max_size(void)
+{
+	return (uint64_t) slurm_conf.msg_timeout * BCAST_CACHE_RATE;
+}
+
+/*
+ * Fill a newly registered file from the broadcast cache.
+ * RET true if the file was copied from the cache.
+ */
+static bool _bcast_cache_fetch(file_bcast_info_t *file_info,
+			       file_bcast_msg_t *req)
+{
+	char *path;
+	struct stat st;
+	int fd, rc;
+
+	if (req->file_size > _bcast_cache_max_size()) {
+		debug2("sbcast: %s too large for the cache", file_info->fname);
+		return false;
+	}
+
+	if (!(path = _bcast_cache_path(file_info->uid, file_info->file_hash)))
+		return false;
+
+	if ((fd = open(path, (O_RDONLY | O_NOFOLLOW | O_CLOEXEC))) < 0) {
+		debug2("sbcast: %s not cached", file_info->fname);
+		xfree(path);
+		return false;
+	}
+
+	if (fstat(fd, &st) || (st.st_size != req->file_size)) {
+		error("sbcast: cache entry `%s` does not match `%s`, ignoring it",
+		      path, file_info->fname);
+		close(fd);
+		xfree(path);
+		return false;
+	}
+
+	if ((rc = _bcast_copy(fd, file_info->fd, st.st_size))) {
+		error("sbcast: uid:%u can't copy `%s` from cache: %s",
+		      file_info->uid, file_info->fname, slurm_strerror(rc));
+		close(fd);
+		xfree(path);
+		return false;
+	}
+
+	/* Keep recently used entries when the cache is purged by age */
+	(void) futimens(fd, NULL);
+	close(fd);
+
+	debug("sbcast: uid:%u copied `%s` from cache entry `%s`",
+	      file_info->uid, file_info->fname, path);
+	xfree(path);
+
+	return true;
+}
+
+/*
+ * Add a completely received file to the broadcast cache. The copy is
+ * verified against the sender's hash before it can be used, so a corrupted
+ * transfer never ends up in the cache.
+ *
+ * Runs detached once the last block was acknowledged, arg is a
+ * file_bcast_info_t holding its own descriptor of the received file.
+ */
+static void *_bcast_cache_store(void *arg)
+{
+	file_bcast_info_t *file_info = arg;
+	char *path, *tmp_path = NULL, *dir, *hash = NULL;
+	void *data = MAP_FAILED;
+	struct stat st;
+	int fd = -1, rc;
+
+	if (!(path = _bcast_cache_path(file_info->uid, file_info->file_hash))) {
+		_free_file_bcast_info_t(file_info);
+		return NULL;
+	}
+
+	if (!access(path, F_OK) || fstat(file_info->fd, &st) ||
+	    !S_ISREG(st.st_mode) || !st.st_size ||
+	    (st.st_size > _bcast_cache_max_size()))
+		goto fini;
+
+	dir = xstrdup(path);
+	*xstrrchr(dir, '/') = '\0';
+	rc = mkdirpath(dir, 0700, true);
+	xfree(dir);
+	if (rc) {
+		error("sbcast: can't create cache directory for `%s`: %s",
+		      path, slurm_strerror(rc));
+		goto fini;
+	}
+
+	/* copy before hashing, the user can still modify the original */
+	tmp_path = xstrdup_printf("%s.XXXXXX", path);
+	if ((fd = mkostemp(tmp_path, O_CLOEXEC)) < 0) {
+		error("sbcast: can't create cache entry `%s`: %m", tmp_path);
+		goto fini;
+	}
+	if ((rc = _bcast_copy(file_info->fd, fd, st.st_size))) {
+		error("sbcast: can't copy `%s` to cache: %s",
+		      file_info->fname, slurm_strerror(rc));
+		goto fini;
+	}
+	if ((data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0)) ==
+	    MAP_FAILED) {
+		error("sbcast: can't mmap cache entry `%s`: %m", tmp_path);
+		goto fini;
+	}
+
+	hash = bcast_hash_data(data, st.st_size);
+	if (xstrcmp(hash, file_info->file_hash)) {
+		error("sbcast: uid:%u `%s` does not match its hash, not caching it",
+		      file_info->uid, file_info->fname);
+		goto fini;
+	}
+
+	if (rename(tmp_path, path)) {
+		error("sbcast: can't rename cache entry `%s`: %m", tmp_path);
+		goto fini;
+	}
+	xfree(tmp_path);
+	debug("sbcast: uid:%u cached `%s` as `%s`",
+	      file_info->uid, file_info->fname, path);
+
+fini:
+	if (data != MAP_FAILED)
+		munmap(data, st.st_size);
+	if (fd >= 0)
+		close(fd);
+	if (tmp_path)
+		(void) unlink(tmp_path);
+	xfree(tmp_path);
+	xfree(hash);
+	xfree(path);
+	_free_file_bcast_info_t(file_info);
+
+	return NULL;
+}
+
+/* Set the final owner, modes and times of a transferred file */
+static void _file_bcast_finish(file_bcast_info_t *file_info,
+			       file_bcast_msg_t *req, file_bcast_info_t *key)
+{
+	if (fchmod(file_info->fd, (req->modes & 0777))) {
+		error("sbcast: uid:%u can't chmod `%s`: %m",
+		      key->uid, key->fname);
+	}
+	if (fchown(file_info->fd, key->uid, key->gid)) {
+		error("sbcast: uid:%u gid:%u can't chown `%s`: %m",
+		      key->uid, key->gid, key->fname);
+	}
+	if (req->atime) {
+		struct timespec time_buf[2];
+		time_buf[0].tv_sec = req->atime;
+		time_buf[0].tv_nsec = 0;
+		time_buf[1].tv_sec = req->mtime;
+		time_buf[1].tv_nsec = 0;
+		if (futimens(file_info->fd, time_buf)) {
+			error("sbcast: uid:%u can't futimens `%s`: %m",
+			      key->uid, key->fname);
+		}
+	}
+}
+
 static void _rpc_file_bcast(slurm_msg_t *msg)
 {
 	int rc = SLURM_SUCCESS;
-	int64_t offset, inx;
 	sbcast_cred_arg_t *cred_arg;
-	file_bcast_info_t *file_info;
+	file_bcast_info_t *file_info, *cache_info = NULL;
 	file_bcast_msg_t *req = msg->data;
 	file_bcast_info_t key;
 
@@ -4489,6 +4737,16 @@ static void _rpc_file_bcast(slurm_msg_t *msg)
 		goto done;
 	}
 
+	/* the first block is enough when the file is in the cache */
+	if ((req->block_no == 1) && file_info->file_hash &&
+	    _bcast_cache_fetch(file_info, req)) {
+		_file_bcast_finish(file_info, req, &key);
+		slurm_rwlock_unlock(&file_bcast_lock);
+		_file_bcast_close_file(&key);
+		rc = ESLURMD_BCAST_CACHED;
+		goto done;
+	}
+
 	/* now decompress file */
 	if (bcast_decompress_data(req) < 0) {
 		error("sbcast: data decompression error for UID %u, file %s",
@@ -4498,44 +4756,37 @@ static void _rpc_file_bcast(slurm_msg_t *msg)
 		goto done;
 	}
 
-	offset = 0;
-	while (req->block_len - offset) {
-		inx = write(file_info->fd, &req->block[offset],
-			    (req->block_len - offset));
-		if (inx == -1) {
-			if ((errno == EINTR) || (errno == EAGAIN))
-				continue;
-			error("sbcast: uid:%u can't write `%s`: %m",
-			      key.uid, key.fname);
-			slurm_rwlock_unlock(&file_bcast_lock);
-			rc = SLURM_ERROR;
-			goto done;
-		}
-		offset += inx;
+	/*
+	 * Write at the block offset, senders may have several blocks in
+	 * flight and they can arrive in any order.
+	 */
+	if ((rc = _bcast_pwrite(file_info->fd, req->block, req->block_len,
+				req->block_offset))) {
+		error("sbcast: uid:%u can't write `%s`: %s",
+		      key.uid, key.fname, slurm_strerror(rc));
+		slurm_rwlock_unlock(&file_bcast_lock);
+		rc = SLURM_ERROR;
+		goto done;
 	}
 
 	file_info->last_update = time(NULL);
 
-	if ((req->flags & FILE_BCAST_LAST_BLOCK) &&
-	    fchmod(file_info->fd, (req->modes & 0777))) {
-		error("sbcast: uid:%u can't chmod `%s`: %m",
-		      key.uid, key.fname);
-	}
-	if ((req->flags & FILE_BCAST_LAST_BLOCK) &&
-	    fchown(file_info->fd, key.uid, key.gid)) {
-		error("sbcast: uid:%u gid:%u can't chown `%s`: %m",
-		      key.uid, key.gid, key.fname);
-	}
-	if ((req->flags & FILE_BCAST_LAST_BLOCK) && req->atime) {
-		struct timespec time_buf[2];
-		time_buf[0].tv_sec = req->atime;
-		time_buf[0].tv_nsec = 0;
-		time_buf[1].tv_sec = req->mtime;
-		time_buf[1].tv_nsec = 0;
-		if (futimens(file_info->fd, time_buf)) {
-			error("sbcast: uid:%u can't futimens `%s`: %m",
-			      key.uid, key.fname);
+	if (req->flags & FILE_BCAST_LAST_BLOCK) {
+		/* cached after the reply, copying can outlast the sender */
+		if (file_info->file_hash) {
+			cache_info = xmalloc(sizeof(*cache_info));
+			cache_info->uid = file_info->uid;
+			cache_info->fname = xstrdup(file_info->fname);
+			cache_info->file_hash = xstrdup(file_info->file_hash);
+			if ((cache_info->fd = dup(file_info->fd)) < 0) {
+				error("sbcast: can't dup `%s` for the cache: %m",
+				      key.fname);
+				cache_info->fd = 0;
+				_free_file_bcast_info_t(cache_info);
+				cache_info = NULL;
+			}
 		}
+		_file_bcast_finish(file_info, req, &key);
 	}
 
 	slurm_rwlock_unlock(&file_bcast_lock);
@@ -4546,6 +4797,9 @@ static void _rpc_file_bcast(slurm_msg_t *msg)
 
 done:
 	slurm_send_rc_msg(msg, rc);
+
+	if (cache_info)
+		slurm_thread_create_detached(_bcast_cache_store, cache_info);
 }
 
 static int _file_bcast_register_file(slurm_msg_t *msg,
@@ -4557,10 +4811,16 @@ static int _file_bcast_register_file(slurm_msg_t *msg,
 	file_bcast_info_t *file_info;
 	libdir_rec_t *libdir = NULL;
 	bool force_opt = false;
+	char *cache_path = NULL;
 
 	force_opt = req->flags & FILE_BCAST_FORCE;
 
-	flags = O_WRONLY | O_CREAT;
+	/* files added to the cache are read back once received */
+	if (req->file_hash &&
+	    (cache_path = _bcast_cache_path(key->uid, req->file_hash)))
+		flags = O_RDWR | O_CREAT;
+	else
+		flags = O_WRONLY | O_CREAT;
 	if (force_opt)
 		flags |= O_TRUNC;
 	else
@@ -4571,6 +4831,7 @@ static int _file_bcast_register_file(slurm_msg_t *msg,
 			    false, false, &fd);
 	if (rc != SLURM_SUCCESS) {
 		error("Unable to open %s: %s", req->fname, strerror(rc));
+		xfree(cache_path);
 		return rc;
 	}
 
@@ -4592,6 +4853,7 @@ static int _file_bcast_register_file(slurm_msg_t *msg,
 			 */
 			if (fd > 0)
 				close(fd);
+			xfree(cache_path);
 			return rc;
 		}
 
@@ -4607,6 +4869,9 @@ static int _file_bcast_register_file(slurm_msg_t *msg,
 
 	file_info = xmalloc(sizeof(file_bcast_info_t));
 	file_info->fd = fd;
+	if (cache_path)
+		file_info->file_hash = xstrdup(req->file_hash);
+	xfree(cache_path);
 	file_info->fname = xstrdup(req->fname);
 	file_info->uid = key->uid;
 	file_info->gid = key->gid;
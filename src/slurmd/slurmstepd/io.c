@@ -68,6 +68,7 @@
 #include "src/common/macros.h"
 #include "src/common/net.h"
 #include "src/common/read_config.h"
+#include "src/common/timers.h"
 #include "src/common/write_labelled_message.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
@@ -84,6 +85,14 @@
 #define STDIO_MAX_FREE_BUF 1024
 #define STDIO_MAX_MSG_CACHE 128
 
+/*
+ * Output for a client that understands SLURM_IO_BATCH is held back for at
+ * most STDIO_BATCH_DELAY_MSEC so output from many tasks can be coalesced
+ * into one frame, unless a full batch is already queued: either
+ * SLURM_IO_MAX_BATCH_MSGS messages or SLURM_IO_MAX_BATCH_LEN bytes.
+ */
+#define STDIO_BATCH_DELAY_MSEC 5
+
 struct io_buf {
 	int ref_count;
 	uint32_t length;
@@ -133,6 +142,11 @@ struct client_io_info {
 
 	/* true if writing to a file, false if writing to a socket */
 	bool is_local_file;
+
+	/* Coalesce output into SLURM_IO_BATCH messages */
+	bool batch_io;
+	struct io_buf *batch_msg;
+	struct timeval hold_start;
 };
 
 
@@ -220,6 +234,8 @@ static void _free_incoming_msg(struct io_buf *msg, stepd_step_rec_t *step);
 static void _free_all_outgoing_msgs(list_t *msg_queue, stepd_step_rec_t *step);
 static bool _incoming_buf_free(stepd_step_rec_t *step);
 static bool _outgoing_buf_free(stepd_step_rec_t *step);
+static bool _client_hold_output(struct client_io_info *client);
+static struct io_buf *_client_build_batch(struct client_io_info *client);
 static int  _send_connection_okay_response(stepd_step_rec_t *step);
 static struct io_buf *_build_connection_okay_message(stepd_step_rec_t *step);
 
@@ -297,14 +313,144 @@ _client_writable(eio_obj_t *obj)
 		debug5("  client->out.msg_queue queue length = %d",
 		       list_count(client->msg_queue));
 
-	if (client->out_msg != NULL
-	    || !list_is_empty(client->msg_queue))
+	if (client->out_msg != NULL)
 		return true;
 
+	if (!list_is_empty(client->msg_queue)) {
+		if (_client_hold_output(client)) {
+			debug5("  false, holding output for batching");
+			return false;
+		}
+		return true;
+	}
+
 	debug5("  false");
 	return false;
 }
 
+/*
+ * Return true if the queued messages of a client fill a SLURM_IO_BATCH,
+ * by count or by bytes.
+ */
+static bool _client_batch_full(struct client_io_info *client)
+{
+	struct io_buf *msg;
+	list_itr_t *itr;
+	uint32_t len = 0;
+	int cnt = 0;
+
+	itr = list_iterator_create(client->msg_queue);
+	while ((msg = list_next(itr))) {
+		len += msg->length;
+		cnt++;
+		if ((len >= SLURM_IO_MAX_BATCH_LEN) ||
+		    (cnt >= SLURM_IO_MAX_BATCH_MSGS))
+			break;
+	}
+	list_iterator_destroy(itr);
+
+	return ((len >= SLURM_IO_MAX_BATCH_LEN) ||
+		(cnt >= SLURM_IO_MAX_BATCH_MSGS));
+}
+
+/*
+ * Return true if the queued output of a client should wait for more output
+ * to arrive before being sent. Bounded by STDIO_BATCH_DELAY_MSEC from the
+ * time output was first seen queued, and never once a full batch is queued.
+ */
+static bool _client_hold_output(struct client_io_info *client)
+{
+	int delta_msec;
+
+	if (!client->batch_io)
+		return false;
+	if (_client_batch_full(client))
+		return false;
+
+	/* Sets hold_start to now if unset */
+	delta_msec = slurm_delta_tv(&client->hold_start) / 1000;
+	if (delta_msec >= STDIO_BATCH_DELAY_MSEC)
+		return false;
+
+	eio_set_poll_timeout(client->step->eio,
+			     STDIO_BATCH_DELAY_MSEC - delta_msec);
+	return true;
+}
+
+/* Return true if msg is task output (or its eof) that may be batched */
+static bool _batchable_msg(struct io_buf *msg)
+{
+	buf_t *header_tmp_buf;
+	io_hdr_t header;
+	int rc;
+
+	header_tmp_buf = create_buf(msg->data, msg->length);
+	rc = io_hdr_unpack(&header, header_tmp_buf);
+	header_tmp_buf->head = NULL;	/* CLANG false positive bug here */
+	FREE_NULL_BUFFER(header_tmp_buf);
+
+	return (!rc && ((header.type == SLURM_IO_STDOUT) ||
+			(header.type == SLURM_IO_STDERR)));
+}
+
+/*
+ * Move output messages at the head of a client's queue into a single
+ * SLURM_IO_BATCH message. Returns NULL if fewer than two messages can be
+ * coalesced, leaving the queue untouched.
+ */
+static struct io_buf *_client_build_batch(struct client_io_info *client)
+{
+	struct io_buf *batch, *msg;
+	buf_t *packbuf;
+	io_hdr_t header;
+	list_itr_t *itr;
+	uint32_t len = 0;
+	int cnt = 0;
+
+	/* A connection test response ends a batch so ordering is kept */
+	itr = list_iterator_create(client->msg_queue);
+	while ((msg = list_next(itr)) && (cnt < SLURM_IO_MAX_BATCH_MSGS)) {
+		if (((len + msg->length) > SLURM_IO_MAX_BATCH_LEN) ||
+		    !_batchable_msg(msg))
+			break;
+		len += msg->length;
+		cnt++;
+	}
+	list_iterator_destroy(itr);
+
+	if (cnt < 2)
+		return NULL;
+
+	if (!client->batch_msg) {
+		client->batch_msg = xmalloc(sizeof(*client->batch_msg));
+		client->batch_msg->data = xmalloc(IO_HDR_PACKET_BYTES +
+						  SLURM_IO_MAX_BATCH_LEN);
+	}
+	batch = client->batch_msg;
+
+	header.type = SLURM_IO_BATCH;
+	header.gtaskid = 0;  /* Unused */
+	header.ltaskid = cnt;
+	header.length = len;
+
+	packbuf = create_buf(batch->data, IO_HDR_PACKET_BYTES);
+	io_hdr_pack(&header, packbuf);
+	packbuf->head = NULL;	/* CLANG false positive bug here */
+	FREE_NULL_BUFFER(packbuf);
+
+	batch->length = IO_HDR_PACKET_BYTES;
+	while (cnt--) {
+		msg = list_dequeue(client->msg_queue);
+		memcpy(batch->data + batch->length, msg->data, msg->length);
+		batch->length += msg->length;
+		_free_outgoing_msg(msg, client->step);
+	}
+
+	debug5("%s: batched %u messages, %u bytes",
+	       __func__, header.ltaskid, batch->length);
+	return batch;
+}
+
 static int _client_read(eio_obj_t *obj, list_t *objs)
 {
 	struct client_io_info *client = (struct client_io_info *) obj->arg;
@@ -456,7 +602,10 @@ static int _client_write(eio_obj_t *obj, list_t *objs)
 	 * next message from the queue.
 	 */
 	if (client->out_msg == NULL) {
-		client->out_msg = list_dequeue(client->msg_queue);
+		client->hold_start.tv_sec = 0;
+		if (!client->batch_io ||
+		    !(client->out_msg = _client_build_batch(client)))
+			client->out_msg = list_dequeue(client->msg_queue);
 		if (client->out_msg == NULL) {
 			debug5("_client_write: nothing in the queue");
 			return SLURM_SUCCESS;
@@ -496,7 +645,9 @@ again:
 	if (client->out_remaining > 0)
 		return SLURM_SUCCESS;
 
-	_free_outgoing_msg(client->out_msg, client->step);
+	/* The batch buffer belongs to the client, not the message pool */
+	if (client->out_msg != client->batch_msg)
+		_free_outgoing_msg(client->out_msg, client->step);
 	client->out_msg = NULL;
 
 	return SLURM_SUCCESS;
@@ -1535,6 +1686,17 @@ io_create_local_client(const char *filename, int file_flags,
 	return SLURM_SUCCESS;
 }
 
+/*
+ * Clients from SLURM_24_11_PROTOCOL_VERSION on can demultiplex SLURM_IO_BATCH
+ * messages. Interactive pty steps are never delayed.
+ */
+static bool _client_batch_io(srun_info_t *srun, stepd_step_rec_t *step)
+{
+	if (step->flags & LAUNCH_PTY)
+		return false;
+	return (srun->protocol_version >= SLURM_24_11_PROTOCOL_VERSION);
+}
+
 /*
  * Create the initial TCP connection back to a waiting client (e.g. srun).
  *
@@ -1588,6 +1750,7 @@ io_initial_client_connect(srun_info_t *srun, stepd_step_rec_t *step,
 	client->labelio = false;
 	client->taskid_width = 0;
 	client->is_local_file = false;
+	client->batch_io = _client_batch_io(srun, step);
 
 	obj = eio_obj_create(sock, &client_ops, (void *)client);
 	list_append(step->clients, (void *)obj);
@@ -1642,6 +1805,7 @@ io_client_connect(srun_info_t *srun, stepd_step_rec_t *step)
 	client->labelio = false;
 	client->taskid_width = 0;
 	client->is_local_file = false;
+	client->batch_io = _client_batch_io(srun, step);
 
 	/* client object adds itself to step->clients in _client_writable */
 
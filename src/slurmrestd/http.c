@@ -90,6 +90,59 @@ typedef struct {
 	const char *accept;
 } request_t;
 
+#define MAGIC_STREAM 0xa1b7ee2d
+/* State of a chunked response being streamed to client */
+typedef struct {
+	int magic; /* MAGIC_STREAM */
+	http_context_t *context;
+	http_stream_func_t func;
+	void (*free_func)(void *arg);
+	void *arg;
+	size_t bytes; /* total body bytes queued */
+	uint32_t chunks; /* total chunks queued */
+} stream_t;
+
+#define MAGIC_JOB 0xa1b7ee2e
+/* Request received from client waiting to be processed */
+typedef struct {
+	int magic; /* MAGIC_JOB */
+	request_t *request;
+	http_request_method_t method;
+	uint16_t http_major;
+	uint16_t http_minor;
+	/* private context used to process request */
+	http_context_t context;
+	/* handler has been claimed by a worker or on_http_connection_finish() */
+	bool started;
+	/* handler has completed and response is in context.out */
+	bool done;
+} job_t;
+
+#define MAGIC_PIPELINE 0xa1b7ee2f
+/* Max pipelined requests of a connection waiting on a response */
+#define PIPELINE_MAX_JOBS 16
+/* Pipelined HTTP requests of a connection */
+typedef struct {
+	int magic; /* MAGIC_PIPELINE */
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	conmgr_fd_t *con;
+	/* requests parsed by current parse_http() call (job_t) */
+	list_t *parsed;
+	/* requests dispatched to workers in order received (job_t) */
+	list_t *jobs;
+	/* number of handlers currently running */
+	int running;
+	/* connection context, queued jobs and queued flush */
+	int refs;
+	/* _pipeline_flush() already queued */
+	bool flush_queued;
+	/* parse_http() deferred parsing as PIPELINE_MAX_JOBS was reached */
+	bool paused;
+	/* connection is closing and no more responses will be sent */
+	bool closing;
+} pipeline_t;
+
 /* default keep_alive value which appears to be implementation specific */
 static int DEFAULT_KEEP_ALIVE = 5; //default to 5s to match apache2
 
@@ -441,18 +494,42 @@ static char *_fmt_header(const char *name, const char *value)
 	return xstrdup_printf("%s: %s"CRLF, name, value);
 }
 
+/*
+ * Write data to connection or buffer it for pipelined request
+ * IN con connection of request
+ * IN context context of request or NULL
+ * IN data data to write
+ * IN bytes number of bytes in data
+ * RET SLURM_SUCCESS or error
+ */
+static int _write_data(conmgr_fd_t *con, http_context_t *context,
+		       const void *data, size_t bytes)
+{
+	if (!context || !context->out)
+		return conmgr_queue_write_data(con, data, bytes);
+
+	if (try_grow_buf_remaining(context->out, bytes))
+		return ENOMEM;
+
+	memcpy((get_buf_data(context->out) + get_buf_offset(context->out)),
+	       data, bytes);
+	set_buf_offset(context->out, (get_buf_offset(context->out) + bytes));
+	return SLURM_SUCCESS;
+}
+
 /*
  * Create and write formatted header
- * IN request HTTP request
+ * IN con connection of request
+ * IN context context of request or NULL
  * IN name header name
  * IN value header value
- * RET formatted string (must xfree)
+ * RET SLURM_SUCCESS or error
  * */
-static int _write_fmt_header(conmgr_fd_t *con, const char *name,
-			     const char *value)
+static int _write_fmt_header(conmgr_fd_t *con, http_context_t *context,
+			     const char *name, const char *value)
 {
 	const char *buffer = _fmt_header(name, value);
-	int rc = conmgr_queue_write_data(con, buffer, strlen(buffer));
+	int rc = _write_data(con, context, buffer, strlen(buffer));
 	xfree(buffer);
 	return rc;
 }
@@ -471,31 +548,41 @@ static char *_fmt_header_num(const char *name, size_t value)
 
 extern int send_http_connection_close(http_context_t *ctxt)
 {
-	return _write_fmt_header(ctxt->con, "Connection", "Close");
+	return _write_fmt_header(ctxt->con, ctxt, "Connection", "Close");
+}
+
+extern void close_http_connection(http_context_t *ctxt)
+{
+	xassert(ctxt->magic == MAGIC);
+
+	if (ctxt->out)
+		ctxt->close = true;
+	else
+		conmgr_queue_close_fd(ctxt->con);
 }
 
 /*
  * Create and write formatted numerical header
- * IN request HTTP request
+ * IN con connection of request
+ * IN context context of request or NULL
  * IN name header name
  * IN value header value
- * RET formatted string (must xfree)
+ * RET SLURM_SUCCESS or error
  * */
-static int _write_fmt_num_header(conmgr_fd_t *con, const char *name,
-				 size_t value)
+static int _write_fmt_num_header(conmgr_fd_t *con, http_context_t *context,
+				 const char *name, size_t value)
 {
 	const char *buffer = _fmt_header_num(name, value);
-	int rc = conmgr_queue_write_data(con, buffer, strlen(buffer));
+	int rc = _write_data(con, context, buffer, strlen(buffer));
 	xfree(buffer);
 	return rc;
 }
 
-extern int send_http_response(const send_http_response_args_t *args)
+/* Write status line and requested headers of response */
+static int _write_status_headers(const send_http_response_args_t *args)
 {
 	char *buffer = NULL;
 	int rc = SLURM_SUCCESS;
-	xassert(args->status_code != HTTP_STATUS_NONE);
-	xassert(args->body_length == 0 || (args->body_length && args->body));
 
 	log_flag(NET, "%s: [%s] sending response %u: %s",
 	       __func__, conmgr_fd_get_name(args->con),
@@ -507,7 +594,7 @@ extern int send_http_response(const send_http_response_args_t *args)
 		   args->http_major, args->http_minor, args->status_code,
 		   get_http_status_code_string(args->status_code));
 
-	rc = conmgr_queue_write_data(args->con, buffer, strlen(buffer));
+	rc = _write_data(args->con, args->context, buffer, strlen(buffer));
 	xfree(buffer);
 
 	if (rc)
@@ -518,22 +605,31 @@ extern int send_http_response(const send_http_response_args_t *args)
 		list_itr_t *itr = list_iterator_create(args->headers);
 		http_header_entry_t *header = NULL;
 		while ((header = list_next(itr))) {
-			if ((rc = _write_fmt_header(args->con, header->name,
-						    header->value)))
+			if ((rc = _write_fmt_header(args->con, args->context,
+						    header->name, header->value)))
 				break;
 		}
 		list_iterator_destroy(itr);
-
-		if (rc)
-			return rc;
 	}
 
+	return rc;
+}
+
+extern int send_http_response(const send_http_response_args_t *args)
+{
+	int rc = SLURM_SUCCESS;
+	xassert(args->status_code != HTTP_STATUS_NONE);
+	xassert(args->body_length == 0 || (args->body_length && args->body));
+
+	if ((rc = _write_status_headers(args)))
+		return rc;
+
 	if (args->body && args->body_length) {
 		/* RFC7230-3.3.2 limits response of Content-Length */
 		if ((args->status_code < 100) ||
 		    ((args->status_code >= 200) &&
 		     (args->status_code != 204))) {
-			if ((rc = _write_fmt_num_header(args->con,
+			if ((rc = _write_fmt_num_header(args->con, args->context,
 				"Content-Length", args->body_length))) {
 				return rc;
 			}
@@ -541,10 +637,11 @@ extern int send_http_response(const send_http_response_args_t *args)
 
 		if (args->body_encoding &&
 		    (rc = _write_fmt_header(
-			     args->con, "Content-Type", args->body_encoding)))
+			     args->con, args->context, "Content-Type",
+			     args->body_encoding)))
 			return rc;
 
-		if ((rc = conmgr_queue_write_data(args->con, CRLF,
+		if ((rc = _write_data(args->con, args->context, CRLF,
 						  strlen(CRLF))))
 			return rc;
 
@@ -553,7 +650,7 @@ extern int send_http_response(const send_http_response_args_t *args)
 			 get_http_status_code_string(args->status_code),
 			 args->status_code, args->body);
 
-		if ((rc = conmgr_queue_write_data(args->con, args->body,
+		if ((rc = _write_data(args->con, args->context, args->body,
 						  args->body_length)))
 			return rc;
 	} else if (((args->status_code >= 100) && (args->status_code < 200)) ||
@@ -563,7 +660,7 @@ extern int send_http_response(const send_http_response_args_t *args)
 		 * RFC2616 requires empty line after headers for return code
 		 * that "MUST NOT" include a message body
 		 */
-		if ((rc = conmgr_queue_write_data(args->con, CRLF,
+		if ((rc = _write_data(args->con, args->context, CRLF,
 						  strlen(CRLF))))
 			return rc;
 	}
@@ -571,14 +668,223 @@ extern int send_http_response(const send_http_response_args_t *args)
 	return rc;
 }
 
+static void _stream_free(stream_t *stream)
+{
+	xassert(stream->magic == MAGIC_STREAM);
+	stream->magic = ~MAGIC_STREAM;
+
+	if (stream->free_func)
+		stream->free_func(stream->arg);
+	xfree(stream);
+}
+
+/* Stream is done: resume processing any pipelined requests */
+static void _stream_end(stream_t *stream)
+{
+	http_context_t *context = stream->context;
+
+	xassert(context->magic == MAGIC);
+	xassert(context->stream == stream);
+
+	log_flag(NET, "%s: [%s] streamed %zu bytes in %u chunks",
+		 __func__, conmgr_fd_get_name(context->con), stream->bytes,
+		 stream->chunks);
+
+	context->stream = NULL;
+	_stream_free(stream);
+
+	/* parse_http() deferred any requests received while streaming */
+	conmgr_fd_retry_on_data(context->con);
+}
+
+static void _stream_chunk(conmgr_callback_args_t conmgr_args, void *arg)
+{
+	stream_t *stream = arg;
+	conmgr_fd_t *con = conmgr_args.con;
+	char *chunk = NULL, *header = NULL;
+	size_t bytes = 0;
+	int rc;
+
+	xassert(stream->magic == MAGIC_STREAM);
+
+	if (conmgr_args.status == CONMGR_WORK_STATUS_CANCELLED) {
+		/* connection context may already be gone */
+		_stream_free(stream);
+		return;
+	}
+
+	if ((rc = stream->func(stream->arg, &chunk, &bytes))) {
+		error("%s: [%s] aborting streamed response after %zu bytes: %s",
+		      __func__, conmgr_fd_get_name(con), stream->bytes,
+		      slurm_strerror(rc));
+		xfree(chunk);
+		conmgr_queue_close_fd(con);
+		_stream_end(stream);
+		return;
+	}
+
+	if (!bytes) {
+		/* RFC7230-4.1 last-chunk with empty trailer */
+		xfree(chunk);
+		(void) conmgr_queue_write_data(con, "0"CRLF CRLF,
+					       strlen("0"CRLF CRLF));
+		_stream_end(stream);
+		return;
+	}
+
+	header = xstrdup_printf("%zx"CRLF, bytes);
+	if (!(rc = conmgr_queue_write_data(con, header, strlen(header))) &&
+	    !(rc = conmgr_queue_write_data(con, chunk, bytes)))
+		rc = conmgr_queue_write_data(con, CRLF, strlen(CRLF));
+	xfree(header);
+	xfree(chunk);
+
+	if (rc) {
+		conmgr_queue_close_fd(con);
+		_stream_end(stream);
+		return;
+	}
+
+	stream->bytes += bytes;
+	stream->chunks++;
+
+	/* only produce next chunk once this one has been written out */
+	conmgr_add_work_con_write_complete_fifo(con, _stream_chunk, stream);
+}
+
+/* Collect full body from func for clients that can not accept chunks */
+static int _send_stream_whole(http_context_t *context,
+			      const send_http_response_args_t *args,
+			      http_stream_func_t func, void *arg)
+{
+	send_http_response_args_t send_args = *args;
+	char *body = NULL, *chunk;
+	size_t body_length = 0, bytes;
+	int rc;
+
+	while (true) {
+		chunk = NULL;
+		bytes = 0;
+
+		if ((rc = func(arg, &chunk, &bytes)) || !bytes) {
+			xfree(chunk);
+			break;
+		}
+
+		if (!body) {
+			body = chunk;
+			body_length = bytes;
+			continue;
+		}
+
+		xrealloc(body, (body_length + bytes + 1));
+		memcpy((body + body_length), chunk, bytes);
+		body_length += bytes;
+		xfree(chunk);
+	}
+
+	if (!rc) {
+		send_args.context = context;
+		send_args.body = body;
+		send_args.body_length = body_length;
+		rc = send_http_response(&send_args);
+	}
+
+	xfree(body);
+	return rc;
+}
+
+extern int send_http_response_stream(http_context_t *context,
+				     const send_http_response_args_t *args,
+				     http_stream_func_t func,
+				     void (*free_func)(void *arg), void *arg)
+{
+	stream_t *stream;
+	int rc;
+
+	xassert(context->magic == MAGIC);
+	xassert(args->con == context->con);
+	xassert(!context->stream);
+	/* RFC7230-3.3 status codes that may include a body */
+	xassert((args->status_code >= 200) && (args->status_code != 204) &&
+		(args->status_code != 304));
+
+	/*
+	 * RFC7230-4.1 chunked transfer coding requires HTTP/1.1.
+	 * Pipelined requests are buffered to be sent in order.
+	 */
+	if ((args->http_major < 1) ||
+	    ((args->http_major == 1) && (args->http_minor < 1)) ||
+	    !context->request || context->out) {
+		rc = _send_stream_whole(context, args, func, arg);
+		if (free_func)
+			free_func(arg);
+		return rc;
+	}
+
+	if (!(rc = _write_status_headers(args)) &&
+	    !(rc = _write_fmt_header(args->con, context,
+				     "Transfer-Encoding", "chunked")) &&
+	    (!args->body_encoding ||
+	     !(rc = _write_fmt_header(args->con, context,
+				      "Content-Type", args->body_encoding))))
+		rc = conmgr_queue_write_data(args->con, CRLF, strlen(CRLF));
+
+	if (rc) {
+		if (free_func)
+			free_func(arg);
+		return rc;
+	}
+
+	stream = xmalloc(sizeof(*stream));
+	stream->magic = MAGIC_STREAM;
+	stream->context = context;
+	stream->func = func;
+	stream->free_func = free_func;
+	stream->arg = arg;
+	context->stream = stream;
+
+	log_flag(NET, "%s: [%s] streaming chunked response %u: %s",
+		 __func__, conmgr_fd_get_name(args->con), args->status_code,
+		 get_http_status_code_string(args->status_code));
+
+	conmgr_add_work_con_write_complete_fifo(args->con, _stream_chunk,
+						stream);
+	return SLURM_SUCCESS;
+}
+
+/* Create job for request to be processed with private context */
+static job_t *_job_new(http_context_t *context, request_t *request,
+		       http_request_method_t method, uint16_t http_major,
+		       uint16_t http_minor)
+{
+	job_t *job = xmalloc(sizeof(*job));
+
+	job->magic = MAGIC_JOB;
+	job->request = request;
+	job->method = method;
+	job->http_major = http_major;
+	job->http_minor = http_minor;
+	job->context.magic = MAGIC;
+	job->context.con = context->con;
+	job->context.on_http_request = context->on_http_request;
+	job->context.pipeline = context->pipeline;
+	job->context.request = request;
+
+	return job;
+}
+
 static int _send_reject(const http_parser *parser,
 			http_status_code_t status_code)
 {
 	request_t *request = parser->data;
 	xassert(request->magic == MAGIC_REQUEST_T);
+	http_context_t *context = request->context;
+	pipeline_t *pipeline = context->pipeline;
+	job_t *job = NULL;
 
 	send_http_response_args_t args = {
-		.con = request->context->con,
+		.con = context->con,
 		.http_major = parser->http_major,
 		.http_minor = parser->http_minor,
 		.status_code = status_code,
@@ -590,6 +896,17 @@ static int _send_reject(const http_parser *parser,
 	if ((args.http_major == 0) && (args.http_minor == 0))
 		args.http_minor = 9;
 
+	slurm_mutex_lock(&pipeline->mutex);
+	if (!list_is_empty(pipeline->parsed) ||
+	    !list_is_empty(pipeline->jobs)) {
+		/* Send rejection after responses to earlier requests */
+		job = _job_new(context, NULL, HTTP_REQUEST_INVALID,
+			       args.http_major, args.http_minor);
+		job->context.out = init_buf(BUF_SIZE);
+		args.context = &job->context;
+	}
+	slurm_mutex_unlock(&pipeline->mutex);
+
 	/* Ignore response since this connection is already dead */
 	(void) send_http_response(&args);
 	FREE_NULL_LIST(args.headers);
@@ -597,27 +914,59 @@ static int _send_reject(const http_parser *parser,
 	if (request->connection_close ||
 	    ((parser->http_major == 1) && (parser->http_minor >= 1)) ||
 	     (parser->http_major > 1))
-		send_http_connection_close(request->context);
+		send_http_connection_close(job ? &job->context : context);
+
+	if (job) {
+		/* connection is closed once rejection is sent */
+		job->context.close = true;
+		job->started = true;
+		job->done = true;
+
+		slurm_mutex_lock(&pipeline->mutex);
+		list_append(pipeline->parsed, job);
+		slurm_mutex_unlock(&pipeline->mutex);
+	}
 
-	/* ensure connection gets closed */
-	(void) conmgr_queue_close_fd(request->context->con);
+	/*
+	 * Ensure connection gets closed. Only input is closed right away.
+	 * on_http_connection_finish() sends any pending responses.
+	 */
+	(void) conmgr_queue_close_fd(context->con);
 
 	return HTTP_PARSER_RETURN_ERROR;
 }
 
-static int _on_message_complete_request(http_parser *parser,
-				       http_request_method_t method,
-				       request_t *request)
+static void _free_job(job_t *job)
+{
+	xassert(job->magic == MAGIC_JOB);
+	job->magic = ~MAGIC_JOB;
+
+	_free_request_t(job->request);
+	FREE_NULL_BUFFER(job->context.out);
+	/* auth should have been released after handler */
+	xassert(!job->context.auth);
+	FREE_NULL_REST_AUTH(job->context.auth);
+	xfree(job);
+}
+
+static void _free_job_ptr(void *x)
+{
+	_free_job(x);
+}
+
+/* Call on_http_request for the job's request against given context */
+static void _run_job(job_t *job, http_context_t *context)
 {
 	int rc;
+	request_t *request = job->request;
 	on_http_request_args_t args = {
-		.method = method,
+		.method = job->method,
 		.headers = request->headers,
 		.path = request->path,
 		.query = request->query,
-		.context = request->context,
-		.http_major = parser->http_major,
-		.http_minor = parser->http_minor,
+		.context = context,
+		.http_major = job->http_major,
+		.http_minor = job->http_minor,
 		.content_type = request->content_type,
 		.accept = request->accept,
 		.body = request->body,
@@ -625,20 +974,223 @@ static int _on_message_complete_request(http_parser *parser,
 		.body_encoding = request->body_encoding
 	};
 
+	xassert(job->magic == MAGIC_JOB);
 	xassert(request->magic == MAGIC_REQUEST_T);
 
-	if ((rc = request->context->on_http_request(&args))) {
+	if ((rc = context->on_http_request(&args))) {
 		log_flag(NET, "%s: [%s] on_http_request rejected: %s",
-			 __func__, conmgr_fd_get_name(request->context->con),
+			 __func__, conmgr_fd_get_name(context->con),
 			 slurm_strerror(rc));
-		return HTTP_PARSER_RETURN_ERROR;
-	} else
-		return SLURM_SUCCESS;
+		close_http_connection(context);
+	} else if (request->connection_close) {
+		/* Notify client that this connection will be closed now */
+		send_http_connection_close(context);
+		close_http_connection(context);
+	}
+
+	FREE_NULL_REST_AUTH(context->auth);
+}
+
+static void _pipeline_free(pipeline_t *pipeline)
+{
+	xassert(pipeline->magic == MAGIC_PIPELINE);
+	xassert(!pipeline->refs);
+	xassert(!pipeline->running);
+	pipeline->magic = ~MAGIC_PIPELINE;
+
+	FREE_NULL_LIST(pipeline->parsed);
+	FREE_NULL_LIST(pipeline->jobs);
+	slurm_cond_destroy(&pipeline->cond);
+	slurm_mutex_destroy(&pipeline->mutex);
+	xfree(pipeline);
+}
+
+/* Release reference to pipeline. Pipeline mutex must be locked (unlocks). */
+static void _pipeline_release(pipeline_t *pipeline)
+{
+	xassert(pipeline->refs > 0);
+
+	if (--pipeline->refs) {
+		slurm_mutex_unlock(&pipeline->mutex);
+		return;
+	}
+
+	slurm_mutex_unlock(&pipeline->mutex);
+	_pipeline_free(pipeline);
+}
+
+/* Send out responses of completed jobs in the order received */
+static void _pipeline_flush(conmgr_callback_args_t conmgr_args, void *arg)
+{
+	pipeline_t *pipeline = arg;
+	job_t *job;
+
+	slurm_mutex_lock(&pipeline->mutex);
+	xassert(pipeline->magic == MAGIC_PIPELINE);
+	pipeline->flush_queued = false;
+
+	while (!pipeline->closing &&
+	       (conmgr_args.status != CONMGR_WORK_STATUS_CANCELLED) &&
+	       (job = list_peek(pipeline->jobs)) && job->done) {
+		bool close = job->context.close;
+
+		job = list_pop(pipeline->jobs);
+
+		log_flag(NET, "%s: [%s] sending %u byte response of pipelined request",
+			 __func__, conmgr_fd_get_name(pipeline->con),
+			 get_buf_offset(job->context.out));
+
+		(void) conmgr_queue_write_data(pipeline->con,
+					       get_buf_data(job->context.out),
+					       get_buf_offset(job->context.out));
+		_free_job(job);
+
+		if (close) {
+			/* skip any later requests */
+			pipeline->closing = true;
+			conmgr_queue_close_fd(pipeline->con);
+		}
+	}
+
+	if (pipeline->paused && !pipeline->closing &&
+	    (conmgr_args.status != CONMGR_WORK_STATUS_CANCELLED) &&
+	    (list_count(pipeline->jobs) < PIPELINE_MAX_JOBS)) {
+		/* resume parsing requests deferred by parse_http() */
+		pipeline->paused = false;
+		conmgr_fd_retry_on_data(pipeline->con);
+	}
+
+	_pipeline_release(pipeline);
+}
+
+static int _find_job_unstarted(void *x, void *arg)
+{
+	job_t *job = x;
+
+	xassert(job->magic == MAGIC_JOB);
+
+	return !job->started;
+}
+
+/* Run handler for pipelined request on any worker */
+static void _pipeline_work(conmgr_callback_args_t conmgr_args, void *arg)
+{
+	job_t *job = arg;
+	pipeline_t *pipeline = job->context.pipeline;
+	bool run;
+
+	xassert(job->magic == MAGIC_JOB);
+
+	slurm_mutex_lock(&pipeline->mutex);
+	xassert(pipeline->magic == MAGIC_PIPELINE);
+	if (job->started) {
+		/* already run by on_http_connection_finish() */
+		_pipeline_release(pipeline);
+		return;
+	}
+
+	job->started = true;
+	if ((run = (!pipeline->closing &&
+		    (conmgr_args.status != CONMGR_WORK_STATUS_CANCELLED))))
+		pipeline->running++;
+	slurm_mutex_unlock(&pipeline->mutex);
+
+	if (run)
+		_run_job(job, &job->context);
+
+	slurm_mutex_lock(&pipeline->mutex);
+	job->done = true;
+
+	if (run)
+		pipeline->running--;
+	slurm_cond_broadcast(&pipeline->cond);
+
+	if (!pipeline->closing && !pipeline->flush_queued &&
+	    (list_peek(pipeline->jobs) == job)) {
+		pipeline->flush_queued = true;
+		pipeline->refs++;
+		conmgr_add_work_con_fifo(pipeline->con, _pipeline_flush,
+					 pipeline);
+	}
+
+	_pipeline_release(pipeline);
+}
+
+/*
+ * Process requests parsed from connection.
+ * A lone request is processed directly as before. Pipelined requests are
+ * handed to workers to be processed concurrently with responses buffered
+ * until they can be sent in the order the requests were received.
+ */
+static void _pipeline_dispatch(http_context_t *context)
+{
+	pipeline_t *pipeline = context->pipeline;
+	job_t *job;
+
+	xassert(pipeline->magic == MAGIC_PIPELINE);
+
+	slurm_mutex_lock(&pipeline->mutex);
+	if ((list_count(pipeline->parsed) == 1) &&
+	    list_is_empty(pipeline->jobs) &&
+	    !((job_t *) list_peek(pipeline->parsed))->done) {
+		job = list_pop(pipeline->parsed);
+		slurm_mutex_unlock(&pipeline->mutex);
+
+		/* process directly against connection */
+		_run_job(job, context);
+		_free_job(job);
+		return;
+	}
+
+	while ((job = list_pop(pipeline->parsed))) {
+		list_append(pipeline->jobs, job);
+
+		/* rejected request already has its response */
+		if (job->done)
+			continue;
+
+		job->context.out = init_buf(BUF_SIZE);
+		pipeline->refs++;
+		conmgr_add_work_fifo(_pipeline_work, job);
+	}
+
+	if ((job = list_peek(pipeline->jobs)) && job->done &&
+	    !pipeline->flush_queued) {
+		pipeline->flush_queued = true;
+		pipeline->refs++;
+		conmgr_add_work_con_fifo(pipeline->con, _pipeline_flush,
+					 pipeline);
+	}
+
+	log_flag(NET, "%s: [%s] %d pipelined requests pending",
+		 __func__, conmgr_fd_get_name(context->con),
+		 list_count(pipeline->jobs));
+	slurm_mutex_unlock(&pipeline->mutex);
+}
+
+/* Queue up completed request to be processed after parsing */
+static void _pipeline_add(http_parser *parser, http_request_method_t method,
+			  request_t *request)
+{
+	http_context_t *context = request->context;
+	pipeline_t *pipeline = context->pipeline;
+	job_t *job = _job_new(context, request, method, parser->http_major,
+			      parser->http_minor);
+
+	xassert(pipeline->magic == MAGIC_PIPELINE);
+
+	slurm_mutex_lock(&pipeline->mutex);
+	list_append(pipeline->parsed, job);
+
+	/* stop parsing until responses have been sent */
+	if ((list_count(pipeline->parsed) + list_count(pipeline->jobs)) >=
+	    PIPELINE_MAX_JOBS)
+		http_parser_pause(parser, 1);
+	slurm_mutex_unlock(&pipeline->mutex);
 }
 
 static int _on_message_complete(http_parser *parser)
 {
-	int rc;
 	request_t *request = parser->data;
 	http_request_method_t method = HTTP_REQUEST_INVALID;
 
@@ -699,8 +1251,7 @@ static int _on_message_complete(http_parser *parser)
 		return _send_reject(parser, HTTP_STATUS_CODE_ERROR_BAD_REQUEST);
 	}
 
-	if ((rc = _on_message_complete_request(parser, method, request)))
-		return rc;
+	_pipeline_add(parser, method, request);
 
 	if (request->keep_alive) {
 		//TODO: implement keep alive correctly
@@ -719,16 +1270,9 @@ static int _on_message_complete(http_parser *parser)
 		nrequest->context = request->context;
 		request->context->request = nrequest;
 		parser->data = nrequest;
-		_free_request_t(request);
 	} else {
-		/* Notify client that this connection will be closed now */
-		if (request->connection_close)
-			send_http_connection_close(request->context);
-
-		conmgr_queue_close_fd(request->context->con);
-
+		/* connection is closed once response is sent */
 		request->context->request = NULL;
-		_free_request_t(request);
 		parser->data = NULL;
 	}
 
@@ -770,6 +1314,28 @@ extern int parse_http(conmgr_fd_t *con, void *x)
 
 	xassert(context->magic == MAGIC);
 
+	if (context->stream) {
+		log_flag(NET, "%s: [%s] deferring parsing until streamed response is complete",
+			 __func__, conmgr_fd_get_name(con));
+		return SLURM_SUCCESS;
+	}
+
+	if (context->pipeline) {
+		pipeline_t *pipeline = context->pipeline;
+		bool paused;
+
+		slurm_mutex_lock(&pipeline->mutex);
+		paused = pipeline->paused = (list_count(pipeline->jobs) >=
+					     PIPELINE_MAX_JOBS);
+		slurm_mutex_unlock(&pipeline->mutex);
+
+		if (paused) {
+			log_flag(NET, "%s: [%s] deferring parsing until pipelined responses are sent",
+				 __func__, conmgr_fd_get_name(con));
+			return SLURM_SUCCESS;
+		}
+	}
+
 	if (!request) {
 		/* Connection has already been closed */
 		FREE_NULL_REST_AUTH(context->auth);
@@ -799,6 +1365,10 @@ extern int parse_http(conmgr_fd_t *con, void *x)
 		 __func__, conmgr_fd_get_name(con), bytes_parsed,
 		 bytes_incoming);
 
+	/* _pipeline_add() paused parser once PIPELINE_MAX_JOBS was reached */
+	if (HTTP_PARSER_ERRNO(parser) == HPE_PAUSED)
+		http_parser_pause(parser, 0);
+
 	if (bytes_parsed > 0)
 		conmgr_fd_mark_consumed_in_buffer(con, bytes_parsed);
 	else if (parser->http_errno) {
@@ -813,6 +1383,8 @@ extern int parse_http(conmgr_fd_t *con, void *x)
 		rc = SLURM_UNEXPECTED_MSG_ERROR;
 	}
 
+	_pipeline_dispatch(context);
+
 	FREE_NULL_REST_AUTH(context->auth);
 
 	return rc;
@@ -932,6 +1504,7 @@ extern http_context_t *setup_http_context(conmgr_fd_t *con,
 {
 	http_context_t *context = _http_context_new();
 	request_t *request = xmalloc(sizeof(*request));
+	pipeline_t *pipeline;
 
 	xassert(context->magic == MAGIC);
 	xassert(!context->con);
@@ -942,17 +1515,85 @@ extern http_context_t *setup_http_context(conmgr_fd_t *con,
 	context->request = request;
 	request->headers = list_create(_free_http_header);
 
+	pipeline = xmalloc(sizeof(*pipeline));
+	pipeline->magic = MAGIC_PIPELINE;
+	slurm_mutex_init(&pipeline->mutex);
+	slurm_cond_init(&pipeline->cond, NULL);
+	pipeline->con = con;
+	pipeline->parsed = list_create(_free_job_ptr);
+	pipeline->jobs = list_create(_free_job_ptr);
+	pipeline->refs = 1;
+	context->pipeline = pipeline;
+
 	return context;
 }
 
 extern void on_http_connection_finish(conmgr_fd_t *con, void *ctxt)
 {
 	http_context_t *context = (http_context_t *) ctxt;
+	pipeline_t *pipeline;
 
 	if (!context)
 		return;
 	xassert(context->magic == MAGIC);
 
+	if ((pipeline = context->pipeline)) {
+		list_itr_t *itr;
+		job_t *job;
+
+		slurm_mutex_lock(&pipeline->mutex);
+
+		/*
+		 * Client may have only closed its side of the connection. Run
+		 * any requests no worker has picked up yet here instead of
+		 * waiting on the workers which may all be busy.
+		 */
+		while (!pipeline->closing &&
+		       (job = list_find_first(pipeline->jobs, _find_job_unstarted,
+					      NULL))) {
+			job->started = true;
+			pipeline->running++;
+			slurm_mutex_unlock(&pipeline->mutex);
+
+			_run_job(job, &job->context);
+
+			slurm_mutex_lock(&pipeline->mutex);
+			job->done = true;
+			pipeline->running--;
+		}
+
+		/* handlers may still be using the connection */
+		while (pipeline->running)
+			slurm_cond_wait(&pipeline->cond, &pipeline->mutex);
+
+		/*
+		 * Send responses not yet sent by _pipeline_flush() in order.
+		 * Jobs are left in list as queued work may still reference
+		 * them.
+		 */
+		itr = list_iterator_create(pipeline->jobs);
+		while (!pipeline->closing && (job = list_next(itr))) {
+			/* only skipped when conmgr is shutting down */
+			if (!job->done)
+				break;
+
+			(void) conmgr_queue_write_data(
+				con, get_buf_data(job->context.out),
+				get_buf_offset(job->context.out));
+
+			if (job->context.close)
+				break;
+		}
+		list_iterator_destroy(itr);
+
+		pipeline->closing = true;
+
+		/* queued jobs will release their references */
+		list_flush(pipeline->parsed);
+		_pipeline_release(pipeline);
+		context->pipeline = NULL;
+	}
+
 	xfree(context->parser);
 	_free_request_t(context->request);
 	/* auth should have been released long before now */
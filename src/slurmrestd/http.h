@@ -41,6 +41,7 @@
 
 #include "src/common/http.h"
 #include "src/common/list.h"
+#include "src/common/pack.h"
 
 #include "src/conmgr/conmgr.h"
 
@@ -50,6 +51,8 @@ typedef struct on_http_request_args_s on_http_request_args_t;
 /*
  * Call back for each HTTP requested method.
  * This may be called several times in the same connection.
+ * Pipelined requests may be called concurrently from different threads, each
+ * with a private context whose response is sent in order of the requests.
  * must call send_http_response().
  *
  * IN args see on_http_request_args_t
@@ -69,6 +72,14 @@ typedef struct {
 	void *parser;
 	/* http request_t */
 	void *request;
+	/* active chunked response stream_t or NULL */
+	void *stream;
+	/* pipelined requests pipeline_t or NULL */
+	void *pipeline;
+	/* buffer for response of pipelined request or NULL to write directly */
+	buf_t *out;
+	/* close connection once response in out is sent */
+	bool close;
 } http_context_t;
 
 typedef struct on_http_request_args_s {
@@ -118,6 +129,7 @@ extern int parse_http(conmgr_fd_t *con, void *context);
 
 typedef struct {
 	conmgr_fd_t *con; /* assigned connection */
+	http_context_t *context; /* context of request or NULL */
 	uint16_t http_major; /* HTTP major version */
 	uint16_t http_minor; /* HTTP minor version */
 	http_status_code_t status_code; /* HTTP status code to send */
@@ -135,6 +147,12 @@ typedef struct {
  */
 extern int send_http_connection_close(http_context_t *ctxt);
 
+/*
+ * Close connection once response has been sent to client
+ * IN ctxt - connection context from on_http_request_args_t
+ */
+extern void close_http_connection(http_context_t *ctxt);
+
 /*
  * Send HTTP response
  * IN args arguments of response
@@ -142,6 +160,35 @@ extern int send_http_connection_close(http_context_t *ctxt);
  */
 extern int send_http_response(const send_http_response_args_t *args);
 
+/*
+ * Produce next part of a streamed HTTP response body
+ * IN arg - arg handed to send_http_response_stream()
+ * IN/OUT chunk_ptr - set with xmalloc()ed chunk to send (will be xfree()ed)
+ * IN/OUT bytes_ptr - set with number of bytes in chunk or 0 when body is done
+ * RET SLURM_SUCCESS or error to abort the connection
+ */
+typedef int (*http_stream_func_t)(void *arg, char **chunk_ptr,
+				  size_t *bytes_ptr);
+
+/*
+ * Send HTTP response with body streamed using chunked transfer encoding.
+ *	func is called for the next chunk only after the connection has
+ *	written out the prior chunk. Further requests on the connection will
+ *	not be processed until the stream is complete.
+ *	Falls back to send_http_response() with the full body collected from
+ *	func when the client can not accept chunked responses.
+ * IN context - connection context from on_http_request_args_t
+ * IN args - arguments of response (body and body_length are ignored)
+ * IN func - callback to produce each chunk of body
+ * IN free_func - callback to release arg once stream is complete (or NULL)
+ * IN arg - arbitrary pointer handed to func and free_func
+ * RET SLURM_SUCCESS or error
+ */
+extern int send_http_response_stream(http_context_t *context,
+				     const send_http_response_args_t *args,
+				     http_stream_func_t func,
+				     void (*free_func)(void *arg), void *arg);
+
 /*
  * setup http context against a given new socket
  * IN fd file descriptor of socket (must be connected!)
@@ -97,12 +97,33 @@ typedef struct {
 	int tag;
 } path_t;
 
+/* Maximum number of entries in a bound path */
+#define ROUTE_MAX_DEPTH 64
+
+/*
+ * Node in trie of bound paths. Each node matches a single path entry of the
+ * requested URL and all paths with the same leading entries share nodes.
+ */
+#define MAGIC_ROUTE 0x0a0b1a2e
+typedef struct route_s route_t;
+struct route_s {
+	int magic; /* MAGIC_ROUTE */
+	char *entry; /* string to match or NULL for parameter */
+	route_t **children; /* string match children */
+	int children_count;
+	route_t *param; /* parameter match child */
+	path_t **paths; /* paths ending at this node in tag order */
+	int paths_count;
+};
+
 typedef struct {
-	const data_t *dpath;
-	path_t *path;
+	const data_t *components[ROUTE_MAX_DEPTH]; /* requested path entries */
+	int count; /* number of entries in components */
 	data_t *params;
 	http_request_method_t method;
 	entry_t *entry;
+	entry_method_t *matched; /* method of best match */
+	bool stale; /* params populated from failed match */
 	int tag;
 } match_path_from_data_t;
 
@@ -142,6 +163,8 @@ typedef struct {
 } openapi_spec_t;
 
 static list_t *paths = NULL;
+static route_t *routes = NULL; /* root of trie of all paths */
+static int routes_depth = 0; /* max number of entries of any path */
 static int path_tag_counter = 0;
 static plugins_t *plugins = NULL;
 static data_parser_t **parsers = NULL; /* symlink to parser array */
@@ -577,6 +600,93 @@ static bool _data_parser_supports_method(data_parser_t *parser,
 	return true;
 }
 
+static route_t *_route_new(const char *entry)
+{
+	route_t *route = xmalloc(sizeof(*route));
+
+	route->magic = MAGIC_ROUTE;
+	route->entry = xstrdup(entry);
+
+	return route;
+}
+
+static void _route_free(route_t *route)
+{
+	if (!route)
+		return;
+
+	xassert(route->magic == MAGIC_ROUTE);
+
+	for (int i = 0; i < route->children_count; i++)
+		_route_free(route->children[i]);
+
+	_route_free(route->param);
+	xfree(route->children);
+	xfree(route->paths);
+	xfree(route->entry);
+	route->magic = ~MAGIC_ROUTE;
+	xfree(route);
+}
+
+static route_t *_route_find_child(const route_t *route, const char *entry)
+{
+	xassert(route->magic == MAGIC_ROUTE);
+
+	for (int i = 0; i < route->children_count; i++)
+		if (!xstrcmp(route->children[i]->entry, entry))
+			return route->children[i];
+
+	return NULL;
+}
+
+/* Add path to the trie of routes to avoid walking every path per request */
+static void _route_add(path_t *path)
+{
+	route_t *route;
+	int depth = 0;
+
+	xassert(path->magic == MAGIC_PATH);
+
+	if (!routes)
+		routes = _route_new(NULL);
+
+	route = routes;
+
+	/* entries of every method are identical except for parameter types */
+	for (entry_t *e = path->methods[0].entries; e->type; e++) {
+		route_t *child;
+
+		if (++depth > ROUTE_MAX_DEPTH)
+			fatal_abort("%s: path %s has more than %d entries",
+				    __func__, path->path, ROUTE_MAX_DEPTH);
+
+		if (e->type == OPENAPI_PATH_ENTRY_MATCH_PARAMETER) {
+			if (!route->param)
+				route->param = _route_new(NULL);
+
+			route = route->param;
+			continue;
+		}
+
+		if (!(child = _route_find_child(route, e->entry))) {
+			child = _route_new(e->entry);
+
+			xrecalloc(route->children, (route->children_count + 1),
+				  sizeof(*route->children));
+			route->children[route->children_count++] = child;
+		}
+
+		route = child;
+	}
+
+	routes_depth = MAX(routes_depth, depth);
+
+	/* tags always increase so paths stay sorted by tag */
+	xrecalloc(route->paths, (route->paths_count + 1),
+		  sizeof(*route->paths));
+	route->paths[route->paths_count++] = path;
+}
+
 extern int register_path_binding(const char *in_path,
 				 const openapi_path_binding_t *op_path,
 				 const openapi_resp_meta_t *meta,
@@ -669,6 +779,7 @@ extern int register_path_binding(const char *in_path,
 	}
 
 	list_append(paths, p);
+	_route_add(p);
 	*tag_ptr = tag;
 	return SLURM_SUCCESS;
 }
@@ -740,39 +851,6 @@ static bool _match_param(const data_t *data, match_path_from_data_t *args)
 	return matched;
 }
 
-static data_for_each_cmd_t _match_path(const data_t *data, void *y)
-{
-	match_path_from_data_t *args = y;
-	entry_t *entry = args->entry;
-
-	if (!entry->type)
-		return DATA_FOR_EACH_FAIL;
-
-	if (entry->type == OPENAPI_PATH_ENTRY_MATCH_STRING) {
-		bool match;
-
-		if (data_get_type(data) != DATA_TYPE_STRING)
-			return DATA_FOR_EACH_FAIL;
-
-		match = !xstrcmp(data_get_string(data), entry->entry);
-
-		debug5("%s: string attempt match %s to %s: %s",
-		       __func__, entry->entry, data_get_string(data),
-		       (match ? "SUCCESS" : "FAILURE"));
-
-		if (!match)
-			return DATA_FOR_EACH_FAIL;
-	} else if (entry->type == OPENAPI_PATH_ENTRY_MATCH_PARAMETER) {
-		if (!_match_param(data, args))
-			return DATA_FOR_EACH_FAIL;
-	} else
-		fatal_abort("%s: unknown OAS path entry match type",
-			    __func__);
-
-	args->entry++;
-	return DATA_FOR_EACH_CONT;
-}
-
 static char *_entry_to_string(entry_t *entry)
 {
 	char *path = NULL;
@@ -800,83 +878,92 @@ static char *_entry_to_string(entry_t *entry)
 	return path;
 }
 
-static int _match_path_from_data(void *x, void *key)
+/* Check and populate every parameter of method against requested path */
+static bool _match_params(match_path_from_data_t *args,
+			  entry_method_t *method)
 {
-	char *dst_path = NULL, *src_path = NULL;
-	match_path_from_data_t *args = key;
-	path_t *path = x;
-	entry_method_t *method;
-	bool matched = false;
+	const data_t **component = args->components;
 
-	xassert(path->magic == MAGIC_PATH);
+	data_set_dict(args->params);
 
-	if (get_log_level() >= LOG_LEVEL_DEBUG5) {
-		serialize_g_data_to_string(&dst_path, NULL, args->dpath,
-					   MIME_TYPE_JSON, SER_FLAGS_COMPACT);
+	for (args->entry = method->entries; args->entry->type;
+	     args->entry++, component++) {
+		if ((args->entry->type == OPENAPI_PATH_ENTRY_MATCH_PARAMETER) &&
+		    !_match_param(*component, args))
+			return false;
 	}
 
-	args->path = path;
-	for (method = path->methods; method->entries; method++) {
-		int entries = 0;
+	return true;
+}
 
-		if (get_log_level() >= LOG_LEVEL_DEBUG5) {
-			xfree(src_path);
-			src_path = _entry_to_string(method->entries);
-		}
+static void _route_match_paths(const route_t *route,
+			       match_path_from_data_t *args)
+{
+	for (int i = 0; i < route->paths_count; i++) {
+		path_t *path = route->paths[i];
 
-		if (args->method != method->method) {
-			debug5("%s: method skip for %s(%d, %s != %s) to %s(0x%"PRIXPTR")",
-			       __func__, src_path, args->path->tag,
-			       get_http_method_string(args->method),
-			       get_http_method_string(method->method),
-			       dst_path, (uintptr_t) args->dpath);
-			continue;
-		}
+		xassert(path->magic == MAGIC_PATH);
 
-		for (args->entry = method->entries; args->entry->type;
-		     entries++, args->entry++)
-			/* do nothing */;
+		/* first bound path always wins to match registration order */
+		if ((args->tag != -1) && (path->tag > args->tag))
+			return;
 
-		if (data_get_list_length(args->dpath) != entries) {
-			debug5("%s: skip non-matching subdirectories: registered=%u requested=%zu ",
-			       __func__, entries,
-			       data_get_list_length(args->dpath));
-			continue;
-		}
+		for (entry_method_t *em = path->methods; em->entries; em++) {
+			if (em->method != args->method)
+				continue;
 
-		args->entry = method->entries;
-		if (data_list_for_each_const(args->dpath, _match_path,
-					     args) < 0) {
-			debug5("%s: match failed %s",
-			       __func__, args->entry->entry);
-			continue;
-		}
+			if (_match_params(args, em)) {
+				debug5("%s: matched path tag %d: %s %s",
+				       __func__, path->tag,
+				       get_http_method_string(em->method),
+				       path->path);
 
-		/*
-		 * The list is NULL terminated, so if entry->type is not NULL
-		 * we didn't match the whole list, but we already don't have
-		 * anything to compare in request.
-		 */
-		if (!args->entry->type) {
-			args->tag = path->tag;
-			matched = true;
-			break;
+				args->tag = path->tag;
+				args->matched = em;
+				args->stale = false;
+				return;
+			}
+
+			args->stale = true;
 		}
 	}
+}
+
+static void _route_match(const route_t *route, int depth,
+			 match_path_from_data_t *args)
+{
+	const data_t *component;
+
+	xassert(route->magic == MAGIC_ROUTE);
+
+	if (depth == args->count) {
+		_route_match_paths(route, args);
+		return;
+	}
 
-	debug5("%s: match %s for %s(%d, %s) to %s(0x%"PRIXPTR")",
-	       __func__,
-	       matched ? "successful" : "failed",
-	       src_path,
-	       args->path->tag,
-	       get_http_method_string(args->method),
-	       dst_path,
-	       (uintptr_t) args->dpath);
+	component = args->components[depth];
 
-	xfree(src_path);
-	xfree(dst_path);
+	if (data_get_type(component) == DATA_TYPE_STRING) {
+		const route_t *child =
+			_route_find_child(route, data_get_string(component));
 
-	return matched;
+		if (child)
+			_route_match(child, (depth + 1), args);
+	}
+
+	/* parameter may still match a path registered before string match */
+	if (route->param)
+		_route_match(route->param, (depth + 1), args);
+}
+
+static data_for_each_cmd_t _foreach_route_component(const data_t *data,
+						    void *arg)
+{
+	match_path_from_data_t *args = arg;
+
+	args->components[args->count++] = data;
+
+	return DATA_FOR_EACH_CONT;
 }
 
 extern int find_path_tag(const data_t *dpath, data_t *params,
@@ -884,14 +971,28 @@ extern int find_path_tag(const data_t *dpath, data_t *params,
 {
 	match_path_from_data_t args = {
 		.params = params,
-		.dpath = dpath,
 		.method = method,
 		.tag = -1,
 	};
 
 	xassert(data_get_type(params) == DATA_TYPE_DICT);
 
-	(void) list_find_first(paths, _match_path_from_data, &args);
+	if (!routes || (data_get_list_length(dpath) > routes_depth))
+		return -1;
+
+	(void) data_list_for_each_const(dpath, _foreach_route_component,
+					&args);
+
+	_route_match(routes, 0, &args);
+
+	/* repopulate params if a later candidate failed to match */
+	if (args.stale) {
+		if (args.tag == -1)
+			data_set_dict(params);
+		else if (!_match_params(&args, args.matched))
+			fatal_abort("%s: unable to repopulate parameters",
+				    __func__);
+	}
 
 	return args.tag;
 }
@@ -989,6 +1090,9 @@ extern void destroy_openapi(void)
 
 	FREE_NULL_PLUGINS(plugins);
 	FREE_NULL_LIST(paths);
+	_route_free(routes);
+	routes = NULL;
+	routes_depth = 0;
 }
 
 static data_for_each_cmd_t _merge_operationId_strings(data_t *data, void *arg)
@@ -42,6 +42,7 @@
 #include "src/common/list.h"
 #include "src/common/log.h"
 #include "src/common/xassert.h"
+#include "src/common/xhash.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 #include "src/interfaces/serializer.h"
@@ -50,10 +51,54 @@
 #include "src/slurmrestd/rest_auth.h"
 
 static pthread_rwlock_t paths_lock = PTHREAD_RWLOCK_INITIALIZER;
-static list_t *paths = NULL;
 static data_parser_t **parsers; /* symlink to parser array */
 serializer_flags_t yaml_flags = SER_FLAGS_PRETTY;
 serializer_flags_t json_flags = SER_FLAGS_PRETTY;
+int response_cache_ttl = 0;
+
+/* Max number of GET responses to cache */
+#define RESP_CACHE_MAX 1024
+/* Max bytes of a single response body to cache */
+#define RESP_CACHE_MAX_BODY_BYTES (64 * 1024 * 1024)
+/* Max bytes of response bodies held by the cache */
+#define RESP_CACHE_MAX_BYTES (256 * 1024 * 1024)
+
+#define MAGIC_RESP_BODY 0xDF9EAB2E
+typedef struct {
+	int magic; /* MAGIC_RESP_BODY */
+	int refs; /* protected by resp_cache_lock */
+	char *data;
+	size_t length;
+	char *etag; /* or NULL */
+} resp_body_t;
+
+#define MAGIC_RESP_CACHE 0xDF9EAA0C
+typedef struct {
+	int magic; /* MAGIC_RESP_CACHE */
+	char *key; /* identity, mime type and URL of request */
+	resp_body_t *body;
+	const char *write_mime;
+	time_t expires;
+} resp_cache_t;
+
+static pthread_mutex_t resp_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static xhash_t *resp_cache = NULL;
+static size_t resp_cache_bytes = 0; /* bytes of bodies held by cache */
+static uint64_t resp_cache_hits = 0;
+static uint64_t resp_cache_misses = 0;
+static uint64_t resp_not_modified = 0;
+
+/* Stream response bodies at least this large using chunked encoding */
+#define STREAM_BODY_BYTES (1024 * 1024)
+/* Bytes of body to send per chunk when streaming */
+#define STREAM_CHUNK_BYTES (256 * 1024)
+
+#define MAGIC_BODY_STREAM 0xDF9EAB1D
+typedef struct {
+	int magic; /* MAGIC_BODY_STREAM */
+	resp_body_t *body;
+	size_t offset;
+} body_stream_t;
 
 #define MAGIC_HEADER_ACCEPT 0xDF9EAABE
 
@@ -72,6 +117,9 @@ typedef struct {
 	data_parser_t *parser;
 } path_t;
 
+static path_t **paths = NULL; /* array of paths indexed by tag */
+static int paths_count = 0;
+
 typedef struct {
 	int magic; /* MAGIC_HEADER_ACCEPT */
 	char *type; /* mime type and sub type unchanged */
@@ -103,18 +151,381 @@ static void _free_path(void *x)
 	xfree(path);
 }
 
+/* Wrap response body and etag, taking ownership of both */
+static resp_body_t *_resp_body_new(char *data, char *etag)
+{
+	resp_body_t *body = xmalloc(sizeof(*body));
+
+	body->magic = MAGIC_RESP_BODY;
+	body->refs = 1;
+	body->data = data;
+	body->length = strlen(data);
+	body->etag = etag;
+
+	return body;
+}
+
+static void _resp_body_ref(resp_body_t *body)
+{
+	xassert(body->magic == MAGIC_RESP_BODY);
+
+	slurm_mutex_lock(&resp_cache_lock);
+	xassert(body->refs > 0);
+	body->refs++;
+	slurm_mutex_unlock(&resp_cache_lock);
+}
+
+/* Release reference to body. Caller must hold resp_cache_lock. */
+static void _resp_body_unref_locked(resp_body_t *body)
+{
+	xassert(body->magic == MAGIC_RESP_BODY);
+	xassert(body->refs > 0);
+
+	if (--body->refs)
+		return;
+
+	xfree(body->data);
+	xfree(body->etag);
+	body->magic = ~MAGIC_RESP_BODY;
+	xfree(body);
+}
+
+static void _resp_body_unref(resp_body_t *body)
+{
+	if (!body)
+		return;
+
+	slurm_mutex_lock(&resp_cache_lock);
+	_resp_body_unref_locked(body);
+	slurm_mutex_unlock(&resp_cache_lock);
+}
+
+static void _resp_cache_id(void *item, const char **key, uint32_t *key_len)
+{
+	resp_cache_t *entry = item;
+
+	xassert(entry->magic == MAGIC_RESP_CACHE);
+
+	*key = entry->key;
+	*key_len = strlen(entry->key);
+}
+
+static void _resp_cache_free(void *x)
+{
+	resp_cache_t *entry = x;
+
+	if (!entry)
+		return;
+
+	xassert(entry->magic == MAGIC_RESP_CACHE);
+
+	/* xhash is only modified with resp_cache_lock held */
+	resp_cache_bytes -= entry->body->length;
+	_resp_body_unref_locked(entry->body);
+	xfree(entry->key);
+	entry->magic = ~MAGIC_RESP_CACHE;
+	xfree(entry);
+}
+
+static void _resp_cache_expire(void *item, void *arg)
+{
+	resp_cache_t *entry = item;
+	list_t *expired = arg;
+
+	xassert(entry->magic == MAGIC_RESP_CACHE);
+
+	if (entry->expires <= time(NULL))
+		list_append(expired, entry->key);
+}
+
+/* Remove all expired responses. Caller must hold resp_cache_lock. */
+static void _resp_cache_purge(void)
+{
+	list_t *expired = list_create(NULL);
+	char *key;
+
+	xhash_walk(resp_cache, _resp_cache_expire, expired);
+
+	while ((key = list_pop(expired)))
+		xhash_delete_str(resp_cache, key);
+
+	FREE_NULL_LIST(expired);
+}
+
+/* Generate strong entity tag from response body (RFC#7232 Section:2.3) */
+static char *_make_etag(const char *body)
+{
+	/* 64-bit FNV-1a */
+	uint64_t hash = 0xcbf29ce484222325;
+
+	for (const char *p = body; *p; p++) {
+		hash ^= (unsigned char) *p;
+		hash *= 0x100000001b3;
+	}
+
+	return xstrdup_printf("\"%016"PRIx64"\"", hash);
+}
+
+/* Check if client already has response with etag (RFC#7232 Section:3.2) */
+static bool _match_etag(on_http_request_args_t *args, const char *etag)
+{
+	const char *match = find_http_header(args->headers, "If-None-Match");
+	size_t len;
+
+	if (!match || !etag)
+		return false;
+
+	len = strlen(etag);
+
+	if (!xstrcmp(match, "*"))
+		return true;
+
+	/*
+	 * Walk list of entity tags. If-None-Match uses the weak comparison
+	 * so a W/ prefix is ignored.
+	 */
+	while (*match) {
+		const char *end;
+
+		if ((*match == ' ') || (*match == '\t') || (*match == ',')) {
+			match++;
+			continue;
+		}
+
+		if (!strncmp(match, "W/", 2))
+			match += 2;
+
+		if ((*match != '"') || !(end = xstrchr((match + 1), '"')))
+			return false; /* malformed list */
+
+		end++;
+		if (*end && (*end != ' ') && (*end != '\t') && (*end != ','))
+			return false; /* malformed list */
+
+		if (((end - match) == len) && !strncmp(match, etag, len))
+			return true;
+
+		match = end;
+	}
+
+	return false;
+}
+
+/*
+ * Generate key for response cache or NULL if request can not be cached.
+ * Must be called before the auth context is released.
+ */
+static char *_resp_cache_key(on_http_request_args_t *args,
+			     const char *write_mime, data_parser_t *parser)
+{
+	rest_auth_context_t *auth = args->context->auth;
+
+	if ((response_cache_ttl <= 0) ||
+	    (args->method != HTTP_REQUEST_GET) || args->body_length ||
+	    !auth || !auth->identity)
+		return NULL;
+
+	/* responses are only shared with requests from same identity */
+	return xstrdup_printf("%s\n%s\n%s\n%s?%s", auth->identity, write_mime,
+			      (parser ? data_parser_get_plugin(parser) : ""),
+			      args->path, (args->query ? args->query : ""));
+}
+
+/* Cache body for key, the cache keeps its own reference to body */
+static void _resp_cache_add(char *key, resp_body_t *body,
+			    const char *write_mime)
+{
+	resp_cache_t *entry;
+
+	xassert(body->magic == MAGIC_RESP_BODY);
+
+	if (body->length > RESP_CACHE_MAX_BODY_BYTES) {
+		debug3("%s: response of %zu bytes too large to cache",
+		       __func__, body->length);
+		return;
+	}
+
+	slurm_mutex_lock(&resp_cache_lock);
+
+	if (!resp_cache) {
+		slurm_mutex_unlock(&resp_cache_lock);
+		return;
+	}
+
+	/* replace any expired response */
+	xhash_delete_str(resp_cache, key);
+
+	if ((xhash_count(resp_cache) >= RESP_CACHE_MAX) ||
+	    ((resp_cache_bytes + body->length) > RESP_CACHE_MAX_BYTES))
+		_resp_cache_purge();
+
+	if ((xhash_count(resp_cache) >= RESP_CACHE_MAX) ||
+	    ((resp_cache_bytes + body->length) > RESP_CACHE_MAX_BYTES)) {
+		slurm_mutex_unlock(&resp_cache_lock);
+		debug3("%s: response cache full", __func__);
+		return;
+	}
+
+	entry = xmalloc(sizeof(*entry));
+	entry->magic = MAGIC_RESP_CACHE;
+	entry->key = xstrdup(key);
+	entry->body = body;
+	entry->write_mime = write_mime;
+	entry->expires = time(NULL) + response_cache_ttl;
+
+	body->refs++;
+	resp_cache_bytes += body->length;
+
+	xhash_add(resp_cache, entry);
+
+	slurm_mutex_unlock(&resp_cache_lock);
+}
+
+/*
+ * Get reference to cached response body for key if still valid
+ * RET true if response found
+ */
+static bool _resp_cache_get(const char *key, resp_body_t **body_ptr,
+			    const char **write_mime_ptr)
+{
+	resp_cache_t *entry;
+	bool found = false;
+
+	slurm_mutex_lock(&resp_cache_lock);
+
+	if (resp_cache && (entry = xhash_get_str(resp_cache, key))) {
+		xassert(entry->magic == MAGIC_RESP_CACHE);
+
+		if (entry->expires > time(NULL)) {
+			entry->body->refs++;
+			*body_ptr = entry->body;
+			*write_mime_ptr = entry->write_mime;
+			found = true;
+		} else {
+			xhash_delete_str(resp_cache, key);
+		}
+	}
+
+	if (found)
+		resp_cache_hits++;
+	else
+		resp_cache_misses++;
+
+	slurm_mutex_unlock(&resp_cache_lock);
+
+	return found;
+}
+
+static int _stream_body(void *arg, char **chunk_ptr, size_t *bytes_ptr)
+{
+	body_stream_t *stream = arg;
+	size_t bytes = MIN(STREAM_CHUNK_BYTES,
+			   (stream->body->length - stream->offset));
+
+	xassert(stream->magic == MAGIC_BODY_STREAM);
+
+	if (bytes) {
+		*chunk_ptr = xmalloc_nz(bytes);
+		memcpy(*chunk_ptr, (stream->body->data + stream->offset),
+		       bytes);
+		stream->offset += bytes;
+	}
+
+	*bytes_ptr = bytes;
+	return SLURM_SUCCESS;
+}
+
+static void _free_body_stream(void *arg)
+{
+	body_stream_t *stream = arg;
+
+	xassert(stream->magic == MAGIC_BODY_STREAM);
+	stream->magic = ~MAGIC_BODY_STREAM;
+	_resp_body_unref(stream->body);
+	xfree(stream);
+}
+
+/*
+ * Send body (or NULL) with its etag or only confirm client copy is current.
+ * Large bodies are streamed to client holding a reference to body.
+ */
+static int _send_body(on_http_request_args_t *args, resp_body_t *body,
+		      const char *write_mime, http_status_code_t *status_ptr)
+{
+	int rc;
+	const char *etag = (body ? body->etag : NULL);
+	http_header_entry_t etag_header = {
+		.name = "ETag",
+		.value = (char *) etag,
+	};
+	send_http_response_args_t send_args = {
+		.con = args->context->con,
+		.context = args->context,
+		.http_major = args->http_major,
+		.http_minor = args->http_minor,
+		.status_code = HTTP_STATUS_CODE_SUCCESS_OK,
+		.body = NULL,
+		.body_length = 0,
+	};
+
+	if (etag) {
+		send_args.headers = list_create(NULL);
+		list_append(send_args.headers, &etag_header);
+	}
+
+	if (_match_etag(args, etag)) {
+		/* RFC#7232 Section:4.1 - client copy is still valid */
+		send_args.status_code = HTTP_STATUS_CODE_REDIRECT_NOT_MODIFIED;
+
+		slurm_mutex_lock(&resp_cache_lock);
+		resp_not_modified++;
+		slurm_mutex_unlock(&resp_cache_lock);
+	} else if (body) {
+		send_args.body = body->data;
+		send_args.body_length = body->length;
+		send_args.body_encoding = write_mime;
+	}
+
+	if (send_args.body_length >= STREAM_BODY_BYTES) {
+		/*
+		 * Avoid queuing a second full copy of a large body on the
+		 * connection and only copy each chunk as it is written.
+		 */
+		body_stream_t *stream = xmalloc(sizeof(*stream));
+
+		stream->magic = MAGIC_BODY_STREAM;
+		stream->body = body;
+		_resp_body_ref(body);
+
+		rc = send_http_response_stream(args->context, &send_args,
+					       _stream_body, _free_body_stream,
+					       stream);
+	} else {
+		rc = send_http_response(&send_args);
+	}
+
+	*status_ptr = send_args.status_code;
+
+	FREE_NULL_LIST(send_args.headers);
+	return rc;
+}
+
 extern int init_operations(data_parser_t **init_parsers)
 {
 	slurm_rwlock_wrlock(&paths_lock);
 
-	if (paths)
+	if (parsers)
 		fatal_abort("%s called twice", __func__);
 
-	paths = list_create(_free_path);
 	parsers = init_parsers;
 
 	slurm_rwlock_unlock(&paths_lock);
 
+	slurm_mutex_lock(&resp_cache_lock);
+	if (response_cache_ttl > 0)
+		resp_cache = xhash_init(_resp_cache_id, _resp_cache_free);
+	slurm_mutex_unlock(&resp_cache_lock);
+
 	return SLURM_SUCCESS;
 }
 
@@ -122,23 +533,21 @@ extern void destroy_operations(void)
 {
 	slurm_rwlock_wrlock(&paths_lock);
 
-	FREE_NULL_LIST(paths);
+	for (int i = 0; i < paths_count; i++)
+		_free_path(paths[i]);
+	xfree(paths);
+	paths_count = 0;
 	parsers = NULL;
 
 	slurm_rwlock_unlock(&paths_lock);
-}
-
-static int _match_path_key(void *x, void *ptr)
-{
-	path_t *path = (path_t *)x;
-	int tag = *(int *) ptr;
 
-	_check_path_magic(path);
-
-	if (path->tag == tag)
-		return 1;
-	else
-		return 0;
+	slurm_mutex_lock(&resp_cache_lock);
+	if (resp_cache)
+		debug("%s: response cache hits:%"PRIu64" misses:%"PRIu64" not_modified:%"PRIu64,
+		      __func__, resp_cache_hits, resp_cache_misses,
+		      resp_not_modified);
+	xhash_free(resp_cache);
+	slurm_mutex_unlock(&resp_cache_lock);
 }
 
 static int _add_binded_path(const char *path_str,
@@ -159,9 +568,6 @@ static int _add_binded_path(const char *path_str,
 	if (rc)
 		return rc;
 
-	/* path should never be a duplicate */
-	xassert(!list_find_first(paths, _match_path_key, &tag));
-
 	/* add new path */
 	debug4("%s: new bound path %s with path_tag %d",
 	       __func__, (path_str ? path_str : op_path->path), tag);
@@ -174,7 +580,19 @@ static int _add_binded_path(const char *path_str,
 	path->op_path = op_path;
 	path->meta = meta;
 
-	list_append(paths, path);
+	slurm_rwlock_wrlock(&paths_lock);
+
+	/* tags are handed out sequentially so index paths directly by tag */
+	if (tag >= paths_count) {
+		xrecalloc(paths, (tag + 1), sizeof(*paths));
+		paths_count = tag + 1;
+	}
+
+	/* path should never be a duplicate */
+	xassert(!paths[tag]);
+	paths[tag] = path;
+
+	slurm_rwlock_unlock(&paths_lock);
 
 	return SLURM_SUCCESS;
 }
@@ -234,6 +652,7 @@ static int _operations_router_reject(const on_http_request_args_t *args,
 {
 	send_http_response_args_t send_args = {
 		.con = args->context->con,
+		.context = args->context,
 		.headers = list_create(NULL),
 		.http_major = args->http_major,
 		.http_minor = args->http_minor,
@@ -253,7 +672,7 @@ static int _operations_router_reject(const on_http_request_args_t *args,
 	(void) send_http_response(&send_args);
 
 	/* close connection on error */
-	conmgr_queue_close_fd(args->context->con);
+	close_http_connection(args->context);
 
 	FREE_NULL_LIST(send_args.headers);
 
@@ -500,7 +919,8 @@ static int _call_handler(on_http_request_args_t *args, data_t *params,
 {
 	int rc;
 	data_t *resp = data_new();
-	char *body = NULL;
+	char *body = NULL, *etag = NULL;
+	char *cache_key = _resp_cache_key(args, write_mime, parser);
 	http_status_code_t e;
 
 	xassert(op_path);
@@ -544,6 +964,7 @@ static int _call_handler(on_http_request_args_t *args, data_t *params,
 		 */
 		send_http_response_args_t send_args = {
 			.con = args->context->con,
+			.context = args->context,
 			.http_major = args->http_major,
 			.http_minor = args->http_minor,
 			.status_code = HTTP_STATUS_CODE_REDIRECT_NOT_MODIFIED,
@@ -566,23 +987,24 @@ static int _call_handler(on_http_request_args_t *args, data_t *params,
 
 		rc = _operations_router_reject(args, body, e, write_mime);
 	} else {
-		send_http_response_args_t send_args = {
-			.con = args->context->con,
-			.http_major = args->http_major,
-			.http_minor = args->http_minor,
-			.status_code = HTTP_STATUS_CODE_SUCCESS_OK,
-			.body = NULL,
-			.body_length = 0,
-		};
+		resp_body_t *resp_body = NULL;
 
 		if (body) {
-			send_args.body = body;
-			send_args.body_length = strlen(body);
-			send_args.body_encoding = write_mime;
+			if (args->method == HTTP_REQUEST_GET)
+				etag = _make_etag(body);
+
+			/* shared with the cache instead of copied */
+			resp_body = _resp_body_new(body, etag);
+			body = NULL;
+			etag = NULL;
+
+			if (cache_key && !rc && resp_body->etag)
+				_resp_cache_add(cache_key, resp_body,
+						write_mime);
 		}
 
-		rc = send_http_response(&send_args);
-		e = send_args.status_code;
+		rc = _send_body(args, resp_body, write_mime, &e);
+		_resp_body_unref(resp_body);
 	}
 
 	debug3("%s: [%s] END: calling handler: (0x%"PRIXPTR") callback_tag %d for path: %s rc[%d]=%s status[%d]=%s",
@@ -591,17 +1013,50 @@ static int _call_handler(on_http_request_args_t *args, data_t *params,
 	       get_http_status_code_string(e));
 
 	xfree(body);
+	xfree(etag);
+	xfree(cache_key);
 	FREE_NULL_DATA(resp);
 
 	return rc;
 }
 
+/*
+ * Send cached response if available
+ * RET true if response was sent
+ */
+static bool _send_cached(on_http_request_args_t *args, const char *write_mime,
+			 data_parser_t *parser, int *rc_ptr)
+{
+	char *key = _resp_cache_key(args, write_mime, parser);
+	resp_body_t *body = NULL;
+	const char *cached_mime = NULL;
+	http_status_code_t e;
+
+	if (!key)
+		return false;
+
+	if (!_resp_cache_get(key, &body, &cached_mime)) {
+		xfree(key);
+		return false;
+	}
+
+	*rc_ptr = _send_body(args, body, cached_mime, &e);
+
+	debug3("%s: [%s] sent cached response for %s status[%d]=%s",
+	       __func__, _name(args), args->path, e,
+	       get_http_status_code_string(e));
+
+	xfree(key);
+	_resp_body_unref(body);
+	return true;
+}
+
 extern int operations_router(on_http_request_args_t *args)
 {
 	int rc = SLURM_SUCCESS;
 	data_t *query = NULL;
 	data_t *params = NULL;
-	int path_tag;
+	int path_tag = -1;
 	path_t *path = NULL;
 	int callback_tag;
 	const char *read_mime = NULL, *write_mime = NULL, *plugin = NULL;
@@ -630,7 +1085,8 @@ extern int operations_router(on_http_request_args_t *args)
 	 */
 	slurm_rwlock_rdlock(&paths_lock);
 
-	if (!(path = list_find_first(paths, _match_path_key, &path_tag)))
+	if ((path_tag < 0) || (path_tag >= paths_count) ||
+	    !(path = paths[path_tag]))
 		fatal_abort("%s: found tag but missing path handler", __func__);
 	_check_path_magic(path);
 
@@ -647,6 +1103,10 @@ extern int operations_router(on_http_request_args_t *args)
 	if ((rc = _resolve_mime(args, &read_mime, &write_mime, &plugin)))
 		goto cleanup;
 
+	/* avoid calling handler for unchanged response to same request */
+	if (_send_cached(args, write_mime, parser, &rc))
+		goto cleanup;
+
 	if ((rc = _get_query(args, &query, read_mime)))
 		goto cleanup;
 
@@ -42,6 +42,8 @@
 
 extern serializer_flags_t yaml_flags;
 extern serializer_flags_t json_flags;
+/* seconds to cache GET responses or 0 to disable */
+extern int response_cache_ttl;
 
 /*
  * setup locks.
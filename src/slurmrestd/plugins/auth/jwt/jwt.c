@@ -85,6 +85,7 @@ typedef struct {
 	int magic;
 	char *token;
 	void *db_conn;
+	time_t db_conn_created;
 } plugin_data_t;
 
 extern int slurm_rest_auth_p_authenticate(on_http_request_args_t *args,
@@ -136,6 +137,9 @@ extern int slurm_rest_auth_p_authenticate(on_http_request_args_t *args,
 		}
 	}
 
+	/* token is the only proof of identity */
+	ctxt->identity = xstrdup_printf("jwt:%s:%s", user_name, data->token);
+
 	if (user_name)
 		info("[%s] attempting user_name %s token authentication pass through",
 		     name, user_name);
@@ -167,7 +171,8 @@ extern void slurm_rest_auth_p_free(rest_auth_context_t *context)
 	data->magic = ~MAGIC;
 
 	if (data->db_conn)
-		slurmdb_connection_close(&data->db_conn);
+		rest_auth_db_conn_put(context->identity, &data->db_conn,
+				      data->db_conn_created);
 
 	xfree(data->token);
 	xfree(context->plugin_data);
@@ -185,17 +190,10 @@ extern void *slurm_rest_auth_p_get_db_conn(rest_auth_context_t *context)
 	if (data->db_conn)
 		return data->db_conn;
 
-	errno = 0;
-	data->db_conn = slurmdb_connection_get(NULL);
-
-	if (!errno && data->db_conn)
-		return data->db_conn;
-
-	error("%s: unable to connect to slurmdbd: %m",
-	      __func__);
-	data->db_conn = NULL;
+	data->db_conn = rest_auth_db_conn_get(context->identity,
+					      &data->db_conn_created);
 
-	return NULL;
+	return data->db_conn;
 }
 
 extern void slurm_rest_auth_p_init(bool become_user)
@@ -102,6 +102,7 @@ static bool become_user = false;
 typedef struct {
 	int magic;
 	void *db_conn;
+	time_t db_conn_created;
 } plugin_data_t;
 
 extern void *slurm_rest_auth_p_get_db_conn(rest_auth_context_t *context)
@@ -116,17 +117,10 @@ extern void *slurm_rest_auth_p_get_db_conn(rest_auth_context_t *context)
 	if (data->db_conn)
 		return data->db_conn;
 
-	errno = 0;
-	data->db_conn = slurmdb_connection_get(NULL);
+	data->db_conn = rest_auth_db_conn_get(context->identity,
+					      &data->db_conn_created);
 
-	if (!errno && data->db_conn)
-		return data->db_conn;
-
-	error("%s: unable to connect to slurmdbd: %m",
-	      __func__);
-	data->db_conn = NULL;
-
-	return NULL;
+	return data->db_conn;
 }
 
 static int _auth_socket(on_http_request_args_t *args,
@@ -234,6 +228,7 @@ static int _auth_socket(on_http_request_args_t *args,
 		plugin_data_t *data = xmalloc(sizeof(*data));
 		data->magic = MAGIC;
 		ctxt->plugin_data = data;
+		ctxt->identity = xstrdup_printf("local:%s", ctxt->user_name);
 		return SLURM_SUCCESS;
 	} else
 		return ESLURM_USER_ID_MISSING;
@@ -306,6 +301,8 @@ extern int slurm_rest_auth_p_authenticate(on_http_request_args_t *args,
 				plugin_data_t *data = xmalloc(sizeof(*data));
 				data->magic = MAGIC;
 				ctxt->plugin_data = data;
+				ctxt->identity = xstrdup_printf(
+					"local:%s", ctxt->user_name);
 
 				info("[%s] accepted connection from user: %s[%u]",
 				     name, ctxt->user_name, status.st_uid);
@@ -351,7 +348,8 @@ extern void slurm_rest_auth_p_free(rest_auth_context_t *context)
 	data->magic = ~MAGIC;
 
 	if (data->db_conn)
-		slurmdb_connection_close(&data->db_conn);
+		rest_auth_db_conn_put(context->identity, &data->db_conn,
+				      data->db_conn_created);
 
 	xfree(context->plugin_data);
 }
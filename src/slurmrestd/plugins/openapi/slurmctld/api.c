@@ -212,6 +212,27 @@ const openapi_path_binding_t openapi_paths[] = {
 		},
 		.flags = OP_FLAGS,
 	},
+	{
+		.path = "/slurm/{data_parser}/jobs/submit",
+		.callback = op_handler_submit_jobs,
+		.methods = (openapi_path_binding_method_t[]) {
+			{
+				.method = HTTP_REQUEST_POST,
+				.tags = tags,
+				.summary = "submit many independent batch jobs",
+				.response = {
+					.type = DATA_PARSER_OPENAPI_JOB_SUBMIT_BATCH_RESP,
+					.description = "job submission responses",
+				},
+				.body = {
+					.type = DATA_PARSER_JOB_SUBMIT_BATCH_REQ,
+					.description = "Job descriptions",
+				},
+			},
+			{0}
+		},
+		.flags = OP_FLAGS,
+	},
 	{
 		.path = "/slurm/{data_parser}/job/allocate",
 		.callback = op_handler_alloc_job,
@@ -516,6 +516,89 @@ extern int op_handler_submit_job(openapi_ctxt_t *ctxt)
 	return ctxt->rc;
 }
 
+static void _jobs_post_submit(ctxt_t *ctxt)
+{
+	openapi_job_submit_batch_request_t req = {0};
+	openapi_job_submit_batch_response_t oas_resp = {0};
+	list_itr_t *iter;
+	job_desc_msg_t *job;
+	submit_response_msg_t *resp;
+
+	if (!ctxt->query) {
+		resp_error(ctxt, ESLURM_REST_INVALID_QUERY, __func__,
+			   "unexpected empty query for jobs");
+		goto cleanup;
+	}
+
+	if (DATA_PARSE(ctxt->parser, JOB_SUBMIT_BATCH_REQ, req, ctxt->query,
+		       ctxt->parent_path))
+		goto cleanup;
+
+	if (!req.jobs || list_is_empty(req.jobs)) {
+		resp_error(ctxt, ESLURM_REST_INVALID_QUERY, __func__,
+			   "Populated \"jobs\" field is required for job submission");
+		goto cleanup;
+	}
+
+	iter = list_iterator_create(req.jobs);
+	while ((job = list_next(iter))) {
+		if ((!job->script || !job->script[0]) && req.script) {
+			xfree(job->script);
+			job->script = xstrdup(req.script);
+		}
+
+		if (!job->script || !job->script[0]) {
+			resp_error(ctxt, ESLURM_JOB_SCRIPT_MISSING, "script",
+				   "Batch job script empty or missing");
+			break;
+		}
+	}
+	list_iterator_destroy(iter);
+
+	if (ctxt->rc)
+		goto cleanup;
+
+	if (slurm_submit_batch_jobs(req.jobs, &oas_resp.results)) {
+		resp_error(ctxt, errno, "slurm_submit_batch_jobs()",
+			   "Batch job submission failed");
+		goto cleanup;
+	}
+
+	iter = list_iterator_create(oas_resp.results);
+	while ((resp = list_next(iter))) {
+		debug3("%s:[%s] job submitted -> job_id:%d step_id:%d rc:%d message:%s",
+		       __func__, ctxt->id, resp->job_id, resp->step_id,
+		       resp->error_code, resp->job_submit_user_msg);
+
+		if (resp->error_code)
+			resp_warn(ctxt, "slurm_submit_batch_jobs()",
+				  "Job submission resulted in non-zero return code: %s",
+				  slurm_strerror(resp->error_code));
+	}
+	list_iterator_destroy(iter);
+
+	DATA_DUMP(ctxt->parser, OPENAPI_JOB_SUBMIT_BATCH_RESP, oas_resp,
+		  ctxt->resp);
+
+cleanup:
+	FREE_NULL_LIST(oas_resp.results);
+	FREE_NULL_LIST(req.jobs);
+	xfree(req.script);
+}
+
+extern int op_handler_submit_jobs(openapi_ctxt_t *ctxt)
+{
+	if (ctxt->method == HTTP_REQUEST_POST) {
+		_jobs_post_submit(ctxt);
+	} else {
+		resp_error(ctxt, ESLURM_REST_INVALID_QUERY, __func__,
+			   "Unsupported HTTP method requested: %s",
+			   get_http_method_string(ctxt->method));
+	}
+
+	return ctxt->rc;
+}
+
 static void _job_alloc_rc(ctxt_t *ctxt,
 			  resource_allocation_response_msg_t *resp,
 			  const char *src)
@@ -35,9 +35,12 @@
 
 #include "config.h"
 
+#include <errno.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "slurm/slurm.h"
+#include "slurm/slurmdb.h"
 
 #include "src/common/list.h"
 #include "src/common/log.h"
@@ -81,6 +84,29 @@ static plugin_context_t **g_context = NULL;
 
 #define MAGIC 0xDEDEDEDE
 
+/* Max number of idle slurmdbd connections to keep for reuse */
+#define DB_CONN_POOL_MAX 32
+/* Seconds to keep an idle slurmdbd connection before closing it */
+#define DB_CONN_POOL_IDLE 30
+/*
+ * Max seconds to reuse a slurmdbd connection. Connections are only
+ * authenticated when opened, so this also limits how long a connection
+ * outlives the credential it was opened with.
+ */
+#define DB_CONN_POOL_MAX_AGE 300
+
+#define MAGIC_DB_CONN 0xDEDE0DB0
+typedef struct {
+	int magic; /* MAGIC_DB_CONN */
+	char *key; /* identity connection was authenticated as */
+	void *db_conn;
+	time_t created;
+	time_t idle_since;
+} db_conn_entry_t;
+
+/* idle slurmdbd connections available for reuse */
+static list_t *db_conns = NULL;
+
 static void _check_magic(rest_auth_context_t *ctx)
 {
 	xassert(ctx);
@@ -89,13 +115,139 @@ static void _check_magic(rest_auth_context_t *ctx)
 	if (!ctx->plugin_id) {
 		xassert(!ctx->plugin_data);
 		xassert(!ctx->user_name);
+		xassert(!ctx->identity);
+	}
+}
+
+static void _free_db_conn_entry(void *x)
+{
+	db_conn_entry_t *entry = x;
+
+	if (!entry)
+		return;
+
+	xassert(entry->magic == MAGIC_DB_CONN);
+
+	if (entry->db_conn)
+		slurmdb_connection_close(&entry->db_conn);
+
+	xfree(entry->key);
+	entry->magic = ~MAGIC_DB_CONN;
+	xfree(entry);
+}
+
+static int _find_db_conn_key(void *x, void *key)
+{
+	db_conn_entry_t *entry = x;
+
+	xassert(entry->magic == MAGIC_DB_CONN);
+
+	return !xstrcmp(entry->key, key);
+}
+
+static int _find_db_conn_expired(void *x, void *key)
+{
+	db_conn_entry_t *entry = x;
+	time_t *now = key;
+
+	xassert(entry->magic == MAGIC_DB_CONN);
+
+	return (((entry->idle_since + DB_CONN_POOL_IDLE) <= *now) ||
+		((entry->created + DB_CONN_POOL_MAX_AGE) <= *now));
+}
+
+/* Close any connections that have been idle for too long */
+static void _expire_db_conns(void)
+{
+	time_t now = time(NULL);
+	list_t *expired = list_create(_free_db_conn_entry);
+
+	(void) list_transfer_match(db_conns, expired, _find_db_conn_expired,
+				   &now);
+
+	/* close connections outside of the pool */
+	FREE_NULL_LIST(expired);
+}
+
+extern void *rest_auth_db_conn_get(const char *key, time_t *created_ptr)
+{
+	db_conn_entry_t *entry;
+	void *db_conn;
+
+	xassert(key);
+
+	if (db_conns) {
+		_expire_db_conns();
+
+		if ((entry = list_remove_first(db_conns, _find_db_conn_key,
+					       (void *) key))) {
+			xassert(entry->magic == MAGIC_DB_CONN);
+
+			db_conn = entry->db_conn;
+			*created_ptr = entry->created;
+			entry->db_conn = NULL;
+			_free_db_conn_entry(entry);
+
+			debug5("%s: reusing slurmdbd connection", __func__);
+			return db_conn;
+		}
+	}
+
+	errno = 0;
+	db_conn = slurmdb_connection_get(NULL);
+	*created_ptr = time(NULL);
+
+	if (!errno && db_conn)
+		return db_conn;
+
+	error("%s: unable to connect to slurmdbd: %m", __func__);
+
+	if (db_conn)
+		slurmdb_connection_close(&db_conn);
+
+	return NULL;
+}
+
+extern void rest_auth_db_conn_put(const char *key, void **db_conn_ptr,
+				  time_t created)
+{
+	db_conn_entry_t *entry;
+	time_t now = time(NULL);
+
+	xassert(key);
+
+	if (!*db_conn_ptr)
+		return;
+
+	/*
+	 * Roll back anything the request did not commit so the next request
+	 * starts clean. This also verifies the connection is still alive.
+	 */
+	if (!db_conns || (list_count(db_conns) >= DB_CONN_POOL_MAX) ||
+	    ((created + DB_CONN_POOL_MAX_AGE) <= now) ||
+	    slurmdb_connection_commit(*db_conn_ptr, false)) {
+		slurmdb_connection_close(db_conn_ptr);
+		return;
 	}
+
+	entry = xmalloc(sizeof(*entry));
+	entry->magic = MAGIC_DB_CONN;
+	entry->key = xstrdup(key);
+	entry->db_conn = *db_conn_ptr;
+	entry->created = created;
+	entry->idle_since = now;
+	*db_conn_ptr = NULL;
+
+	/* most recently used connections are checked first */
+	list_prepend(db_conns, entry);
 }
 
 extern void destroy_rest_auth(void)
 {
 	slurm_mutex_lock(&init_lock);
 
+	FREE_NULL_LIST(db_conns);
+
 	for (int i = 0; (g_context_cnt > 0) && (i < g_context_cnt); i++) {
 		(*(ops[i].fini))();
 
@@ -123,6 +275,8 @@ extern int init_rest_auth(bool become_user,
 	xassert(g_context_cnt == -1);
 	g_context_cnt = 0;
 
+	db_conns = list_create(_free_db_conn_entry);
+
 	xrecalloc(ops, (plugin_count + 1), sizeof(slurm_rest_auth_ops_t));
 	xrecalloc(plugin_ids, (plugin_count + 1), sizeof(plugin_ids));
 	xrecalloc(g_context, (plugin_count + 1), sizeof(plugin_context_t *));
@@ -276,6 +430,7 @@ extern void rest_auth_g_free(rest_auth_context_t *context)
 	}
 
 	xfree(context->user_name);
+	xfree(context->identity);
 	context->plugin_id = 0;
 	context->magic = ~MAGIC;
 	xfree(context);
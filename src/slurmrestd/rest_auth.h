@@ -52,6 +52,8 @@ typedef struct {
 	uint32_t plugin_id;
 	/* optional user supplied user name */
 	char *user_name;
+	/* unique string for authenticated identity (set by plugin) */
+	char *identity;
 	void *plugin_data;
 } rest_auth_context_t;
 
@@ -90,6 +92,25 @@ extern int rest_auth_g_apply(rest_auth_context_t *context);
  */
 extern void *rest_auth_g_get_db_conn(rest_auth_context_t *context);
 
+/*
+ * Get slurmdbd connection from pool of idle connections or open a new
+ * connection using the currently applied auth context.
+ * IN key - unique string for identity applied by auth context. Connections
+ * 	are only reused for the same identity.
+ * OUT created_ptr - time connection was opened
+ * RET NULL on error or db_conn pointer
+ */
+extern void *rest_auth_db_conn_get(const char *key, time_t *created_ptr);
+
+/*
+ * Return slurmdbd connection to pool of idle connections
+ * IN key - same key given to rest_auth_db_conn_get()
+ * IN/OUT db_conn_ptr - ptr to connection. Set to NULL on return.
+ * IN created - time connection was opened from rest_auth_db_conn_get()
+ */
+extern void rest_auth_db_conn_put(const char *key, void **db_conn_ptr,
+				  time_t created);
+
 #define FREE_NULL_REST_AUTH(_X)			\
 	do {					\
 		if (_X)				\
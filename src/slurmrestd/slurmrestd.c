@@ -186,6 +186,14 @@ static void _parse_env(void)
 	if ((buffer = getenv("SLURMRESTD_MAX_CONNECTIONS")))
 		_set_max_connections(buffer);
 
+	if ((buffer = getenv("SLURMRESTD_RESPONSE_CACHE_TTL"))) {
+		response_cache_ttl = slurm_atoul(buffer);
+
+		if (response_cache_ttl < 0)
+			fatal("Invalid env SLURMRESTD_RESPONSE_CACHE_TTL: %s",
+			      buffer);
+	}
+
 	if ((buffer = getenv("SLURMRESTD_OPENAPI_PLUGINS")) != NULL) {
 		xfree(oas_specs);
 		oas_specs = xstrdup(buffer);
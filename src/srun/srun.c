@@ -788,9 +788,24 @@ static void _file_bcast(slurm_opt_t *opt_local, srun_job_t *job)
 	params->block_size = 8 * 1024 * 1024;
 	if (srun_opt->compress) {
 		params->compress = srun_opt->compress;
+		params->compress_level = srun_opt->compress_level;
 	} else if ((tmp = conf_get_opt_str(slurm_conf.bcast_parameters,
 					   "Compression="))) {
 		params->compress = parse_compress_type(tmp);
+		params->compress_level = parse_compress_level(tmp);
+		xfree(tmp);
+	}
+	if ((tmp = conf_get_opt_str(slurm_conf.bcast_parameters,
+				    "CacheDir="))) {
+		params->flags |= BCAST_FLAG_CACHE;
+		xfree(tmp);
+	}
+	if ((tmp = conf_get_opt_str(slurm_conf.bcast_parameters, "Chains="))) {
+		params->chains = atoi(tmp);
+		xfree(tmp);
+	}
+	if ((tmp = conf_get_opt_str(slurm_conf.bcast_parameters, "Window="))) {
+		params->window = atoi(tmp);
 		xfree(tmp);
 	}
 	params->exclude = xstrdup(srun_opt->bcast_exclude);
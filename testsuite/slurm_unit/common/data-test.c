@@ -41,6 +41,7 @@
 #include "src/common/log.h"
 #include "src/common/read_config.h"
 #include "src/common/slurm_protocol_defs.h"
+#include "src/common/timers.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
@@ -329,6 +330,115 @@ START_TEST(test_dict_typeset)
 }
 END_TEST
 
+#define DICT_LARGE_COUNT 5000
+
+static data_for_each_cmd_t _del_dict_odd(const char *key, data_t *data,
+					 void *arg)
+{
+	return ((data_get_int(data) % 2) ? DATA_FOR_EACH_DELETE :
+					   DATA_FOR_EACH_CONT);
+}
+
+START_TEST(test_dict_large)
+{
+	char key[32];
+	data_t *d = data_set_dict(data_new());
+	data_t *r = data_set_dict(data_new());
+
+	/* cross the point where the dictionary gets indexed */
+	for (int i = 0; i < DICT_LARGE_COUNT; i++) {
+		snprintf(key, sizeof(key), "key%d", i);
+		data_set_int(data_key_set(d, key), i);
+		ck_assert(data_key_get(d, key) != NULL);
+	}
+	ck_assert_int_eq(data_get_dict_length(d), DICT_LARGE_COUNT);
+
+	/* same entries in reverse order must still match */
+	for (int i = DICT_LARGE_COUNT - 1; i >= 0; i--) {
+		snprintf(key, sizeof(key), "key%d", i);
+		data_set_int(data_key_set(r, key), i);
+	}
+	ck_assert(data_check_match(d, r, false));
+
+	for (int i = 0; i < DICT_LARGE_COUNT; i++) {
+		const data_t *v;
+
+		snprintf(key, sizeof(key), "key%d", i);
+		v = data_key_get_const(d, key);
+		ck_assert(v != NULL);
+		ck_assert_int_eq(data_get_int(v), i);
+	}
+	ck_assert(!data_key_get(d, "key-1"));
+	ck_assert(!data_key_get(d, "key"));
+
+	/* remove odd entries through iteration and a third by key */
+	data_dict_for_each(d, _del_dict_odd, NULL);
+	ck_assert_int_eq(data_get_dict_length(d), (DICT_LARGE_COUNT / 2));
+	for (int i = 0; i < DICT_LARGE_COUNT; i += 6) {
+		snprintf(key, sizeof(key), "key%d", i);
+		ck_assert(data_key_unset(d, key));
+		ck_assert(!data_key_unset(d, key));
+	}
+
+	for (int i = 0; i < DICT_LARGE_COUNT; i++) {
+		const data_t *v;
+
+		snprintf(key, sizeof(key), "key%d", i);
+		v = data_key_get_const(d, key);
+
+		if ((i % 2) || !(i % 6)) {
+			ck_assert(v == NULL);
+		} else {
+			ck_assert(v != NULL);
+			ck_assert_int_eq(data_get_int(v), i);
+		}
+	}
+
+	/* overwrite existing and re-add removed entries */
+	for (int i = 0; i < DICT_LARGE_COUNT; i++) {
+		snprintf(key, sizeof(key), "key%d", i);
+		data_set_int(data_key_set(d, key), i);
+	}
+	ck_assert_int_eq(data_get_dict_length(d), DICT_LARGE_COUNT);
+	ck_assert(data_check_match(d, r, false));
+
+	FREE_NULL_DATA(d);
+	FREE_NULL_DATA(r);
+}
+END_TEST
+
+START_TEST(test_dict_bandwidth)
+{
+	DEF_TIMERS;
+	char key[32];
+	int64_t sum = 0;
+	data_t *d = data_set_dict(data_new());
+
+	START_TIMER;
+	for (int i = 0; i < DICT_LARGE_COUNT; i++) {
+		snprintf(key, sizeof(key), "key%d", i);
+		data_set_int(data_key_set(d, key), i);
+	}
+	END_TIMER3(__func__, INFINITE);
+	printf("\tset %d keys: %s\n", DICT_LARGE_COUNT, TIME_STR);
+
+	START_TIMER;
+	for (int i = 0; i < DICT_LARGE_COUNT; i++) {
+		snprintf(key, sizeof(key), "key%d", i);
+		sum += data_get_int(data_key_get(d, key));
+	}
+	END_TIMER3(__func__, INFINITE);
+	printf("\tget %d keys: %s\n", DICT_LARGE_COUNT, TIME_STR);
+	ck_assert(sum == ((int64_t) DICT_LARGE_COUNT *
+			  (DICT_LARGE_COUNT - 1) / 2));
+
+	START_TIMER;
+	FREE_NULL_DATA(d);
+	END_TIMER3(__func__, INFINITE);
+	printf("\tfree %d keys: %s\n", DICT_LARGE_COUNT, TIME_STR);
+}
+END_TEST
+
 START_TEST(test_detection)
 {
 	data_t *d = data_new();
@@ -356,6 +466,8 @@ Suite *suite_data(void)
 	tcase_add_test(tc_core, test_dict_typeset);
 	tcase_add_test(tc_core, test_dict_iteration);
 	tcase_add_test(tc_core, test_list_iteration);
+	tcase_add_test(tc_core, test_dict_large);
+	tcase_add_test(tc_core, test_dict_bandwidth);
 
 	suite_add_tcase(s, tc_core);
 	return s;
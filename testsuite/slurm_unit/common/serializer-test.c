@@ -53,6 +53,7 @@
 #include "src/common/data.h"
 #include "src/common/log.h"
 #include "src/common/macros.h"
+#include "src/common/pack.h"
 #include "src/common/read_config.h"
 #include "src/common/slurm_protocol_defs.h"
 #include "src/common/timers.h"
@@ -476,6 +477,224 @@ START_TEST(test_mimetype)
 }
 END_TEST
 
+START_TEST(test_json_dump)
+{
+	int rc;
+	char *output = NULL;
+	size_t output_len = 0;
+	data_t *l, *d = data_set_dict(data_new());
+	const char expected[] =
+		"{\"path\":\"\\/tmp\\/a\\\"b\\n\\u0001\","
+		"\"list\":[1,-2.5,true,null,[],{}]}";
+
+	/* dict entries are dumped in insertion order */
+	data_set_string(data_key_set(d, "path"), "/tmp/a\"b\n\x01");
+	l = data_set_list(data_key_set(d, "list"));
+	data_set_int(data_list_append(l), 1);
+	data_set_float(data_list_append(l), -2.5);
+	data_set_bool(data_list_append(l), true);
+	data_set_null(data_list_append(l));
+	data_set_list(data_list_append(l));
+	data_set_dict(data_list_append(l));
+
+	rc = serialize_g_data_to_string(&output, &output_len, d,
+					MIME_TYPE_JSON, SER_FLAGS_COMPACT);
+	assert_int_eq(rc, 0);
+	assert_msg(!xstrcmp(output, expected), "unexpected JSON: %s", output);
+	assert_int_eq(output_len, sizeof(expected));
+
+	xfree(output);
+	FREE_NULL_DATA(d);
+}
+END_TEST
+
+/*
+ * Dump a list of count dicts of about 1KiB each and return how many times the
+ * output buffer was grown, which is known from its final size as it is
+ * doubled each time.
+ */
+static int _test_dump_grow_count(int count)
+{
+	int rc, grows = 0;
+	char *output = NULL, name[1024];
+	size_t output_len = 0, size;
+	data_t *l = data_set_list(data_new());
+
+	memset(name, 'x', (sizeof(name) - 1));
+	name[sizeof(name) - 1] = '\0';
+
+	for (int i = 0; i < count; i++) {
+		data_t *d = data_set_dict(data_list_append(l));
+
+		data_set_int(data_key_set(d, "job_id"), i);
+		data_set_string(data_key_set(d, "name"), name);
+	}
+
+	rc = serialize_g_data_to_string(&output, &output_len, l,
+					MIME_TYPE_JSON, SER_FLAGS_COMPACT);
+	assert_int_eq(rc, 0);
+
+	for (size = xsize(output); size > BUF_SIZE; size /= 2) {
+		assert_msg(!(size % 2), "buffer size %zu not a doubling of %d",
+			   xsize(output), BUF_SIZE);
+		grows++;
+	}
+	assert_int_eq(size, BUF_SIZE);
+	/* never more than twice what is needed */
+	assert_msg(xsize(output) < (2 * output_len) + BUF_SIZE,
+		   "buffer size %zu for %zu bytes", xsize(output), output_len);
+
+	xfree(output);
+	FREE_NULL_DATA(l);
+
+	return grows;
+}
+
+START_TEST(test_json_dump_large)
+{
+	int small = _test_dump_grow_count(512);
+	int large = _test_dump_grow_count(8192);
+
+	/* 16 times the output takes 4 more reallocations */
+	assert_msg(large <= (small + 5), "%d then %d reallocations",
+		   small, large);
+	assert_msg(small <= 8, "%d reallocations", small);
+}
+END_TEST
+
+static void _test_parse_match(const char *src, const data_t *expected)
+{
+	data_t *d = NULL;
+	int rc;
+
+	rc = serialize_g_string_to_data(&d, src, strlen(src), MIME_TYPE_JSON);
+	assert_int_eq(rc, 0);
+	assert_msg(data_check_match(expected, d, false),
+		   "verify failed: %s -> %pD", src, d);
+
+	FREE_NULL_DATA(d);
+}
+
+static void _test_parse_fail(const char *src)
+{
+	data_t *d = NULL;
+	int rc;
+
+	rc = serialize_g_string_to_data(&d, src, strlen(src), MIME_TYPE_JSON);
+	assert_msg(rc, "expected parse failure: %s", src);
+	assert_ptr_null(d, ==);
+}
+
+START_TEST(test_parse_strings)
+{
+	static const char *sf[] = {
+		"\"taco",
+		"\"taco\\\"",
+		"\"taco\\",
+		"\"\\\"\\\"\\\"",
+		"'taco\"",
+		"\"\\x\"",
+		"\"\\u12\"",
+		"\"\\uTACO\"",
+		"{\"taco:1}",
+		"{\"taco\\\":1}",
+	};
+	data_t *d = data_new();
+	char *src = NULL, *expected = NULL;
+
+	for (int i = 0; i < ARRAY_SIZE(sf); i++)
+		_test_parse_fail(sf[i]);
+
+	data_set_string(d, "a\"b\\c/d\b\f\n\r\t'e");
+	_test_parse_match("\"a\\\"b\\\\c\\/d\\b\\f\\n\\r\\t\\'e\"", d);
+
+	data_set_string(d, "it's");
+	_test_parse_match("'it\\'s'", d);
+
+	/* surrogate pair is combined into a single code point */
+	data_set_string(d, "\U0001F600 \U000000e9");
+	_test_parse_match("\"\\ud83d\\ude00 \\u00e9\"", d);
+
+	/* escaped quotes must not end a long string early */
+	xstrcatchar(src, '"');
+	for (int i = 0; i < 4096; i++) {
+		xstrcat(src, "\\\"x");
+		xstrcat(expected, "\"x");
+	}
+	xstrcatchar(src, '"');
+	data_set_string(d, expected);
+	_test_parse_match(src, d);
+
+	/* drop the closing quote */
+	src[strlen(src) - 1] = '\0';
+	_test_parse_fail(src);
+
+	/* escaped keys */
+	data_set_dict(d);
+	data_set_int(data_key_set(d, "key\"1"), 1);
+	data_set_int(data_key_set(d, "key"), 2);
+	_test_parse_match("{\"key\\\"1\":1,\"k\\u0065y\":2}", d);
+
+	xfree(src);
+	xfree(expected);
+	FREE_NULL_DATA(d);
+}
+END_TEST
+
+START_TEST(test_parse_numbers)
+{
+	static const char *sf[] = {
+		"-",
+		"--1",
+		"+1",
+		"1.2.3",
+		"1e",
+		"1e+",
+		"0123456789012345678901234567890123456789012345678901234567890123456789",
+	};
+	static const struct {
+		const char *src;
+		int64_t value;
+	} ints[] = {
+		{ "0", 0 },
+		{ "-12", -12 },
+		{ "9223372036854775807", INT64_MAX },
+		{ "-9223372036854775808", INT64_MIN },
+	};
+	static const struct {
+		const char *src;
+		double value;
+	} floats[] = {
+		{ "-0.25", -0.25 },
+		{ "1.5e3", 1500.0 },
+		{ "2E-2", 0.02 },
+		{ "9223372036854775808", 9223372036854775808.0 },
+	};
+	data_t *d = data_new();
+
+	for (int i = 0; i < ARRAY_SIZE(sf); i++)
+		_test_parse_fail(sf[i]);
+
+	for (int i = 0; i < ARRAY_SIZE(ints); i++) {
+		data_set_int(d, ints[i].value);
+		_test_parse_match(ints[i].src, d);
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(floats); i++) {
+		data_set_float(d, floats[i].value);
+		_test_parse_match(floats[i].src, d);
+	}
+
+	/* numbers end at the first character which can't be part of them */
+	data_set_list(d);
+	data_set_int(data_list_append(d), 1);
+	data_set_float(data_list_append(d), -2.5);
+	_test_parse_match("[1,-2.5]", d);
+
+	FREE_NULL_DATA(d);
+}
+END_TEST
+
 #ifdef HAVE_MALLINFO2
 static void _track_mem(mem_track_t *track)
 {
@@ -703,7 +922,11 @@ extern Suite *suite_data(void)
 	tcase_set_timeout(tc_core, 3000);
 
 	tcase_add_test(tc_core, test_mimetype);
+	tcase_add_test(tc_core, test_json_dump);
+	tcase_add_test(tc_core, test_json_dump_large);
 	tcase_add_test(tc_core, test_parse);
+	tcase_add_test(tc_core, test_parse_strings);
+	tcase_add_test(tc_core, test_parse_numbers);
 	tcase_add_test(tc_core, test_compliance);
 	tcase_add_test(tc_core, test_bandwidth);
 
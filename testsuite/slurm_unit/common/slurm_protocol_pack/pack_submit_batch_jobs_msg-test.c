@@ -0,0 +1,162 @@
+#include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "src/common/list.h"
+#include "src/common/slurm_protocol_pack.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+#include "src/common/slurm_protocol_common.h"
+
+static list_t *_create_resp_list(int count)
+{
+	list_t *resp_list = list_create(
+		(ListDelF) slurm_free_submit_response_response_msg);
+
+	for (int i = 0; i < count; i++) {
+		submit_response_msg_t *resp = xmalloc(sizeof(*resp));
+
+		resp->job_id = 1000 + i;
+		resp->step_id = SLURM_BATCH_SCRIPT;
+		resp->error_code = (i % 2) ? ESLURM_INVALID_PARTITION_NAME : 0;
+		if (i % 3)
+			resp->job_submit_user_msg = xstrdup_printf("msg%d", i);
+		list_append(resp_list, resp);
+	}
+
+	return resp_list;
+}
+
+START_TEST(pack_resp)
+{
+	int rc;
+	buf_t *buf = init_buf(1024);
+	list_t *pack_list = _create_resp_list(5);
+	list_itr_t *pack_iter, *unpack_iter;
+	submit_response_msg_t *pack_resp, *unpack_resp;
+
+	slurm_msg_t msg = {{0}};
+	msg.msg_type         = RESPONSE_SUBMIT_BATCH_JOBS;
+	msg.protocol_version = SLURM_PROTOCOL_VERSION;
+	msg.data             = pack_list;
+
+	rc = pack_msg(&msg, buf);
+	ck_assert_int_eq(rc, SLURM_SUCCESS);
+
+	set_buf_offset(buf, 0);
+
+	msg.data = NULL;
+	rc = unpack_msg(&msg, buf);
+	ck_assert_int_eq(rc, SLURM_SUCCESS);
+	ck_assert(msg.data != NULL);
+	ck_assert_int_eq(list_count(msg.data), list_count(pack_list));
+
+	pack_iter = list_iterator_create(pack_list);
+	unpack_iter = list_iterator_create(msg.data);
+	while ((pack_resp = list_next(pack_iter))) {
+		unpack_resp = list_next(unpack_iter);
+		ck_assert(unpack_resp != NULL);
+		ck_assert_int_eq(unpack_resp->job_id, pack_resp->job_id);
+		ck_assert_int_eq(unpack_resp->step_id, pack_resp->step_id);
+		ck_assert_int_eq(unpack_resp->error_code,
+				 pack_resp->error_code);
+		ck_assert(!xstrcmp(unpack_resp->job_submit_user_msg,
+				   pack_resp->job_submit_user_msg));
+	}
+	list_iterator_destroy(pack_iter);
+	list_iterator_destroy(unpack_iter);
+
+	free_buf(buf);
+	FREE_NULL_LIST(pack_list);
+	slurm_free_msg_data(msg.msg_type, msg.data);
+}
+END_TEST
+
+START_TEST(pack_empty_resp)
+{
+	int rc;
+	buf_t *buf = init_buf(1024);
+	list_t *pack_list = _create_resp_list(0);
+
+	slurm_msg_t msg = {{0}};
+	msg.msg_type         = RESPONSE_SUBMIT_BATCH_JOBS;
+	msg.protocol_version = SLURM_PROTOCOL_VERSION;
+	msg.data             = pack_list;
+
+	rc = pack_msg(&msg, buf);
+	ck_assert_int_eq(rc, SLURM_SUCCESS);
+
+	set_buf_offset(buf, 0);
+
+	msg.data = NULL;
+	rc = unpack_msg(&msg, buf);
+	ck_assert_int_eq(rc, SLURM_SUCCESS);
+	ck_assert(msg.data != NULL);
+	ck_assert_int_eq(list_count(msg.data), 0);
+
+	free_buf(buf);
+	FREE_NULL_LIST(pack_list);
+	slurm_free_msg_data(msg.msg_type, msg.data);
+}
+END_TEST
+
+START_TEST(unpack_truncated_resp)
+{
+	int rc;
+	buf_t *buf = init_buf(1024);
+	list_t *pack_list = _create_resp_list(3);
+
+	slurm_msg_t msg = {{0}};
+	msg.msg_type         = RESPONSE_SUBMIT_BATCH_JOBS;
+	msg.protocol_version = SLURM_PROTOCOL_VERSION;
+	msg.data             = pack_list;
+
+	rc = pack_msg(&msg, buf);
+	ck_assert_int_eq(rc, SLURM_SUCCESS);
+
+	buf->size = get_buf_offset(buf) - 1;
+	set_buf_offset(buf, 0);
+
+	msg.data = NULL;
+	rc = unpack_msg(&msg, buf);
+	ck_assert_int_eq(rc, SLURM_ERROR);
+	ck_assert(msg.data == NULL);
+
+	free_buf(buf);
+	FREE_NULL_LIST(pack_list);
+}
+END_TEST
+
+/*****************************************************************************
+ * TEST SUITE                                                                *
+ ****************************************************************************/
+
+Suite *suite(SRunner *sr)
+{
+	Suite *s = suite_create("Pack submit batch jobs messages");
+	TCase *tc_core = tcase_create("Pack RESPONSE_SUBMIT_BATCH_JOBS");
+	tcase_add_test(tc_core, pack_resp);
+	tcase_add_test(tc_core, pack_empty_resp);
+	tcase_add_test(tc_core, unpack_truncated_resp);
+	suite_add_tcase(s, tc_core);
+	return s;
+}
+
+/*****************************************************************************
+ * TEST RUNNER                                                               *
+ ****************************************************************************/
+
+int main(void)
+{
+	int number_failed;
+	SRunner *sr = srunner_create(NULL);
+	//srunner_set_fork_status(sr, CK_NOFORK);
+	srunner_add_suite(sr, suite(sr));
+
+	srunner_run_all(sr, CK_VERBOSE);
+	//srunner_run_all(sr, CK_NORMAL);
+	number_failed = srunner_ntests_failed(sr);
+	srunner_free(sr);
+
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
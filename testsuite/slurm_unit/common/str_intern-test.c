@@ -0,0 +1,139 @@
+/*****************************************************************************\
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include <check.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/common/log.h"
+#include "src/common/str_intern.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+
+START_TEST(test_null)
+{
+	ck_assert(str_intern(NULL) == NULL);
+	ck_assert(str_intern_ref(NULL) == NULL);
+	str_intern_release(NULL);
+}
+END_TEST
+
+START_TEST(test_shared)
+{
+	char *src = xstrdup("/home/user/work");
+	char *a = str_intern(src);
+	char *b = str_intern("/home/user/work");
+	char *c = str_intern("/home/user/other");
+
+	ck_assert(a != src);
+	ck_assert(a == b);
+	ck_assert(a != c);
+	ck_assert_str_eq(a, "/home/user/work");
+	ck_assert_str_eq(c, "/home/user/other");
+
+	/* Interned copy must survive the original */
+	xfree(src);
+	ck_assert_str_eq(a, "/home/user/work");
+
+	ck_assert(str_intern_ref(a) == a);
+
+	FREE_NULL_INTERNED(a);
+	ck_assert(a == NULL);
+	FREE_NULL_INTERNED(b);
+	ck_assert_str_eq(c, "/home/user/other");
+
+	/* b still references the string through str_intern_ref() */
+	b = str_intern("/home/user/work");
+	ck_assert_str_eq(b, "/home/user/work");
+	str_intern_release(b);
+	str_intern_release(b);
+	FREE_NULL_INTERNED(c);
+}
+END_TEST
+
+START_TEST(test_empty)
+{
+	char *a = str_intern("");
+	char *b = str_intern("");
+
+	ck_assert(a == b);
+	ck_assert_str_eq(a, "");
+	FREE_NULL_INTERNED(a);
+	FREE_NULL_INTERNED(b);
+}
+END_TEST
+
+START_TEST(test_many)
+{
+	char *strs[1000];
+
+	for (int i = 0; i < 1000; i++) {
+		char *tmp = xstrdup_printf("/scratch/out.%d", (i % 10));
+		strs[i] = str_intern(tmp);
+		xfree(tmp);
+	}
+
+	for (int i = 10; i < 1000; i++)
+		ck_assert(strs[i] == strs[i % 10]);
+
+	for (int i = 0; i < 1000; i++)
+		FREE_NULL_INTERNED(strs[i]);
+}
+END_TEST
+
+Suite *suite_str_intern(void)
+{
+	Suite *s = suite_create("str_intern");
+	TCase *tc_core = tcase_create("str_intern");
+	tcase_add_test(tc_core, test_null);
+	tcase_add_test(tc_core, test_shared);
+	tcase_add_test(tc_core, test_empty);
+	tcase_add_test(tc_core, test_many);
+	suite_add_tcase(s, tc_core);
+	return s;
+}
+
+int main(void)
+{
+	log_options_t log_opts = LOG_OPTS_INITIALIZER;
+	log_opts.stderr_level = LOG_LEVEL_DEBUG5;
+	log_init("str_intern-test", log_opts, 0, NULL);
+
+	int number_failed;
+	SRunner *sr = srunner_create(suite_str_intern());
+	srunner_run_all(sr, CK_ENV);
+	number_failed = srunner_ntests_failed(sr);
+	srunner_free(sr);
+
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}